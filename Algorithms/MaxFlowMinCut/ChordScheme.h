@@ -1,10 +1,16 @@
 #pragma once
 
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <optional>
+#include <type_traits>
 #include <vector>
 
 #include "PushRelabel.h"
 
 #include "../../DataStructures/Graph/Graph.h"
+#include "../../DataStructures/MaxFlowMinCut/BreakpointIndex.h"
 #include "../../DataStructures/MaxFlowMinCut/FlowUtils.h"
 #include "../../DataStructures/MaxFlowMinCut/MaxFlowInstance.h"
 
@@ -12,9 +18,14 @@
 #include "../../Helpers/Meta.h"
 #include "../../Helpers/Types.h"
 #include "../../Helpers/Vector/Vector.h"
+#include "../../Helpers/WorkStealingPool.h"
 
-template<Meta::Derived<pmf::flowFunction> FLOW_FUNCTION, typename SEARCH_ALGORITHM, bool MEASUREMENTS = false>
+template<pmf::flowFunction FLOW_FUNCTION, typename SEARCH_ALGORITHM, bool MEASUREMENTS = false>
 class ChordScheme {
+private:
+    // Subproblems below this size are solved by the thread that created them.
+    inline static constexpr size_t ParallelRecursionThreshold = 1024;
+
 public:
     using FlowFunction = FLOW_FUNCTION;
     using FlowType = FlowFunction::FlowType;
@@ -42,58 +53,66 @@ public:
         }
     };
 
-    ChordScheme(const ParametricInstance& instance, const double epsilon) : instance(instance), epsilon(epsilon), breakpointOfVertex(instance.graph.numVertices(), INFTY) {}
+    using SolutionPtr = std::shared_ptr<const Solution>;
+    using WrapperPtr = std::shared_ptr<ParametricWrapper>;
+    using ConstWrapperPtr = std::shared_ptr<const ParametricWrapper>;
+
+    // numSearchThreads is passed to search algorithms that take a thread count, such as ParallelPushRelabel or
+    // PushRelabel with a parallel BFS. Every other search algorithm runs sequentially.
+    ChordScheme(const ParametricInstance& instance, const double epsilon, const size_t numThreads = 1, ThreadScheduler* scheduler = nullptr, const size_t numSearchThreads = 1) :
+        instance(instance),
+        epsilon(epsilon),
+        numThreads(numThreads),
+        numSearchThreads(numSearchThreads),
+        scheduler(scheduler),
+        breakpointOfVertex(instance.graph.numVertices(), INFTY) {
+    }
 
     inline void run() noexcept {
-        ParametricWrapper wrapper(instance);
-        const Solution solMin = runSearch(wrapper, instance.alphaMin);
-        const Solution solMax = runSearch(wrapper, instance.alphaMax);
+        WorkStealingPool pool(numThreads, scheduler);
+        searches.resize(pool.numThreads());
+        const WrapperPtr wrapper = std::make_shared<ParametricWrapper>(instance);
+        const SolutionPtr solMin = std::make_shared<const Solution>(runSearch(pool, *wrapper, instance.alphaMin));
+        const SolutionPtr solMax = std::make_shared<const Solution>(runSearch(pool, *wrapper, instance.alphaMax));
         for (const Vertex vertex : instance.graph.vertices()) {
-            if (!solMin.inSinkComponent[vertex]) {
+            if (!solMin->inSinkComponent[vertex]) {
                 breakpointOfVertex[vertex] = instance.alphaMin;
             }
         }
-        breakpoints.emplace_back(instance.alphaMin);
-        timer.restart();
-        ParametricWrapper contractedWrapper = wrapper.contractSourceAndSinkComponents(solMin.inSinkComponent, solMax.inSinkComponent);
+        Timer timer;
+        const WrapperPtr contractedWrapper = std::make_shared<ParametricWrapper>(wrapper->contractSourceAndSinkComponents(solMin->inSinkComponent, solMax->inSinkComponent));
         if constexpr (MEASUREMENTS) contractionTime += timer.elapsedMicroseconds();
-        recurse(instance.alphaMin, instance.alphaMax, solMin, solMax, contractedWrapper, wrapper);
-        if (instance.alphaMax < INFTY) addSolution(instance.alphaMax, solMax, wrapper);
+        pool.spawn([&]() {
+            recurse(pool, instance.alphaMin, instance.alphaMax, solMin, solMax, contractedWrapper, wrapper);
+        });
+        pool.wait();
+        searches.clear();
+        if (instance.alphaMax < INFTY) addSolution(instance.alphaMax, *solMax, *wrapper);
+        // A solution is a breakpoint iff it is the first one to move some vertex to the source side. Since the
+        // recursion no longer visits the solutions in order, the index reads them off breakpointOfVertex.
+        breakpointIndex.build(instance, breakpointOfVertex);
         if constexpr (MEASUREMENTS) {
-            std::cout << "Contraction time: " << String::musToString(contractionTime) << std::endl;
-            std::cout << "Flow time: " << String::musToString(flowTime) << std::endl;
+            std::cout << "Contraction time: " << String::musToString(contractionTime.load()) << std::endl;
+            std::cout << "Flow time: " << String::musToString(flowTime.load()) << std::endl;
             std::cout << "#Vertices (total): " << totalVertices << std::endl;
         }
     }
 
     inline const std::vector<double>& getBreakpoints() const noexcept {
-        return breakpoints;
+        return breakpointIndex.getBreakpoints();
     }
 
     inline const std::vector<double>& getVertexBreakpoints() const noexcept {
         return breakpointOfVertex;
     }
 
-    inline std::vector<Vertex> getSinkComponent(const double alpha) const noexcept {
-        std::vector<Vertex> sinkComponent;
-        for (const Vertex vertex : instance.graph.vertices()) {
-            if (breakpointOfVertex[vertex] <= alpha) continue;
-            sinkComponent.emplace_back(vertex);
-        }
-        return sinkComponent;
+    // The vertices are ordered by breakpoint, not by id.
+    inline std::span<const Vertex> getSinkComponent(const double alpha) const noexcept {
+        return breakpointIndex.getSinkComponent(alpha);
     }
 
     inline double getFlowValue(const double alpha) const noexcept {
-        double flow = 0;
-        for (const Vertex from : instance.graph.vertices()) {
-            if (breakpointOfVertex[from] > alpha) continue;
-            for (const Edge edge : instance.graph.edgesFrom(from)) {
-                const Vertex to = instance.graph.get(ToVertex, edge);
-                if (breakpointOfVertex[to] <= alpha) continue;
-                flow += instance.getCapacity(edge, alpha);
-            }
-        }
-        return flow;
+        return breakpointIndex.getFlowValue(alpha);
     }
 
     inline double getContractionTime() const noexcept {
@@ -112,65 +131,82 @@ public:
     }
 
 private:
-    inline Solution runSearch(ParametricWrapper& wrapper, const double alpha) noexcept {
-        if constexpr (MEASUREMENTS) timer.restart();
+    // Every thread keeps one search algorithm, which is re-targeted to each subproblem instead of being rebuilt.
+    inline Solution runSearch(const WorkStealingPool& pool, ParametricWrapper& wrapper, const double alpha) noexcept {
+        Timer timer;
         if constexpr (MEASUREMENTS) totalVertices += wrapper.graph.numVertices();
         wrapper.setAlpha(alpha);
-        SearchAlgorithm search(wrapper);
-        search.run();
-        Solution result(wrapper, search, alpha);
+        std::optional<SearchAlgorithm>& search = searches[pool.threadId()];
+        if (search) {
+            search->reset(wrapper);
+        } else if constexpr (std::is_constructible_v<SearchAlgorithm, const ParametricWrapper&, size_t>) {
+            search.emplace(wrapper, numSearchThreads);
+        } else {
+            search.emplace(wrapper);
+        }
+        search->run();
+        Solution result(wrapper, *search, alpha);
         if constexpr (MEASUREMENTS) flowTime += timer.elapsedMicroseconds();
         return result;
     }
 
-    inline void recurse(const double left, const double right, const Solution& solLeft, const Solution& solRight, ParametricWrapper& wrapper, const ParametricWrapper& evalWrapper) noexcept {
+    // The two halves of the interval are independent contracted subproblems. The left one is handed to the pool,
+    // the right one is continued by the current thread.
+    inline void recurse(WorkStealingPool& pool, const double left, const double right, const SolutionPtr& solLeft, const SolutionPtr& solRight, const WrapperPtr& wrapper, const ConstWrapperPtr& evalWrapper) noexcept {
         if (right <= left) {
-            addSolution(left, solRight, evalWrapper);
+            addSolution(left, *solRight, *evalWrapper);
             return;
         }
-        const double mid = findIntersectionPoint(solLeft.flowFunction, solRight.flowFunction);
+        const double mid = findIntersectionPoint(solLeft->flowFunction, solRight->flowFunction);
         if (mid <= left || mid >= right) {
-            addSolution(left, solRight, evalWrapper);
+            addSolution(left, *solRight, *evalWrapper);
             return;
         }
 
-        const Solution solMid = runSearch(wrapper, mid);
-        const double oldVal = solLeft.flowFunction.eval(mid);
-        const double newVal = solMid.flowFunction.eval(mid);
+        const SolutionPtr solMid = std::make_shared<const Solution>(runSearch(pool, *wrapper, mid));
+        const double oldVal = solLeft->flowFunction.eval(mid);
+        const double newVal = solMid->flowFunction.eval(mid);
         if (oldVal <= (1 + epsilon) * newVal) {
-            addSolution(mid, solRight, evalWrapper);
+            addSolution(mid, *solRight, *evalWrapper);
             return;
         }
 
-        if constexpr (MEASUREMENTS) timer.restart();
-        ParametricWrapper wrapperLeft = wrapper.contractSinkComponent(solMid.inSinkComponent);
-        ParametricWrapper wrapperRight = wrapper.contractSourceComponent(solMid.inSinkComponent);
+        Timer timer;
+        const WrapperPtr wrapperLeft = std::make_shared<ParametricWrapper>(wrapper->contractSinkComponent(solMid->inSinkComponent));
+        const WrapperPtr wrapperRight = std::make_shared<ParametricWrapper>(wrapper->contractSourceComponent(solMid->inSinkComponent));
         if constexpr (MEASUREMENTS) contractionTime += timer.elapsedMicroseconds();
-        recurse(left, mid, solLeft, solMid, wrapperLeft, wrapper);
-        recurse(mid, right, solMid, solRight, wrapperRight, evalWrapper);
+        if (wrapperLeft->graph.numVertices() >= ParallelRecursionThreshold) {
+            pool.spawn([this, &pool, left, mid, solLeft, solMid, wrapperLeft, wrapper]() {
+                recurse(pool, left, mid, solLeft, solMid, wrapperLeft, wrapper);
+            });
+        } else {
+            recurse(pool, left, mid, solLeft, solMid, wrapperLeft, wrapper);
+        }
+        recurse(pool, mid, right, solMid, solRight, wrapperRight, evalWrapper);
     }
 
+    // Called concurrently by several tasks, which may share vertices of a common evaluation wrapper.
+    // Taking the minimum is order independent, so every vertex ends up with the same breakpoint as in a sequential run.
     inline void addSolution(const double breakpoint, const Solution& solution, const ParametricWrapper& wrapper) noexcept {
-        bool addSolution = false;
         for (const Vertex vertex : wrapper.graph.vertices()) {
             if (solution.inSinkComponent[vertex] || vertex == wrapper.source) continue;
-            const Vertex realVertex = wrapper.newToOldVertex[vertex];
-            if (breakpoint < breakpointOfVertex[realVertex]) {
-                breakpointOfVertex[realVertex] = breakpoint;
-                addSolution = true;
-            }
+            std::atomic_ref<double> vertexBreakpoint(breakpointOfVertex[wrapper.newToOldVertex[vertex]]);
+            double current = vertexBreakpoint.load(std::memory_order_relaxed);
+            while (breakpoint < current && !vertexBreakpoint.compare_exchange_weak(current, breakpoint, std::memory_order_relaxed));
         }
-        if (addSolution) breakpoints.emplace_back(breakpoint);
     }
 
 private:
     const ParametricInstance& instance;
     const double epsilon;
-    std::vector<double> breakpoints;
+    const size_t numThreads;
+    const size_t numSearchThreads;
+    ThreadScheduler* scheduler;
+    BreakpointIndex<FlowFunction> breakpointIndex;
     std::vector<double> breakpointOfVertex;
+    std::vector<std::optional<SearchAlgorithm>> searches;
 
-    double contractionTime = 0;
-    double flowTime = 0;
-    long long totalVertices = 0;
-    Timer timer;
+    std::atomic<double> contractionTime{0};
+    std::atomic<double> flowTime{0};
+    std::atomic<long long> totalVertices{0};
 };
\ No newline at end of file
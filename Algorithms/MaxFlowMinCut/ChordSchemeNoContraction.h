@@ -1,10 +1,12 @@
 #pragma once
 
+#include <optional>
 #include <vector>
 
 #include "PushRelabel.h"
 
 #include "../../DataStructures/Graph/Graph.h"
+#include "../../DataStructures/MaxFlowMinCut/BreakpointIndex.h"
 #include "../../DataStructures/MaxFlowMinCut/FlowUtils.h"
 #include "../../DataStructures/MaxFlowMinCut/MaxFlowInstance.h"
 
@@ -13,7 +15,7 @@
 #include "../../Helpers/Types.h"
 #include "../../Helpers/Vector/Vector.h"
 
-template<Meta::Derived<pmf::flowFunction> FLOW_FUNCTION, typename SEARCH_ALGORITHM>
+template<pmf::flowFunction FLOW_FUNCTION, typename SEARCH_ALGORITHM>
 class ChordSchemeNoContraction {
 public:
     using FlowFunction = FLOW_FUNCTION;
@@ -55,6 +57,7 @@ public:
         breakpoints.emplace_back(instance.alphaMin);
         recurse(instance.alphaMin, instance.alphaMax, solMin, solMax);
         if (instance.alphaMax < INFTY) addSolution(instance.alphaMax, solMax);
+        breakpointIndex.build(instance, breakpointOfVertex);
     }
 
     inline const std::vector<double>& getBreakpoints() const noexcept {
@@ -65,34 +68,25 @@ public:
         return breakpointOfVertex;
     }
 
-    inline std::vector<Vertex> getSinkComponent(const double alpha) const noexcept {
-        std::vector<Vertex> sinkComponent;
-        for (const Vertex vertex : instance.graph.vertices()) {
-            if (breakpointOfVertex[vertex] <= alpha) continue;
-            sinkComponent.emplace_back(vertex);
-        }
-        return sinkComponent;
+    // The vertices are ordered by breakpoint, not by id.
+    inline std::span<const Vertex> getSinkComponent(const double alpha) const noexcept {
+        return breakpointIndex.getSinkComponent(alpha);
     }
 
     inline double getFlowValue(const double alpha) const noexcept {
-        double flow = 0;
-        for (const Vertex from : instance.graph.vertices()) {
-            if (breakpointOfVertex[from] > alpha) continue;
-            for (const Edge edge : instance.graph.edgesFrom(from)) {
-                const Vertex to = instance.graph.get(ToVertex, edge);
-                if (breakpointOfVertex[to] <= alpha) continue;
-                flow += instance.getCapacity(edge, alpha);
-            }
-        }
-        return flow;
+        return breakpointIndex.getFlowValue(alpha);
     }
 
 private:
     inline Solution runSearch(const double alpha) noexcept {
         wrapper.setAlpha(alpha);
-        SearchAlgorithm search(wrapper);
-        search.run();
-        Solution result(wrapper, search, alpha);
+        if (search) {
+            search->reset(wrapper);
+        } else {
+            search.emplace(wrapper);
+        }
+        search->run();
+        Solution result(wrapper, *search, alpha);
         return result;
     }
 
@@ -136,5 +130,7 @@ private:
     ParametricWrapper wrapper;
     const double epsilon;
     std::vector<double> breakpoints;
+    BreakpointIndex<FlowFunction> breakpointIndex;
     std::vector<double> breakpointOfVertex;
+    std::optional<SearchAlgorithm> search;
 };
\ No newline at end of file
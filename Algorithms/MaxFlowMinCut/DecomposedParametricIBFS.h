@@ -0,0 +1,228 @@
+#pragma once
+
+#include <algorithm>
+#include <span>
+#include <vector>
+
+#include "IBFS.h"
+#include "ParametricIBFS.h"
+#include "../StronglyConnectedComponents.h"
+
+#include "../../DataStructures/Graph/Graph.h"
+#include "../../DataStructures/MaxFlowMinCut/BreakpointIndex.h"
+#include "../../DataStructures/MaxFlowMinCut/FlowGraphBuilder.h"
+#include "../../DataStructures/MaxFlowMinCut/FlowUtils.h"
+#include "../../DataStructures/MaxFlowMinCut/MaxFlowInstance.h"
+
+#include "../../Helpers/Assert.h"
+#include "../../Helpers/Timer.h"
+#include "../../Helpers/Types.h"
+#include "../../Helpers/WorkStealingPool.h"
+
+/**
+ * Splits a parametric instance into parts that are solved independently by PARAMETRIC_ALGORITHM, on a thread pool.
+ * The source component at alphaMin and the sink component at alphaMax are fixed for the whole interval, since the cuts
+ * are nested. They are contracted into the terminals, as in the chord scheme. Two remaining vertices interact only if
+ * an edge with nonzero capacity connects them. So the parts are the strongly connected components of the remaining
+ * graph without the terminals, in which every such edge is present in both directions. Components that only meet at
+ * the terminals contribute independently to every cut, which gives every part its own breakpoints.
+ * Small components are packed together, so that every task solves at least ParallelPartThreshold vertices.
+ * Residual-graph components alone would not suffice: an edge that is saturated in one direction still adds to the
+ * capacity of every cut that separates its endpoints.
+ */
+template<pmf::flowFunction FLOW_FUNCTION, typename PARAMETRIC_ALGORITHM = ParametricIBFS<FLOW_FUNCTION>, bool MEASUREMENTS = false>
+class DecomposedParametricIBFS {
+private:
+    inline static constexpr size_t ParallelPartThreshold = 1024;
+    inline static constexpr Vertex LocalSource = Vertex(0);
+    inline static constexpr Vertex LocalSink = Vertex(1);
+
+public:
+    using FlowFunction = FLOW_FUNCTION;
+    using FlowType = FlowFunction::FlowType;
+    using ParametricInstance = ParametricMaxFlowInstance<FlowFunction>;
+    using Wrapper = ChordSchemeMaxFlowWrapper<FlowFunction>;
+    using SearchAlgorithm = IBFS<Wrapper>;
+    using ParametricAlgorithm = PARAMETRIC_ALGORITHM;
+
+    DecomposedParametricIBFS(const ParametricInstance& instance, const size_t numThreads = 1, ThreadScheduler* scheduler = nullptr) :
+        instance(instance),
+        numThreads(numThreads),
+        scheduler(scheduler),
+        breakpointOfVertex(instance.graph.numVertices(), INFTY) {
+    }
+
+    inline void run() noexcept {
+        Timer timer;
+        Wrapper wrapper(instance);
+        SearchAlgorithm search(wrapper);
+        search.run();
+        const std::vector<bool> inSinkComponentMin = search.getInSinkComponent();
+        std::vector<bool> inSinkComponentMax(instance.graph.numVertices(), false);
+        if (instance.alphaMax < INFTY) {
+            wrapper.setAlpha(instance.alphaMax);
+            search.reset(wrapper);
+            search.run();
+            inSinkComponentMax = search.getInSinkComponent();
+        }
+        for (const Vertex vertex : instance.graph.vertices()) {
+            if (!inSinkComponentMin[vertex]) breakpointOfVertex[vertex] = instance.alphaMin;
+        }
+        const Wrapper contracted = wrapper.contractSourceAndSinkComponents(inSinkComponentMin, inSinkComponentMax);
+        const std::vector<std::vector<Vertex>> parts = computeParts(contracted);
+        if constexpr (MEASUREMENTS) decompositionTime = timer.elapsedMicroseconds();
+
+        timer.restart();
+        // Maps every vertex of the contracted graph to its vertex in the instance of its part. The terminals are the same
+        // in every part, the entries of the other vertices are written by the task of their part.
+        std::vector<Vertex> localVertex(contracted.graph.numVertices(), noVertex);
+        localVertex[contracted.source] = LocalSource;
+        localVertex[contracted.sink] = LocalSink;
+        WorkStealingPool pool(numThreads, scheduler);
+        for (const std::vector<Vertex>& part : parts) {
+            pool.spawn([&]() {
+                solvePart(contracted, part, localVertex);
+            });
+        }
+        pool.wait();
+        if constexpr (MEASUREMENTS) solveTime = timer.elapsedMicroseconds();
+
+        breakpointIndex.build(instance, breakpointOfVertex);
+        if constexpr (MEASUREMENTS) {
+            std::cout << "Decomposition time: " << String::musToString(decompositionTime) << std::endl;
+            std::cout << "Solve time: " << String::musToString(solveTime) << std::endl;
+            std::cout << "#Components: " << numComponents << std::endl;
+            std::cout << "#Parts: " << parts.size() << std::endl;
+            std::cout << "#Vertices (largest component): " << largestComponentSize << std::endl;
+        }
+    }
+
+    inline const std::vector<double>& getBreakpoints() const noexcept {
+        return breakpointIndex.getBreakpoints();
+    }
+
+    inline const std::vector<double>& getVertexBreakpoints() const noexcept {
+        return breakpointOfVertex;
+    }
+
+    // The vertices are ordered by breakpoint, not by id.
+    inline std::span<const Vertex> getSinkComponent(const double alpha) const noexcept {
+        return breakpointIndex.getSinkComponent(alpha);
+    }
+
+    inline double getFlowValue(const double alpha) const noexcept {
+        return breakpointIndex.getFlowValue(alpha);
+    }
+
+    inline double getDecompositionTime() const noexcept {
+        return decompositionTime;
+    }
+
+    inline double getSolveTime() const noexcept {
+        return solveTime;
+    }
+
+    inline size_t getNumComponents() const noexcept {
+        return numComponents;
+    }
+
+    inline size_t getLargestComponentSize() const noexcept {
+        return largestComponentSize;
+    }
+
+private:
+    // Returns the vertices of the contracted graph, other than the terminals, grouped into parts. Larger parts come first.
+    inline std::vector<std::vector<Vertex>> computeParts(const Wrapper& contracted) noexcept {
+        const auto& graph = contracted.graph;
+        SimpleEdgeList interactions;
+        interactions.addVertices(graph.numVertices());
+        for (const Vertex from : graph.vertices()) {
+            if (from == contracted.source || from == contracted.sink) continue;
+            for (const Edge edge : graph.edgesFrom(from)) {
+                const Vertex to = graph.get(ToVertex, edge);
+                if (to == contracted.source || to == contracted.sink) continue;
+                if (isZero(graph.get(Capacity, edge)) && isZero(graph.get(Capacity, graph.get(ReverseEdge, edge)))) continue;
+                interactions.addEdge(from, to);
+            }
+        }
+        SimpleStaticGraph interactionGraph;
+        Graph::move(std::move(interactions), interactionGraph);
+        StronglyConnectedComponents<SimpleStaticGraph, false> scc(interactionGraph);
+        scc.run();
+
+        std::vector<std::vector<Vertex>> components(scc.numComponents());
+        for (const Vertex vertex : graph.vertices()) {
+            if (vertex == contracted.source || vertex == contracted.sink) continue;
+            components[scc.getComponent(vertex)].emplace_back(vertex);
+        }
+        std::erase_if(components, [](const std::vector<Vertex>& component) { return component.empty(); });
+        std::sort(components.begin(), components.end(), [](const std::vector<Vertex>& a, const std::vector<Vertex>& b) {
+            return a.size() > b.size();
+        });
+        numComponents = components.size();
+        largestComponentSize = components.empty() ? 0 : components[0].size();
+
+        std::vector<std::vector<Vertex>> parts;
+        for (std::vector<Vertex>& component : components) {
+            if (parts.empty() || parts.back().size() >= ParallelPartThreshold) {
+                parts.emplace_back(std::move(component));
+            } else {
+                parts.back().insert(parts.back().end(), component.begin(), component.end());
+            }
+        }
+        return parts;
+    }
+
+    // Builds the instance induced by the part and the terminals and solves it. Parts are disjoint, so every task
+    // writes and reads only its own entries of localVertex and breakpointOfVertex, besides the terminals.
+    inline void solvePart(const Wrapper& contracted, const std::vector<Vertex>& part, std::vector<Vertex>& localVertex) noexcept {
+        const auto& graph = contracted.graph;
+        for (size_t i = 0; i < part.size(); i++) {
+            localVertex[part[i]] = Vertex(i + 2);
+        }
+
+        std::vector<std::vector<pmf::FlowArc<FlowFunction>>> arcs(1);
+        for (const Vertex from : part) {
+            for (const Edge edge : graph.edgesFrom(from)) {
+                // Edges without capacity in either direction do not matter. All other edges stay within the part or
+                // lead to a terminal, so the head is never a vertex of another part.
+                if (isZero(graph.get(Capacity, edge)) && isZero(graph.get(Capacity, graph.get(ReverseEdge, edge)))) continue;
+                const Vertex to = graph.get(ToVertex, edge);
+                Assert(localVertex[to] != noVertex, "Vertex " << to << " is not in the part or a terminal!");
+                arcs[0].emplace_back(pmf::FlowArc<FlowFunction>{localVertex[from], localVertex[to], graph.get(Capacity, edge)});
+                if (to == contracted.source || to == contracted.sink) {
+                    arcs[0].emplace_back(pmf::FlowArc<FlowFunction>{localVertex[to], localVertex[from], graph.get(Capacity, graph.get(ReverseEdge, edge))});
+                }
+            }
+        }
+        ParametricInstance partInstance;
+        pmf::buildFlowGraph(partInstance.graph, part.size() + 2, arcs);
+        partInstance.source = LocalSource;
+        partInstance.sink = LocalSink;
+        partInstance.alphaMin = instance.alphaMin;
+        partInstance.alphaMax = instance.alphaMax;
+
+        ParametricAlgorithm algorithm(partInstance);
+        algorithm.run();
+        const std::vector<double>& partBreakpoints = algorithm.getVertexBreakpoints();
+        for (size_t i = 0; i < part.size(); i++) {
+            breakpointOfVertex[contracted.newToOldVertex[part[i]]] = partBreakpoints[i + 2];
+        }
+    }
+
+    inline static bool isZero(const FlowFunction& capacity) noexcept {
+        return capacity == FlowFunction(0);
+    }
+
+private:
+    const ParametricInstance& instance;
+    const size_t numThreads;
+    ThreadScheduler* scheduler;
+    BreakpointIndex<FlowFunction> breakpointIndex;
+    std::vector<double> breakpointOfVertex;
+
+    double decompositionTime = 0;
+    double solveTime = 0;
+    size_t numComponents = 0;
+    size_t largestComponentSize = 0;
+};
@@ -0,0 +1,672 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "../../DataStructures/Graph/Graph.h"
+#include "../../DataStructures/MaxFlowMinCut/BreakpointIndex.h"
+#include "../../DataStructures/MaxFlowMinCut/FlowUtils.h"
+#include "../../DataStructures/MaxFlowMinCut/MaxFlowInstance.h"
+
+#include "../../Helpers/Assert.h"
+#include "../../Helpers/String/String.h"
+#include "../../Helpers/Timer.h"
+#include "../../Helpers/Types.h"
+
+/**
+ * Highest-label push-relabel on the interior vertices of a graph. All other vertices are contracted into the source
+ * or the sink, as given by side. The flow is stored per edge and kept between runs, so every run continues from the
+ * preflow of an earlier one: arcs out of the source side are saturated, the flow on arcs into the sink side is clipped
+ * to the new capacities, and the excesses are recomputed from the flow. Only these boundary arcs may change their
+ * capacity between runs. Labels are recomputed by a BFS towards the sink side at the start of every run.
+ * A run is split into steps that discharge one vertex each, so that two runs can be interleaved.
+ */
+template<typename GRAPH, typename FLOW_TYPE>
+class WarmStartPushRelabel {
+public:
+    using GraphType = GRAPH;
+    using FlowType = FLOW_TYPE;
+
+    enum class Side : uint8_t {
+        Interior,
+        Source,
+        Sink
+    };
+
+private:
+    inline static constexpr size_t VertexToEdgeRatio = 12;
+
+public:
+    // Sets the flow to zero and all vertices to the interior.
+    template<typename CAPACITY>
+    inline void initialize(const GraphType& newGraph, const CAPACITY& capacityOf) noexcept {
+        graph = &newGraph;
+        const size_t n = graph->numVertices();
+        capacity.resize(graph->numEdges());
+        for (const Edge edge : graph->edges()) {
+            capacity[edge] = capacityOf(edge);
+        }
+        flow.assign(graph->numEdges(), 0);
+        side.assign(n, Side::Interior);
+        inSinkComponent.assign(n, false);
+        inSourceComponent.assign(n, false);
+        excess.assign(n, 0);
+        label.assign(n, 0);
+        currentEdge.assign(n, noEdge);
+        firstActive.assign(n + 2, noVertex);
+        nextActive.assign(n, noVertex);
+        firstWithLabel.assign(n + 2, noVertex);
+        nextWithLabel.assign(n, noVertex);
+        previousWithLabel.assign(n, noVertex);
+        highestActive = -1;
+        highestLabel = -1;
+    }
+
+    // Prepares a run on the given interior with the boundary capacities given by capacityOf.
+    template<typename CAPACITY>
+    inline void begin(const std::vector<Vertex>& newInterior, const CAPACITY& capacityOf) noexcept {
+        interior = &newInterior;
+        unreachable = newInterior.size() + 1;
+        workLimit = VertexToEdgeRatio * newInterior.size();
+        for (const Vertex vertex : newInterior) {
+            excess[vertex] = 0;
+            workLimit += graph->outDegree(vertex);
+            for (const Edge edge : graph->edgesFrom(vertex)) {
+                const Vertex to = graph->get(ToVertex, edge);
+                if (side[to] != Side::Interior) {
+                    const Edge reverseEdge = graph->get(ReverseEdge, edge);
+                    capacity[edge] = capacityOf(edge);
+                    capacity[reverseEdge] = capacityOf(reverseEdge);
+                    if (side[to] == Side::Source) {
+                        flow[edge] = -capacity[reverseEdge];
+                    } else {
+                        flow[edge] = std::clamp(flow[edge], -capacity[reverseEdge], capacity[edge]);
+                    }
+                    flow[reverseEdge] = -flow[edge];
+                }
+                excess[vertex] -= flow[edge];
+            }
+            Assert(!pmf::isNumberNegative(excess[vertex]), "Vertex " << vertex << " has a deficit!");
+        }
+        work = 0;
+        workSinceLastUpdate = 0;
+        globalRelabel();
+    }
+
+    // Discharges the highest active vertex. Returns false if there is none, i.e., the preflow is maximum.
+    inline bool step() noexcept {
+        while (highestActive >= 0 && firstActive[highestActive] == noVertex) highestActive--;
+        if (highestActive < 0) return false;
+        const Vertex vertex = firstActive[highestActive];
+        firstActive[highestActive] = nextActive[vertex];
+        discharge(vertex);
+        if (workSinceLastUpdate > workLimit) {
+            globalRelabel();
+            workSinceLastUpdate = 0;
+        }
+        return true;
+    }
+
+    // Marks the interior vertices that can reach the sink side, which form the minimal sink component.
+    inline void computeSinkComponent() noexcept {
+        queue.clear();
+        for (const Vertex vertex : *interior) {
+            inSinkComponent[vertex] = hasResidualArcTo(vertex, Side::Sink);
+            if (inSinkComponent[vertex]) queue.emplace_back(vertex);
+        }
+        for (size_t i = 0; i < queue.size(); i++) {
+            for (const Edge edge : graph->edgesFrom(queue[i])) {
+                const Vertex from = graph->get(ToVertex, edge);
+                if (side[from] != Side::Interior || inSinkComponent[from]) continue;
+                if (!isEdgeResidual(graph->get(ReverseEdge, edge))) continue;
+                Assert(!pmf::isNumberPositive(excess[from]), "Vertex " << from << " with excess can reach the sink!");
+                inSinkComponent[from] = true;
+                queue.emplace_back(from);
+            }
+        }
+    }
+
+    // Marks the interior vertices that can be reached from the source side or from a vertex with excess, which form
+    // the minimal source component.
+    inline void computeSourceComponent() noexcept {
+        queue.clear();
+        for (const Vertex vertex : *interior) {
+            inSourceComponent[vertex] = pmf::isNumberPositive(excess[vertex]) || hasResidualArcFrom(vertex, Side::Source);
+            if (inSourceComponent[vertex]) queue.emplace_back(vertex);
+        }
+        for (size_t i = 0; i < queue.size(); i++) {
+            for (const Edge edge : graph->edgesFrom(queue[i])) {
+                const Vertex to = graph->get(ToVertex, edge);
+                if (side[to] != Side::Interior || inSourceComponent[to]) continue;
+                if (!isEdgeResidual(edge)) continue;
+                inSourceComponent[to] = true;
+                queue.emplace_back(to);
+            }
+        }
+    }
+
+    // The work of the current run, measured like the work between two global relabels.
+    inline size_t getWork() const noexcept {
+        return work;
+    }
+
+    inline size_t getNumPushes() const noexcept {
+        return numPushes;
+    }
+
+    inline size_t getNumRelabels() const noexcept {
+        return numRelabels;
+    }
+
+private:
+    // Sets every label to the residual distance to the sink side and rebuilds the buckets.
+    inline void globalRelabel() noexcept {
+        for (int i = 0; i <= highestLabel; i++) {
+            firstActive[i] = noVertex;
+            firstWithLabel[i] = noVertex;
+        }
+        highestActive = -1;
+        highestLabel = -1;
+        queue.clear();
+        for (const Vertex vertex : *interior) {
+            currentEdge[vertex] = graph->beginEdgeFrom(vertex);
+            if (hasResidualArcTo(vertex, Side::Sink)) {
+                label[vertex] = 1;
+                queue.emplace_back(vertex);
+            } else {
+                label[vertex] = unreachable;
+            }
+        }
+        for (size_t i = 0; i < queue.size(); i++) {
+            const Vertex vertex = queue[i];
+            for (const Edge edge : graph->edgesFrom(vertex)) {
+                const Vertex from = graph->get(ToVertex, edge);
+                if (side[from] != Side::Interior || label[from] != unreachable) continue;
+                if (!isEdgeResidual(graph->get(ReverseEdge, edge))) continue;
+                label[from] = label[vertex] + 1;
+                queue.emplace_back(from);
+            }
+        }
+        for (const Vertex vertex : queue) {
+            addWithLabel(vertex);
+            if (pmf::isNumberPositive(excess[vertex])) makeVertexActive(vertex);
+        }
+    }
+
+    inline void discharge(const Vertex vertex) noexcept {
+        while (pmf::isNumberPositive(excess[vertex])) {
+            const Edge edge = findPushableEdge(vertex);
+            if (edge == noEdge) {
+                relabel(vertex);
+                if (label[vertex] < unreachable) makeVertexActive(vertex);
+                return;
+            }
+            pushFlow(vertex, edge);
+        }
+    }
+
+    inline Edge findPushableEdge(const Vertex vertex) noexcept {
+        for (Edge edge = currentEdge[vertex]; edge < graph->endEdgeFrom(vertex); edge++) {
+            if (!isEdgeResidual(edge)) continue;
+            const Vertex to = graph->get(ToVertex, edge);
+            const bool admissible = (side[to] == Side::Interior) ? label[to] + 1 == label[vertex] : (side[to] == Side::Sink && label[vertex] == 1);
+            if (!admissible) continue;
+            currentEdge[vertex] = edge;
+            return edge;
+        }
+        return noEdge;
+    }
+
+    inline void pushFlow(const Vertex from, const Edge edge) noexcept {
+        const Vertex to = graph->get(ToVertex, edge);
+        const FlowType amount = std::min(excess[from], capacity[edge] - flow[edge]);
+        flow[edge] += amount;
+        flow[graph->get(ReverseEdge, edge)] -= amount;
+        excess[from] -= amount;
+        work++;
+        numPushes++;
+        if (side[to] != Side::Interior) return;
+        const bool wasActive = pmf::isNumberPositive(excess[to]);
+        excess[to] += amount;
+        if (!wasActive && pmf::isNumberPositive(excess[to])) makeVertexActive(to);
+    }
+
+    // Lifts the vertex above its lowest residual neighbour. If its old label becomes empty, no vertex above it can
+    // reach the sink side anymore, and all of them are lifted out of the buckets.
+    inline void relabel(const Vertex vertex) noexcept {
+        const int oldLabel = label[vertex];
+        int newLabel = unreachable;
+        Edge newEdge = noEdge;
+        const size_t scanWork = VertexToEdgeRatio + graph->outDegree(vertex);
+        work += scanWork;
+        workSinceLastUpdate += scanWork;
+        numRelabels++;
+        for (const Edge edge : graph->edgesFrom(vertex)) {
+            if (!isEdgeResidual(edge)) continue;
+            const Vertex to = graph->get(ToVertex, edge);
+            const int toLabel = (side[to] == Side::Interior) ? label[to] : (side[to] == Side::Sink ? 0 : unreachable);
+            if (toLabel + 1 < newLabel) {
+                newLabel = toLabel + 1;
+                newEdge = edge;
+            }
+        }
+        Assert(newLabel > oldLabel, "Relabel did not increase the label!");
+        removeWithLabel(vertex);
+        label[vertex] = newLabel;
+        currentEdge[vertex] = newEdge;
+        if (newLabel < unreachable) addWithLabel(vertex);
+        if (firstWithLabel[oldLabel] == noVertex) liftAbove(oldLabel);
+    }
+
+    inline void liftAbove(const int gap) noexcept {
+        for (int i = gap + 1; i <= highestLabel; i++) {
+            for (Vertex vertex = firstWithLabel[i]; vertex != noVertex; vertex = nextWithLabel[vertex]) {
+                label[vertex] = unreachable;
+            }
+            firstWithLabel[i] = noVertex;
+            firstActive[i] = noVertex;
+        }
+        highestLabel = gap - 1;
+        highestActive = std::min(highestActive, highestLabel);
+    }
+
+    inline void makeVertexActive(const Vertex vertex) noexcept {
+        Assert(label[vertex] < unreachable, "Vertex " << vertex << " cannot reach the sink!");
+        nextActive[vertex] = firstActive[label[vertex]];
+        firstActive[label[vertex]] = vertex;
+        highestActive = std::max(highestActive, label[vertex]);
+    }
+
+    inline void addWithLabel(const Vertex vertex) noexcept {
+        const int i = label[vertex];
+        previousWithLabel[vertex] = noVertex;
+        nextWithLabel[vertex] = firstWithLabel[i];
+        if (firstWithLabel[i] != noVertex) previousWithLabel[firstWithLabel[i]] = vertex;
+        firstWithLabel[i] = vertex;
+        highestLabel = std::max(highestLabel, i);
+    }
+
+    inline void removeWithLabel(const Vertex vertex) noexcept {
+        if (previousWithLabel[vertex] == noVertex) {
+            firstWithLabel[label[vertex]] = nextWithLabel[vertex];
+        } else {
+            nextWithLabel[previousWithLabel[vertex]] = nextWithLabel[vertex];
+        }
+        if (nextWithLabel[vertex] != noVertex) previousWithLabel[nextWithLabel[vertex]] = previousWithLabel[vertex];
+    }
+
+    inline bool hasResidualArcTo(const Vertex vertex, const Side target) const noexcept {
+        for (const Edge edge : graph->edgesFrom(vertex)) {
+            if (side[graph->get(ToVertex, edge)] == target && isEdgeResidual(edge)) return true;
+        }
+        return false;
+    }
+
+    inline bool hasResidualArcFrom(const Vertex vertex, const Side origin) const noexcept {
+        for (const Edge edge : graph->edgesFrom(vertex)) {
+            if (side[graph->get(ToVertex, edge)] == origin && isEdgeResidual(graph->get(ReverseEdge, edge))) return true;
+        }
+        return false;
+    }
+
+    inline bool isEdgeResidual(const Edge edge) const noexcept {
+        return pmf::isNumberPositive(capacity[edge] - flow[edge]);
+    }
+
+public:
+    std::vector<FlowType> flow;
+    std::vector<Side> side;
+    std::vector<bool> inSinkComponent;
+    std::vector<bool> inSourceComponent;
+
+private:
+    const GraphType* graph = nullptr;
+    const std::vector<Vertex>* interior = nullptr;
+    int unreachable = 0;
+    std::vector<FlowType> capacity;
+    std::vector<FlowType> excess;
+    std::vector<int> label;
+    std::vector<Edge> currentEdge;
+    std::vector<Vertex> firstActive;
+    std::vector<Vertex> nextActive;
+    std::vector<Vertex> firstWithLabel;
+    std::vector<Vertex> nextWithLabel;
+    std::vector<Vertex> previousWithLabel;
+    int highestActive = -1;
+    int highestLabel = -1;
+    std::vector<Vertex> queue;
+    size_t work = 0;
+    size_t workSinceLastUpdate = 0;
+    size_t workLimit = 0;
+
+    size_t numPushes = 0;
+    size_t numRelabels = 0;
+};
+
+/**
+ * Computes all breakpoints of a source-sink monotone parametric instance by divide and conquer with warm-started
+ * push-relabel. The intervals are split as in the chord scheme, at the intersection of the capacity functions of the
+ * cuts at their ends. Every subproblem keeps two preflows: a forward one on the graph, which is valid at the left end
+ * of the interval and stays valid as alpha increases, and a backward one on the reverse graph, which is valid at the
+ * right end and stays valid as alpha decreases. Both are advanced to the split point in turns of equal work, and the
+ * first one to finish yields the minimum cut. The forward preflow of the split point carries over to the sink side,
+ * and the backward one to the source side, whether finished or not. The other two halves are restored from the state
+ * before the split.
+ * The two-sided interleaving follows Gallo, Grigoriadis and Tarjan, but this is not their algorithm: there are no
+ * dynamic trees, and the labels are recomputed at the start of every run instead of being carried across
+ * subproblems. Every discharge is a plain highest-label push-relabel with gap and global relabeling, so a subproblem
+ * on n_I interior vertices and m_I arcs takes O(n_I^2 sqrt(m_I)), without the amortized O(nm log(n^2/m)) total bound.
+ * The two preflows run on a single thread.
+ * Instead of building contracted graphs, all subproblems run on the original graph, and the vertices outside of the
+ * interval are only marked as source or sink side. Like ParametricIBFS, only arcs incident to the source or the sink
+ * may depend on alpha.
+ */
+template<pmf::flowFunction FLOW_FUNCTION, bool MEASUREMENTS = false>
+class DivideAndConquerPushRelabel {
+public:
+    using FlowFunction = FLOW_FUNCTION;
+    using FlowType = FlowFunction::FlowType;
+    using ParametricInstance = ParametricMaxFlowInstance<FlowFunction>;
+    using GraphType = ParametricInstance::GraphType;
+    using Core = WarmStartPushRelabel<GraphType, FlowType>;
+    using Side = Core::Side;
+
+private:
+    // The vertices of a subproblem, split by the minimum cut at some alpha, and the capacity function of that cut.
+    struct Split {
+        std::vector<Vertex> sourceSide;
+        std::vector<Vertex> sinkSide;
+        FlowFunction cutCapacity;
+    };
+
+public:
+    explicit DivideAndConquerPushRelabel(const ParametricInstance& instance) :
+        instance(instance),
+        graph(instance.graph),
+        breakpointOfVertex(instance.graph.numVertices(), INFTY) {
+    }
+
+    inline void run() noexcept {
+        Timer timer;
+        forward.initialize(graph, [&](const Edge edge) {
+            return instance.getCapacity(edge, instance.alphaMin);
+        });
+        backward.initialize(graph, [&](const Edge edge) {
+            return instance.getCapacity(graph.get(ReverseEdge, edge), instance.alphaMin);
+        });
+        forward.side[instance.source] = Side::Source;
+        backward.side[instance.source] = Side::Sink;
+        forward.side[instance.sink] = Side::Sink;
+        backward.side[instance.sink] = Side::Source;
+        std::vector<Vertex> interior;
+        for (const Vertex vertex : graph.vertices()) {
+            if (vertex != instance.source && vertex != instance.sink) interior.emplace_back(vertex);
+        }
+
+        // Every vertex starts on the sink side, so the initial cut consists of the source arcs.
+        FlowFunction sourceCut(0);
+        for (const Edge edge : graph.edgesFrom(instance.source)) {
+            sourceCut += graph.get(Capacity, edge);
+        }
+        beginForward(interior, instance.alphaMin);
+        finish(forward);
+        forward.computeSinkComponent();
+        const Split splitMin = split(interior, sourceCut, forward.inSinkComponent);
+        setSide(splitMin.sourceSide, Side::Source);
+        setBreakpoints(splitMin.sourceSide, instance.alphaMin);
+        breakpointOfVertex[instance.source] = instance.alphaMin;
+
+        beginBackward(splitMin.sinkSide, instance.alphaMax);
+        finish(backward);
+        backward.computeSourceComponent();
+        const Split splitMax = split(splitMin.sinkSide, splitMin.cutCapacity, backward.inSourceComponent);
+        setSide(splitMax.sinkSide, Side::Sink);
+        recurse(instance.alphaMin, instance.alphaMax, splitMax.sourceSide, splitMin.cutCapacity, splitMax.cutCapacity);
+
+        breakpointIndex.build(instance, breakpointOfVertex);
+        if constexpr (MEASUREMENTS) {
+            totalTime = timer.elapsedMicroseconds();
+            std::cout << "Flow time: " << String::musToString(flowTime) << std::endl;
+            std::cout << "Total time: " << String::musToString(totalTime) << std::endl;
+            std::cout << "#Subproblems: " << numSubproblems << std::endl;
+            std::cout << "#Vertices (total): " << totalVertices << std::endl;
+            std::cout << "#Forward wins: " << numForwardWins << std::endl;
+            std::cout << "#Backward wins: " << numSubproblems - numForwardWins << std::endl;
+            std::cout << "#Pushes: " << forward.getNumPushes() + backward.getNumPushes() << std::endl;
+            std::cout << "#Relabels: " << forward.getNumRelabels() + backward.getNumRelabels() << std::endl;
+        }
+    }
+
+    inline const std::vector<double>& getBreakpoints() const noexcept {
+        return breakpointIndex.getBreakpoints();
+    }
+
+    inline const std::vector<double>& getVertexBreakpoints() const noexcept {
+        return breakpointOfVertex;
+    }
+
+    // The vertices are ordered by breakpoint, not by id.
+    inline std::span<const Vertex> getSinkComponent(const double alpha) const noexcept {
+        return breakpointIndex.getSinkComponent(alpha);
+    }
+
+    inline double getFlowValue(const double alpha) const noexcept {
+        return breakpointIndex.getFlowValue(alpha);
+    }
+
+    inline double getFlowTime() const noexcept {
+        return flowTime;
+    }
+
+    inline size_t getNumSubproblems() const noexcept {
+        return numSubproblems;
+    }
+
+    inline size_t getNumForwardWins() const noexcept {
+        return numForwardWins;
+    }
+
+    inline long long getTotalVertices() const noexcept {
+        return totalVertices;
+    }
+
+private:
+    // The forward preflow of the interior is valid at left, the backward one at right.
+    inline void recurse(const double left, const double right, const std::vector<Vertex>& interior, const FlowFunction& leftCut, const FlowFunction& rightCut) noexcept {
+        if (interior.empty()) return;
+        const double mid = findIntersectionPoint(leftCut, rightCut);
+        if (mid <= left || mid >= right) {
+            setBreakpoints(interior, left);
+            return;
+        }
+
+        saveFlow(forward, savedForwardFlow, interior);
+        saveFlow(backward, savedBackwardFlow, interior);
+        Timer timer;
+        beginForward(interior, mid);
+        beginBackward(interior, mid);
+        const bool forwardWins = finishFirst();
+        if (forwardWins) {
+            forward.computeSinkComponent();
+        } else {
+            backward.computeSourceComponent();
+        }
+        const std::vector<bool>& inSinkComponent = forwardWins ? forward.inSinkComponent : backward.inSourceComponent;
+        if constexpr (MEASUREMENTS) {
+            flowTime += timer.elapsedMicroseconds();
+            numSubproblems++;
+            numForwardWins += forwardWins;
+            totalVertices += interior.size();
+        }
+
+        const Split splitMid = split(interior, leftCut, inSinkComponent);
+        const double oldValue = leftCut.eval(mid);
+        const double newValue = splitMid.cutCapacity.eval(mid);
+        // At a breakpoint, the minimal sink component of the split point is that of the right end, so no interior vertex
+        // stays on the sink side.
+        if (splitMid.sinkSide.empty() || oldValue <= newValue) {
+            discardSavedFlow(savedForwardFlow, interior);
+            discardSavedFlow(savedBackwardFlow, interior);
+            setBreakpoints(interior, mid);
+            return;
+        }
+
+        keepSavedFlow(savedForwardFlow, interior, inSinkComponent, false);
+        restoreSavedFlow(backward, savedBackwardFlow, interior, inSinkComponent, true);
+        setSide(splitMid.sourceSide, Side::Source);
+        recurse(mid, right, splitMid.sinkSide, splitMid.cutCapacity, rightCut);
+        setSide(splitMid.sinkSide, Side::Sink);
+        restoreSavedFlow(forward, savedForwardFlow, splitMid.sourceSide);
+        setSide(splitMid.sourceSide, Side::Interior);
+        recurse(left, mid, splitMid.sourceSide, leftCut, splitMid.cutCapacity);
+    }
+
+    // Sink arcs with a negative slope evaluate to a negative capacity at alphaMax = INFTY, where only the slopes
+    // count. Such arcs have no capacity left, so the boundary capacities are clamped at zero.
+    inline void beginForward(const std::vector<Vertex>& interior, const double alpha) noexcept {
+        forward.begin(interior, [&](const Edge edge) {
+            return std::max<FlowType>(0, instance.getCapacity(edge, alpha));
+        });
+    }
+
+    // The backward preflow runs on the reverse graph, where every edge has the capacity of its reverse edge.
+    inline void beginBackward(const std::vector<Vertex>& interior, const double alpha) noexcept {
+        backward.begin(interior, [&](const Edge edge) {
+            return std::max<FlowType>(0, instance.getCapacity(graph.get(ReverseEdge, edge), alpha));
+        });
+    }
+
+    inline void finish(Core& core) noexcept {
+        while (core.step());
+    }
+
+    // Advances the preflow that has done less work so far, until one of them is maximum. Returns whether the forward
+    // preflow finished first.
+    inline bool finishFirst() noexcept {
+        while (true) {
+            if (forward.getWork() <= backward.getWork()) {
+                if (!forward.step()) return true;
+            } else {
+                if (!backward.step()) return false;
+            }
+        }
+    }
+
+    // The capacity of the new cut is derived from the previous one by moving the source side of the interior.
+    inline Split split(const std::vector<Vertex>& interior, const FlowFunction& previousCut, const std::vector<bool>& inSinkComponent) const noexcept {
+        Split result;
+        result.cutCapacity = previousCut;
+        for (const Vertex vertex : interior) {
+            if (inSinkComponent[vertex]) {
+                result.sinkSide.emplace_back(vertex);
+                continue;
+            }
+            result.sourceSide.emplace_back(vertex);
+            for (const Edge edge : graph.edgesFrom(vertex)) {
+                const Vertex to = graph.get(ToVertex, edge);
+                if (forward.side[to] == Side::Source) {
+                    result.cutCapacity -= graph.get(Capacity, graph.get(ReverseEdge, edge));
+                } else if (forward.side[to] == Side::Sink || inSinkComponent[to]) {
+                    result.cutCapacity += graph.get(Capacity, edge);
+                }
+            }
+        }
+        return result;
+    }
+
+    inline void saveFlow(const Core& core, std::vector<FlowType>& saved, const std::vector<Vertex>& vertices) noexcept {
+        for (const Vertex vertex : vertices) {
+            for (const Edge edge : graph.edgesFrom(vertex)) {
+                saved.emplace_back(core.flow[edge]);
+            }
+        }
+    }
+
+    // Keeps the saved flow of the interior vertices on the given side of the cut and drops the rest of the frame.
+    inline void keepSavedFlow(std::vector<FlowType>& saved, const std::vector<Vertex>& interior, const std::vector<bool>& inSinkComponent, const bool sinkSide) noexcept {
+        size_t read = saved.size() - numEdgesFrom(interior);
+        size_t write = read;
+        for (const Vertex vertex : interior) {
+            if (inSinkComponent[vertex] != sinkSide) {
+                read += graph.outDegree(vertex);
+                continue;
+            }
+            for (size_t i = 0; i < graph.outDegree(vertex); i++) {
+                saved[write++] = saved[read++];
+            }
+        }
+        saved.resize(write);
+    }
+
+    // Restores the saved flow of the interior vertices on the given side of the cut and drops the frame.
+    inline void restoreSavedFlow(Core& core, std::vector<FlowType>& saved, const std::vector<Vertex>& interior, const std::vector<bool>& inSinkComponent, const bool sinkSide) noexcept {
+        size_t i = saved.size() - numEdgesFrom(interior);
+        const size_t frame = i;
+        for (const Vertex vertex : interior) {
+            if (inSinkComponent[vertex] != sinkSide) {
+                i += graph.outDegree(vertex);
+                continue;
+            }
+            for (const Edge edge : graph.edgesFrom(vertex)) {
+                core.flow[edge] = saved[i++];
+            }
+        }
+        saved.resize(frame);
+    }
+
+    inline void restoreSavedFlow(Core& core, std::vector<FlowType>& saved, const std::vector<Vertex>& vertices) noexcept {
+        size_t i = saved.size() - numEdgesFrom(vertices);
+        const size_t frame = i;
+        for (const Vertex vertex : vertices) {
+            for (const Edge edge : graph.edgesFrom(vertex)) {
+                core.flow[edge] = saved[i++];
+            }
+        }
+        saved.resize(frame);
+    }
+
+    inline void discardSavedFlow(std::vector<FlowType>& saved, const std::vector<Vertex>& vertices) noexcept {
+        saved.resize(saved.size() - numEdgesFrom(vertices));
+    }
+
+    inline size_t numEdgesFrom(const std::vector<Vertex>& vertices) const noexcept {
+        size_t result = 0;
+        for (const Vertex vertex : vertices) {
+            result += graph.outDegree(vertex);
+        }
+        return result;
+    }
+
+    // The backward preflow sees the source side as its sink side and vice versa.
+    inline void setSide(const std::vector<Vertex>& vertices, const Side side) noexcept {
+        const Side reverseSide = (side == Side::Source) ? Side::Sink : (side == Side::Sink ? Side::Source : Side::Interior);
+        for (const Vertex vertex : vertices) {
+            forward.side[vertex] = side;
+            backward.side[vertex] = reverseSide;
+        }
+    }
+
+    inline void setBreakpoints(const std::vector<Vertex>& vertices, const double breakpoint) noexcept {
+        for (const Vertex vertex : vertices) {
+            breakpointOfVertex[vertex] = breakpoint;
+        }
+    }
+
+private:
+    const ParametricInstance& instance;
+    const GraphType& graph;
+    Core forward;
+    Core backward;
+    std::vector<FlowType> savedForwardFlow;
+    std::vector<FlowType> savedBackwardFlow;
+    BreakpointIndex<FlowFunction> breakpointIndex;
+    std::vector<double> breakpointOfVertex;
+
+    double flowTime = 0;
+    double totalTime = 0;
+    size_t numSubproblems = 0;
+    size_t numForwardWins = 0;
+    long long totalVertices = 0;
+};
@@ -4,6 +4,7 @@
 #include <vector>
 
 #include "../../DataStructures/Graph/Graph.h"
+#include "../../DataStructures/MaxFlowMinCut/DistanceBuckets.h"
 #include "../../DataStructures/MaxFlowMinCut/MaxFlowInstance.h"
 
 #include "../../Helpers/Assert.h"
@@ -19,117 +20,6 @@ public:
     using GraphType = MaxFlowInstance::GraphType;
 
 private:
-    struct ExcessBuckets {
-        ExcessBuckets(const int n) :
-            buckets(n), positionOfVertex(n, -1), maxBucket(-1) {
-        }
-
-        inline void addVertex(const Vertex vertex, const int dist) noexcept {
-            if (positionOfVertex[vertex] != -1) return;
-            positionOfVertex[vertex] = buckets[dist].size();
-            buckets[dist].emplace_back(vertex);
-            maxBucket = std::max(maxBucket, dist);
-        }
-
-        inline void removeVertex(const Vertex vertex, const int dist) noexcept {
-            if (positionOfVertex[vertex] == -1) return;
-            const Vertex other = buckets[dist].back();
-            positionOfVertex[other] = positionOfVertex[vertex];
-            buckets[dist][positionOfVertex[vertex]] = other;
-            buckets[dist].pop_back();
-            positionOfVertex[vertex] = -1;
-            if (maxBucket == dist && buckets[dist].empty()) {
-                while (maxBucket >= 0 && buckets[maxBucket].empty()) maxBucket--;
-            }
-        }
-
-        inline void increaseBucket(const Vertex vertex, const int oldDist, const int newDist) noexcept {
-            Assert(newDist > oldDist, "Distance has not increased!");
-            Assert(static_cast<size_t>(positionOfVertex[vertex]) < buckets[oldDist].size(), "Vertex is not in bucket!");
-            Assert(buckets[oldDist][positionOfVertex[vertex]] == vertex, "Vertex is not in bucket!");
-            const Vertex other = buckets[oldDist].back();
-            positionOfVertex[other] = positionOfVertex[vertex];
-            buckets[oldDist][positionOfVertex[vertex]] = other;
-            buckets[oldDist].pop_back();
-            positionOfVertex[vertex] = buckets[newDist].size();
-            buckets[newDist].emplace_back(vertex);
-            maxBucket = std::max(maxBucket, newDist);
-        }
-
-        inline bool empty() const noexcept {
-            return maxBucket < 0;
-        }
-
-        inline Vertex front() const noexcept {
-            Assert(!empty(), "Buckets are empty!");
-            return buckets[maxBucket].back();
-        }
-
-        std::vector<std::vector<Vertex>> buckets;
-        std::vector<int> positionOfVertex;
-        int maxBucket;
-    };
-
-    struct OrphanBuckets {
-        OrphanBuckets(const int n) :
-            positionOfVertex_(n, -1), minBucket_(INFTY) {
-        }
-
-        inline void assertVertexInBucket(const Vertex vertex, const int dist) const noexcept {
-            Assert(positionOfVertex_[vertex] != -1, "Vertex is not in bucket!");
-            Assert(static_cast<size_t>(dist) < buckets_.size(), "Vertex is not in bucket!");
-            Assert(static_cast<size_t>(positionOfVertex_[vertex]) < buckets_[dist].size(), "Vertex is not in bucket!");
-            Assert(buckets_[dist][positionOfVertex_[vertex]] == vertex, "Vertex is not in bucket!");
-        }
-
-        inline void addVertex(const Vertex vertex, const int dist) noexcept {
-            if (positionOfVertex_[vertex] != -1) {
-                assertVertexInBucket(vertex, dist);
-                return;
-            }
-            if (static_cast<size_t>(dist) >= buckets_.size()) buckets_.resize(dist + 1);
-            positionOfVertex_[vertex] = buckets_[dist].size();
-            buckets_[dist].emplace_back(vertex);
-            minBucket_ = std::min(minBucket_, dist);
-        }
-
-        inline void decreaseBucket(const Vertex vertex, const int oldDist, const int newDist) noexcept {
-            Assert(newDist < oldDist, "Distance has not decreased!");
-            assertVertexInBucket(vertex, oldDist);
-            const Vertex other = buckets_[oldDist].back();
-            positionOfVertex_[other] = positionOfVertex_[vertex];
-            buckets_[oldDist][positionOfVertex_[vertex]] = other;
-            buckets_[oldDist].pop_back();
-            positionOfVertex_[vertex] = buckets_[newDist].size();
-            buckets_[newDist].emplace_back(vertex);
-            if (static_cast<size_t>(oldDist) == buckets_.size() - 1) {
-                while (!buckets_.empty() && buckets_.back().empty()) buckets_.pop_back();
-            }
-            minBucket_ = std::min(minBucket_, newDist);
-        }
-
-        inline bool empty() const noexcept {
-            return buckets_.empty();
-        }
-
-        inline Vertex pop() noexcept {
-            Assert(!empty(), "Buckets are empty!");
-            const Vertex vertex = buckets_[minBucket_].back();
-            buckets_[minBucket_].pop_back();
-            positionOfVertex_[vertex] = -1;
-            while (static_cast<size_t>(minBucket_) < buckets_.size() && buckets_[minBucket_].empty()) minBucket_++;
-            if (static_cast<size_t>(minBucket_) == buckets_.size()) {
-                buckets_.clear();
-                minBucket_ = INFTY;
-            }
-            return vertex;
-        }
-
-        std::vector<std::vector<Vertex>> buckets_;
-        std::vector<int> positionOfVertex_;
-        int minBucket_;
-    };
-
     struct TreeData {
         TreeData(const size_t n) :
             parentEdge(n, noEdge),
@@ -139,6 +29,14 @@ private:
             prevSibling(n, noVertex) {
         }
 
+        inline void reset(const size_t n) noexcept {
+            parentEdge.assign(n, noEdge);
+            parentVertex.assign(n, noVertex);
+            firstChild.assign(n, noVertex);
+            nextSibling.assign(n, noVertex);
+            prevSibling.assign(n, noVertex);
+        }
+
         inline void addVertex(const Vertex parent, const Vertex child, const Edge edge) noexcept {
             parentEdge[child] = edge;
             parentVertex[child] = parent;
@@ -185,6 +83,10 @@ private:
     struct Cut {
         Cut(const int n) : inSinkComponent(n, false) {}
 
+        inline void reset(const int n) noexcept {
+            inSinkComponent.assign(n, false);
+        }
+
         inline void compute(const std::vector<int>& dist) {
             for (size_t i = 0; i < dist.size(); i++) {
                 inSinkComponent[i] = dist[i] < 0;
@@ -212,9 +114,9 @@ private:
 
 public:
     explicit ExcessesIBFS(const MaxFlowInstance& instance) :
-        instance(instance),
-        graph(instance.graph),
-        n(graph.numVertices()),
+        instance(&instance),
+        graph(&instance.graph),
+        n(graph->numVertices()),
         terminal{instance.source, instance.sink},
         residualCapacity(instance.getCurrentCapacities()),
         distance(n, 0),
@@ -227,6 +129,28 @@ public:
         cut(n) {
     }
 
+    // Re-targets the algorithm to another instance, reusing the memory of earlier runs.
+    inline void reset(const MaxFlowInstance& newInstance) noexcept {
+        instance = &newInstance;
+        graph = &newInstance.graph;
+        n = graph->numVertices();
+        terminal[FORWARD] = newInstance.source;
+        terminal[BACKWARD] = newInstance.sink;
+        residualCapacity = newInstance.getCurrentCapacities();
+        distance.assign(n, 0);
+        excess.assign(n, 0);
+        currentEdge.assign(n, noEdge);
+        treeData.reset(n);
+        for (const int direction : {FORWARD, BACKWARD}) {
+            maxDistance[direction] = 0;
+            Q[direction].clear();
+            nextQ[direction].clear();
+            excessVertices[direction].reset(n);
+            orphans[direction].reset(n);
+        }
+        cut.reset(n);
+    }
+
 public:
     inline void run() noexcept {
         initialize<FORWARD>();
@@ -248,10 +172,10 @@ public:
 
     inline std::vector<Edge> getCutEdges() const noexcept {
         std::vector<Edge> edges;
-        for (const Vertex vertex : graph.vertices()) {
+        for (const Vertex vertex : graph->vertices()) {
             if (cut.inSinkComponent[vertex]) continue;
-            for (const Edge edge : graph.edgesFrom(vertex)) {
-                const Vertex to = graph.get(ToVertex, edge);
+            for (const Edge edge : graph->edgesFrom(vertex)) {
+                const Vertex to = graph->get(ToVertex, edge);
                 if (!cut.inSinkComponent[to]) continue;
                 edges.emplace_back(edge);
             }
@@ -262,13 +186,13 @@ public:
     //TODO: Maintain the flow value throughout the algorithm.
     inline FlowType getFlowValue() const noexcept {
         FlowType flow = 0;
-        for (const Vertex vertex : graph.vertices()) {
+        for (const Vertex vertex : graph->vertices()) {
             if (cut.inSinkComponent[vertex]) continue;
-            for (const Edge edge : graph.edgesFrom(vertex)) {
-                const Vertex to = graph.get(ToVertex, edge);
+            for (const Edge edge : graph->edgesFrom(vertex)) {
+                const Vertex to = graph->get(ToVertex, edge);
                 if (!cut.inSinkComponent[to]) continue;
                 Assert(!isEdgeResidual(edge), "Cut edge is not saturated!");
-                flow += instance.getCapacity(edge);
+                flow += instance->getCapacity(edge);
             }
         }
         return flow;
@@ -280,7 +204,7 @@ private:
         setDistance<DIRECTION>(terminal[DIRECTION], 1);
         addExcess<DIRECTION>(terminal[DIRECTION], -INFTY);
         maxDistance[DIRECTION] = 1;
-        currentEdge[terminal[DIRECTION]] = graph.beginEdgeFrom(terminal[DIRECTION]);
+        currentEdge[terminal[DIRECTION]] = graph->beginEdgeFrom(terminal[DIRECTION]);
         nextQ[DIRECTION].emplace_back(terminal[DIRECTION]);
     }
 
@@ -304,17 +228,17 @@ private:
         for (const Vertex from : Q[DIRECTION]) {
             if (getDistance<DIRECTION>(from) != maxDistance[DIRECTION] - 1) continue;
 
-            Edge edge = graph.beginEdgeFrom(from);
-            while (edge < graph.endEdgeFrom(from)) {
+            Edge edge = graph->beginEdgeFrom(from);
+            while (edge < graph->endEdgeFrom(from)) {
                 const Edge edgeTowardsSink = getForwardEdge<DIRECTION>(edge);
                 if (!isEdgeResidual(edgeTowardsSink)) {
                     edge++;
                     continue;
                 }
-                const Vertex to = graph.get(ToVertex, edge);
+                const Vertex to = graph->get(ToVertex, edge);
                 if (distance[to] == 0) {
                     setDistance<DIRECTION>(to, maxDistance[DIRECTION]);
-                    currentEdge[to] = graph.beginEdgeFrom(to);
+                    currentEdge[to] = graph->beginEdgeFrom(to);
                     treeData.addVertex(from, to, edgeTowardsSink);
                     nextQ[DIRECTION].emplace_back(to);
                 } else if (!isVertexInTree<DIRECTION>(to)) {
@@ -335,7 +259,7 @@ private:
     }
 
     inline void augment(const Vertex sourceEndpoint, const Vertex sinkEndpoint, const Edge edgeTowardsSink) noexcept {
-        const Edge edgeTowardsSource = graph.get(ReverseEdge, edgeTowardsSink);
+        const Edge edgeTowardsSource = graph->get(ReverseEdge, edgeTowardsSink);
         const FlowType flow = findBottleneckCapacity(sourceEndpoint, sinkEndpoint, edgeTowardsSink);
         pushFlow<BACKWARD>(sourceEndpoint, sinkEndpoint, edgeTowardsSink, edgeTowardsSource, flow);
         registerAndDrainExcess<FORWARD>(sourceEndpoint);
@@ -391,7 +315,7 @@ private:
             const Vertex parentVertex = treeData.parentVertex[vertex];
             const Edge edgeTowardsSink = treeData.parentEdge[vertex];
             Assert(isEdgeResidual(edgeTowardsSink), "Tree edge is not residual!");
-            const Edge edgeTowardsSource = graph.get(ReverseEdge, edgeTowardsSink);
+            const Edge edgeTowardsSource = graph->get(ReverseEdge, edgeTowardsSink);
             const FlowType exc = getExcess<DIRECTION>(vertex);
             const FlowType res = residualCapacity[edgeTowardsSink];
             const FlowType flow = std::min(res, exc);
@@ -440,10 +364,10 @@ private:
 
     template<int DIRECTION>
     inline bool adoptWithSameDistance(const Vertex orphan) noexcept {
-        for (Edge edge = currentEdge[orphan]; edge < graph.endEdgeFrom(orphan); edge++) {
+        for (Edge edge = currentEdge[orphan]; edge < graph->endEdgeFrom(orphan); edge++) {
             const Edge edgeTowardsSink = getBackwardEdge<DIRECTION>(edge);
             if (!isEdgeResidual(edgeTowardsSink)) continue;
-            const Vertex from = graph.get(ToVertex, edge);
+            const Vertex from = graph->get(ToVertex, edge);
             if (distance[from] == 0 || !isEdgeAdmissible<DIRECTION>(orphan, from)) continue;
             treeData.addVertex(from, orphan, edgeTowardsSink);
             currentEdge[orphan] = edge;
@@ -459,10 +383,10 @@ private:
         Edge newEdge = noEdge;
         Edge newEdgeTowardsSink = noEdge;
         Vertex newParent = noVertex;
-        for (const Edge edge : graph.edgesFrom(orphan)) {
+        for (const Edge edge : graph->edgesFrom(orphan)) {
             const Edge edgeTowardsSink = getBackwardEdge<DIRECTION>(edge);
             if (!isEdgeResidual(edgeTowardsSink)) continue;
-            const Vertex from = graph.get(ToVertex, edge);
+            const Vertex from = graph->get(ToVertex, edge);
             if (!isVertexInTree<DIRECTION>(from)) continue;
             const int fromDistance = getDistance<DIRECTION>(from);
             if (fromDistance < newDistance) {
@@ -490,7 +414,7 @@ private:
             excessVertices[DIRECTION].removeVertex(orphan, getDistance<DIRECTION>(orphan));
             setDistance<!DIRECTION>(orphan, maxDistance[!DIRECTION]);
             nextQ[!DIRECTION].emplace_back(orphan);
-            currentEdge[orphan] = graph.beginEdgeFrom(orphan);
+            currentEdge[orphan] = graph->beginEdgeFrom(orphan);
         } else {
             distance[orphan] = 0;
         }
@@ -507,7 +431,7 @@ private:
     template<int DIRECTION>
     inline Edge getForwardEdge(const Edge edge) noexcept {
         if (DIRECTION == BACKWARD)
-            return graph.get(ReverseEdge, edge);
+            return graph->get(ReverseEdge, edge);
         else
             return edge;
     }
@@ -515,7 +439,7 @@ private:
     template<int DIRECTION>
     inline Edge getBackwardEdge(const Edge edge) noexcept {
         if (DIRECTION == FORWARD)
-            return graph.get(ReverseEdge, edge);
+            return graph->get(ReverseEdge, edge);
         else
             return edge;
     }
@@ -569,16 +493,14 @@ private:
 
     template<int DIRECTION>
     inline void checkBuckets() const noexcept {
-        for (size_t i = 0; static_cast<int>(i) <= excessVertices[DIRECTION].maxBucket; i++) {
-            for (const Vertex vertex : excessVertices[DIRECTION].buckets[i]) {
-                Assert(hasPositiveExcess<DIRECTION>(vertex), "Vertex in bucket has no excess!");
-                Assert(getDistance<DIRECTION>(vertex) == int(i), "Vertex is in wrong bucket!");
-            }
-        }
+        excessVertices[DIRECTION].forEach([&](const Vertex vertex, const int dist) {
+            Assert(hasPositiveExcess<DIRECTION>(vertex), "Vertex in bucket has no excess!");
+            Assert(getDistance<DIRECTION>(vertex) == dist, "Vertex is in wrong bucket!");
+        });
     }
 
     inline void checkDistanceInvariants(const bool allowOrphans = false) const noexcept {
-        for (const Vertex vertex : graph.vertices()) {
+        for (const Vertex vertex : graph->vertices()) {
             checkDistanceInvariants(vertex, allowOrphans);
         }
     }
@@ -588,7 +510,7 @@ private:
         if (abs(distance[vertex]) <= 1) {
             Ensure(parent == noVertex, "Vertex " << vertex << " with distance <= 1 has parent " << parent << "!");
         } else {
-            if (!graph.isVertex(parent)) {
+            if (!graph->isVertex(parent)) {
                 Ensure(allowOrphans, "Vertex " << vertex << " has an invalid parent!");
             } else {
                 Ensure(abs(distance[vertex]) == abs(distance[parent]) + 1, "Distance of " << vertex << " is " << distance[vertex] << ", but distance of " << parent << " is " << distance[parent] << "!");
@@ -598,12 +520,12 @@ private:
 
     inline void checkChildrenRelation() const noexcept {
         std::vector<std::vector<Vertex>> childrenByParent(n);
-        for (const Vertex vertex : graph.vertices()) {
+        for (const Vertex vertex : graph->vertices()) {
             if (treeData.parentVertex[vertex] != noVertex) {
                 childrenByParent[treeData.parentVertex[vertex]].emplace_back(vertex);
             }
         }
-        for (const Vertex vertex : graph.vertices()) {
+        for (const Vertex vertex : graph->vertices()) {
             std::vector<Vertex> children;
             Vertex child = treeData.firstChild[vertex];
             while (child != noVertex) {
@@ -623,7 +545,7 @@ private:
             isChild[child] = true;
             child = treeData.nextSibling[child];
         }
-        for (const Vertex c : graph.vertices()) {
+        for (const Vertex c : graph->vertices()) {
             const Vertex parent = treeData.parentVertex[c];
             if (isChild[c]) {
                 Ensure(parent == vertex, "Child " << c << " of << " << vertex << " has the wrong parent!");
@@ -634,23 +556,23 @@ private:
     }
 
     inline void checkTreeResidual() const noexcept {
-        for (const Vertex vertex : graph.vertices()) {
+        for (const Vertex vertex : graph->vertices()) {
             if (treeData.parentEdge[vertex] == noEdge) continue;
             Assert(isEdgeResidual(treeData.parentEdge[vertex]), "Tree edge is not residual!");
         }
     }
 
     inline void checkFlowConservation() const noexcept {
-        for (const Vertex vertex : graph.vertices()) {
+        for (const Vertex vertex : graph->vertices()) {
             checkFlowConservation(vertex);
         }
     }
 
     inline FlowType getInflow(const Vertex vertex) const noexcept {
         FlowType inflow = 0;
-        for (const Edge edge : graph.edgesFrom(vertex)) {
-            const Edge reverseEdge = graph.get(ReverseEdge, edge);
-            inflow += instance.getCapacity(reverseEdge) - residualCapacity[reverseEdge];
+        for (const Edge edge : graph->edgesFrom(vertex)) {
+            const Edge reverseEdge = graph->get(ReverseEdge, edge);
+            inflow += instance->getCapacity(reverseEdge) - residualCapacity[reverseEdge];
         }
         return inflow;
     }
@@ -661,24 +583,24 @@ private:
     }
 
     inline void checkCapacityConstraints() const noexcept {
-        for (const Edge edge : graph.edges()) {
+        for (const Edge edge : graph->edges()) {
             Assert(residualCapacity[edge] >= 0, "Capacity constraint violated!");
         }
     }
 
     template<int DIRECTION>
     inline void checkQueue() noexcept {
-        for (const Vertex vertex : graph.vertices()) {
+        for (const Vertex vertex : graph->vertices()) {
             if (getDistance<DIRECTION>(vertex) != maxDistance[DIRECTION]) continue;
             Assert(Vector::contains(Q[DIRECTION], vertex), "Vertex missing from queue");
         }
     }
 
 private:
-    const MaxFlowInstance& instance;
-    const GraphType& graph;
-    const int n;
-    const Vertex terminal[2];
+    const MaxFlowInstance* instance;
+    const GraphType* graph;
+    int n;
+    Vertex terminal[2];
     std::vector<FlowType> residualCapacity;
     // positive for s-vertices, negative for t-vertices, 0 for n-vertices
     std::vector<int> distance;
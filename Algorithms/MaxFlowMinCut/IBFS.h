@@ -4,6 +4,7 @@
 #include <vector>
 
 #include "../../DataStructures/Graph/Graph.h"
+#include "../../DataStructures/MaxFlowMinCut/DistanceBuckets.h"
 #include "../../DataStructures/MaxFlowMinCut/MaxFlowInstance.h"
 
 #include "../../Helpers/Assert.h"
@@ -27,6 +28,14 @@ private:
             prevSibling(n, noVertex) {
         }
 
+        inline void reset(const size_t n) noexcept {
+            parentEdge.assign(n, noEdge);
+            parentVertex.assign(n, noVertex);
+            firstChild.assign(n, noVertex);
+            nextSibling.assign(n, noVertex);
+            prevSibling.assign(n, noVertex);
+        }
+
         inline void addVertex(const Vertex parent, const Vertex child, const Edge edge) noexcept {
             parentEdge[child] = edge;
             parentVertex[child] = parent;
@@ -69,78 +78,13 @@ private:
         std::vector<Vertex> prevSibling;
     };
 
-    struct OrphanBuckets {
-        OrphanBuckets(const int n) :
-            positionOfVertex_(n, -1), minBucket_(INFTY) {
-        }
-
-        inline void assertVertexInBucket(const Vertex vertex, const int dist) const noexcept {
-            Assert(positionOfVertex_[vertex] != -1, "Vertex is not in bucket!");
-            Assert(static_cast<size_t>(dist) < buckets_.size(), "Vertex is not in bucket!");
-            Assert(static_cast<size_t>(positionOfVertex_[vertex]) < buckets_[dist].size(), "Vertex is not in bucket!");
-            Assert(buckets_[dist][positionOfVertex_[vertex]] == vertex, "Vertex is not in bucket!");
-        }
-
-        inline bool contains(const Vertex vertex) const noexcept {
-            return positionOfVertex_[vertex] != -1;
-        }
-
-        inline void addVertex(const Vertex vertex, const int dist) noexcept {
-            if (positionOfVertex_[vertex] != -1) {
-                assertVertexInBucket(vertex, dist);
-                return;
-            }
-            if (static_cast<size_t>(dist) >= buckets_.size()) buckets_.resize(dist + 1);
-            positionOfVertex_[vertex] = buckets_[dist].size();
-            buckets_[dist].emplace_back(vertex);
-            minBucket_ = std::min(minBucket_, dist);
-        }
-
-        inline void decreaseBucket(const Vertex vertex, const int oldDist, const int newDist) noexcept {
-            Assert(newDist < oldDist, "Distance has not decreased!");
-            assertVertexInBucket(vertex, oldDist);
-            const Vertex other = buckets_[oldDist].back();
-            positionOfVertex_[other] = positionOfVertex_[vertex];
-            buckets_[oldDist][positionOfVertex_[vertex]] = other;
-            buckets_[oldDist].pop_back();
-            positionOfVertex_[vertex] = buckets_[newDist].size();
-            buckets_[newDist].emplace_back(vertex);
-            if (static_cast<size_t>(oldDist) == buckets_.size() - 1) {
-                while (!buckets_.empty() && buckets_.back().empty()) buckets_.pop_back();
-            }
-            minBucket_ = std::min(minBucket_, newDist);
-        }
-
-        inline bool empty() const noexcept {
-            return buckets_.empty();
-        }
-
-        inline Vertex front() noexcept {
-            Assert(!empty(), "Buckets are empty!");
-            return buckets_[minBucket_].back();
-        }
-
-        inline Vertex pop() noexcept {
-            Assert(!empty(), "Buckets are empty!");
-            const Vertex vertex = buckets_[minBucket_].back();
-            buckets_[minBucket_].pop_back();
-            positionOfVertex_[vertex] = -1;
-            while (static_cast<size_t>(minBucket_) < buckets_.size() && buckets_[minBucket_].empty()) minBucket_++;
-            if (static_cast<size_t>(minBucket_) == buckets_.size()) {
-                buckets_.clear();
-                minBucket_ = INFTY;
-            }
-            return vertex;
-        }
-
-        std::vector<std::vector<Vertex>> buckets_;
-        std::vector<int> positionOfVertex_;
-        int minBucket_;
-    };
-
     struct Cut {
         Cut(const int n) : inSinkComponent(n, false) {}
 
+        inline void reset(const int n) noexcept {
+            inSinkComponent.assign(n, false);
+        }
+
         inline void compute(const std::vector<int>& dist) {
             for (size_t i = 0; i < dist.size(); i++) {
                 inSinkComponent[i] = (dist[i] < 0);
@@ -168,9 +112,9 @@ private:
 
 public:
     explicit IBFS(const MaxFlowInstance& instance) :
-        instance(instance),
-        graph(instance.graph),
-        n(graph.numVertices()),
+        instance(&instance),
+        graph(&instance.graph),
+        n(graph->numVertices()),
         terminal{instance.source, instance.sink},
         residualCapacity(instance.getCurrentCapacities()),
         distance(n, 0),
@@ -187,6 +131,32 @@ public:
         cut(n) {
     }
 
+    // Re-targets the algorithm to another instance, reusing the memory of earlier runs.
+    inline void reset(const MaxFlowInstance& newInstance) noexcept {
+        instance = &newInstance;
+        graph = &newInstance.graph;
+        n = graph->numVertices();
+        terminal[FORWARD] = newInstance.source;
+        terminal[BACKWARD] = newInstance.sink;
+        residualCapacity = newInstance.getCurrentCapacities();
+        distance.assign(n, 0);
+        currentEdge.assign(n, noEdge);
+        treeData.reset(n);
+        for (const int direction : {FORWARD, BACKWARD}) {
+            maxDistance[direction] = 0;
+            Q[direction] = std::queue<Vertex>();
+            nextQ[direction] = std::queue<Vertex>();
+            orphans[direction].reset(n);
+            threePassOrphans[direction].reset(n);
+        }
+        processedOrphans_ = 0;
+        processedUniqueOrphans_ = 0;
+        orphanTimestamp_.assign(n, 0);
+        currentTimestamp_ = 0;
+        threePass_ = false;
+        cut.reset(n);
+    }
+
 public:
     inline void run() noexcept {
         initialize<FORWARD>();
@@ -225,10 +195,10 @@ public:
 
     [[nodiscard]] inline std::vector<Edge> getCutEdges() const noexcept {
         std::vector<Edge> edges;
-        for (const Vertex vertex : graph.vertices()) {
+        for (const Vertex vertex : graph->vertices()) {
             if (cut.inSinkComponent[vertex]) continue;
-            for (const Edge edge : graph.edgesFrom(vertex)) {
-                const Vertex to = graph.get(ToVertex, edge);
+            for (const Edge edge : graph->edgesFrom(vertex)) {
+                const Vertex to = graph->get(ToVertex, edge);
                 if (!cut.inSinkComponent[to]) continue;
                 edges.emplace_back(edge);
             }
@@ -238,9 +208,9 @@ public:
 
     inline FlowType getFlowValue() const noexcept {
         FlowType flow = 0;
-        for (const Edge edge : graph.edgesFrom(terminal[BACKWARD])) {
-            const Edge reverseEdge = graph.get(ReverseEdge, edge);
-            flow += instance.getCapacity(reverseEdge) - residualCapacity[reverseEdge];
+        for (const Edge edge : graph->edgesFrom(terminal[BACKWARD])) {
+            const Edge reverseEdge = graph->get(ReverseEdge, edge);
+            flow += instance->getCapacity(reverseEdge) - residualCapacity[reverseEdge];
         }
         return flow;
     }
@@ -262,7 +232,7 @@ private:
     inline void initialize() noexcept {
         setDistance<DIRECTION>(terminal[DIRECTION], 1);
         maxDistance[DIRECTION] = 1;
-        currentEdge[terminal[DIRECTION]] = graph.beginEdgeFrom(terminal[DIRECTION]);
+        currentEdge[terminal[DIRECTION]] = graph->beginEdgeFrom(terminal[DIRECTION]);
         nextQ[DIRECTION].push(terminal[DIRECTION]);
     }
 
@@ -286,17 +256,17 @@ private:
             Q[DIRECTION].pop();
             if (getDistance<DIRECTION>(from) != maxDistance[DIRECTION] - 1) continue;
 
-            Edge edge = graph.beginEdgeFrom(from);
-            while (edge < graph.endEdgeFrom(from)) {
+            Edge edge = graph->beginEdgeFrom(from);
+            while (edge < graph->endEdgeFrom(from)) {
                 const Edge edgeTowardsSink = getForwardEdge<DIRECTION>(edge);
                 if (!isEdgeResidual(edgeTowardsSink)) {
                     edge++;
                     continue;
                 }
-                const Vertex to = graph.get(ToVertex, edge);
+                const Vertex to = graph->get(ToVertex, edge);
                 if (distance[to] == 0) {
                     setDistance<DIRECTION>(to, maxDistance[DIRECTION]);
-                    currentEdge[to] = graph.beginEdgeFrom(to);
+                    currentEdge[to] = graph->beginEdgeFrom(to);
                     treeData.addVertex(from, to, edgeTowardsSink);
                     nextQ[DIRECTION].push(to);
                 } else if (!isVertexInTree<DIRECTION>(to)) {
@@ -337,7 +307,7 @@ private:
     }
 
     inline void augmentPath(const Vertex sourceEndpoint, const Vertex sinkEndpoint, const Edge edgeTowardsSink, const FlowType flow) noexcept {
-        const Edge edgeTowardsSource = graph.get(ReverseEdge, edgeTowardsSink);
+        const Edge edgeTowardsSource = graph->get(ReverseEdge, edgeTowardsSink);
         residualCapacity[edgeTowardsSink] -= flow;
         residualCapacity[edgeTowardsSource] += flow;
         augmentPath<FORWARD>(sourceEndpoint, flow);
@@ -348,7 +318,7 @@ private:
     inline void augmentPath(Vertex vertex, const FlowType flow) noexcept {
         while (vertex != terminal[DIRECTION]) {
             const Edge edgeTowardsSink = treeData.parentEdge[vertex];
-            const Edge edgeTowardsSource = graph.get(ReverseEdge, edgeTowardsSink);
+            const Edge edgeTowardsSource = graph->get(ReverseEdge, edgeTowardsSink);
             const Vertex parentVertex = treeData.parentVertex[vertex];
             residualCapacity[edgeTowardsSink] -= flow;
             residualCapacity[edgeTowardsSource] += flow;
@@ -455,10 +425,10 @@ private:
         Edge newEdge = noEdge;
         Edge newEdgeTowardsSink = noEdge;
         Vertex newParent = noVertex;
-        for (const Edge edge : graph.edgesFrom(orphan)) {
+        for (const Edge edge : graph->edgesFrom(orphan)) {
             const Edge edgeTowardsSink = getBackwardEdge<DIRECTION>(edge);
             if (!isEdgeResidual(edgeTowardsSink)) continue;
-            const Vertex from = graph.get(ToVertex, edge);
+            const Vertex from = graph->get(ToVertex, edge);
             if (!isVertexInTree<DIRECTION>(from)) continue;
             if (treeData.parentEdge[from] == noEdge) continue;
             const int fromDistance = getDistance<DIRECTION>(from);
@@ -484,10 +454,10 @@ private:
 
     template<int DIRECTION>
     inline void adoptOrphansThirdPass(const Vertex vertex) noexcept {
-        for (const Edge edge : graph.edgesFrom(vertex)) {
+        for (const Edge edge : graph->edgesFrom(vertex)) {
             const Edge edgeTowardsSink = getBackwardEdge<DIRECTION>(edge);
             if (!isEdgeResidual(edgeTowardsSink)) continue;
-            const Vertex from = graph.get(ToVertex, edge);
+            const Vertex from = graph->get(ToVertex, edge);
             if (!isEdgeAdmissible<DIRECTION>(vertex, from)) continue;
             if (treeData.parentEdge[from] == noEdge) continue;
             const int dist = getDistance<DIRECTION>(vertex);
@@ -501,8 +471,8 @@ private:
 
         //Don't try to adopt children beyond maxDistance. This will be done in the growth steps.
         if (getDistance<DIRECTION>(vertex) == maxDistance[DIRECTION]) return;
-        for (const Edge edge : graph.edgesFrom(vertex)) {
-            const Vertex from = graph.get(ToVertex, edge);
+        for (const Edge edge : graph->edgesFrom(vertex)) {
+            const Vertex from = graph->get(ToVertex, edge);
             if (from == terminal[DIRECTION] || isVertexInTree<!DIRECTION>(from)) continue;
             const bool isFree = treeData.parentEdge[from] == noEdge;
             const int fromDist = getDistance<DIRECTION>(from);
@@ -531,10 +501,10 @@ private:
 
     template<int DIRECTION>
     inline bool adoptWithSameDistance(const Vertex orphan) noexcept {
-        for (Edge edge = currentEdge[orphan]; edge < graph.endEdgeFrom(orphan); edge++) {
+        for (Edge edge = currentEdge[orphan]; edge < graph->endEdgeFrom(orphan); edge++) {
             const Edge edgeTowardsSink = getBackwardEdge<DIRECTION>(edge);
             if (!isEdgeResidual(edgeTowardsSink)) continue;
-            const Vertex from = graph.get(ToVertex, edge);
+            const Vertex from = graph->get(ToVertex, edge);
             if (!isEdgeAdmissible<DIRECTION>(orphan, from)) continue;
             treeData.addVertex(from, orphan, edgeTowardsSink);
             currentEdge[orphan] = edge;
@@ -550,10 +520,10 @@ private:
         Edge newEdge = noEdge;
         Edge newEdgeTowardsSink = noEdge;
         Vertex newParent = noVertex;
-        for (const Edge edge : graph.edgesFrom(orphan)) {
+        for (const Edge edge : graph->edgesFrom(orphan)) {
             const Edge edgeTowardsSink = getBackwardEdge<DIRECTION>(edge);
             if (!isEdgeResidual(edgeTowardsSink)) continue;
-            const Vertex from = graph.get(ToVertex, edge);
+            const Vertex from = graph->get(ToVertex, edge);
             if (!isVertexInTree<DIRECTION>(from)) continue;
             const int fromDistance = getDistance<DIRECTION>(from);
             if (fromDistance < newDistance) {
@@ -576,7 +546,7 @@ private:
     template<int DIRECTION>
     inline Edge getForwardEdge(const Edge edge) noexcept {
         if (DIRECTION == BACKWARD)
-            return graph.get(ReverseEdge, edge);
+            return graph->get(ReverseEdge, edge);
         else
             return edge;
     }
@@ -584,7 +554,7 @@ private:
     template<int DIRECTION>
     inline Edge getBackwardEdge(const Edge edge) noexcept {
         if (DIRECTION == FORWARD)
-            return graph.get(ReverseEdge, edge);
+            return graph->get(ReverseEdge, edge);
         else
             return edge;
     }
@@ -614,7 +584,7 @@ private:
     }
 
     inline void checkDistanceInvariants(const bool allowOrphans = false) const noexcept {
-        for (const Vertex vertex : graph.vertices()) {
+        for (const Vertex vertex : graph->vertices()) {
             checkDistanceInvariants(vertex, allowOrphans);
         }
     }
@@ -624,7 +594,7 @@ private:
         if (abs(distance[vertex]) <= 1) {
             Ensure(parent == noVertex, "Vertex " << vertex << " with distance <= 1 has parent " << parent << "!");
         } else {
-            if (!graph.isVertex(parent)) {
+            if (!graph->isVertex(parent)) {
                 Ensure(allowOrphans, "Vertex " << vertex << " has an invalid parent!");
             } else {
                 Ensure(abs(distance[vertex]) == abs(distance[parent]) + 1, "Distance of " << vertex << " is " << distance[vertex] << ", but distance of " << parent << " is " << distance[parent] << "!");
@@ -633,7 +603,7 @@ private:
     }
 
     inline void checkChildrenRelation() const noexcept {
-        for (const Vertex vertex : graph.vertices()) {
+        for (const Vertex vertex : graph->vertices()) {
             checkChildrenRelation(vertex);
         }
     }
@@ -645,7 +615,7 @@ private:
             isChild[child] = true;
             child = treeData.nextSibling[child];
         }
-        for (const Vertex c : graph.vertices()) {
+        for (const Vertex c : graph->vertices()) {
             const Vertex parent = treeData.parentVertex[c];
             if (isChild[c]) {
                 Ensure(parent == vertex, "Child " << c << " of << " << vertex << " has the wrong parent!");
@@ -656,10 +626,10 @@ private:
     }
 
 private:
-    const MaxFlowInstance& instance;
-    const GraphType& graph;
-    const int n;
-    const Vertex terminal[2];
+    const MaxFlowInstance* instance;
+    const GraphType* graph;
+    int n;
+    Vertex terminal[2];
     std::vector<FlowType> residualCapacity;
     std::vector<int> distance; // 1 for source, -1 for sink, 0 for n-vertices
     int maxDistance[2];
@@ -0,0 +1,359 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+#include <omp.h>
+
+#include "ParallelResidualBFS.h"
+
+#include "../../DataStructures/Graph/Graph.h"
+#include "../../DataStructures/MaxFlowMinCut/MaxFlowInstance.h"
+
+#include "../../Helpers/Assert.h"
+#include "../../Helpers/Timer.h"
+#include "../../Helpers/Types.h"
+
+/**
+ * Synchronous parallel push-relabel. Every round discharges all active vertices at once, against the distance labels
+ * from the start of the round, in three phases:
+ * 1. Every active vertex pushes along its admissible edges. Since an edge and its reverse cannot both be admissible,
+ *    every residual capacity is written by a single thread. Flow that arrives at a vertex is collected atomically in
+ *    a separate excess, so that the vertex can push its own excess in the meantime.
+ * 2. Every active vertex with remaining excess is relabeled. Residual capacities do not change in this phase, and the
+ *    new labels are only computed from the old ones, so they do not depend on the order in which neighbouring vertices
+ *    are relabeled.
+ * 3. The new labels and the collected excesses are applied, which yields the active vertices of the next round.
+ * Global relabeling is a ParallelResidualBFS from the sink over the reverse residual edges.
+ * Like PushRelabel, this computes a maximum preflow, which determines the minimum cut. The sink component is returned
+ * together with a BFS tree towards the sink, as by IBFS, so that this can provide the initial flow of ParametricIBFS.
+ */
+template<typename MAX_FLOW_INSTANCE, bool MEASUREMENTS = false>
+class ParallelPushRelabel {
+
+public:
+    using MaxFlowInstance = MAX_FLOW_INSTANCE;
+    using FlowType = MaxFlowInstance::FlowType;
+    using GraphType = MaxFlowInstance::GraphType;
+
+private:
+    inline static constexpr int VertexToEdgeRatio = 12;
+    // Rounds with fewer vertices are processed by the calling thread.
+    inline static constexpr size_t ParallelRoundThreshold = 256;
+
+public:
+    explicit ParallelPushRelabel(const MaxFlowInstance& instance, const size_t numThreads = omp_get_max_threads()) :
+        numThreads(std::max<size_t>(numThreads, 1)),
+        verticesOfThread(this->numThreads),
+        workOfThread(this->numThreads, 0),
+        bfs(this->numThreads) {
+        reset(instance);
+    }
+
+    // Re-targets the algorithm to another instance, reusing the memory of earlier runs.
+    inline void reset(const MaxFlowInstance& newInstance) noexcept {
+        instance = &newInstance;
+        graph = &newInstance.graph;
+        n = graph->numVertices();
+        sourceVertex = newInstance.source;
+        sinkVertex = newInstance.sink;
+        residualCapacity = newInstance.getCurrentCapacities();
+        distance.assign(n, 0);
+        nextDistance.assign(n, 0);
+        excess.assign(n, 0);
+        addedExcess.assign(n, 0);
+        isActive.assign(n, 0);
+        currentEdge.resize(n);
+        for (const Vertex vertex : graph->vertices()) {
+            currentEdge[vertex] = graph->beginEdgeFrom(vertex);
+        }
+        activeVertices.clear();
+        workSinceLastUpdate = 0;
+        workLimit = VertexToEdgeRatio * graph->numVertices() + graph->numEdges();
+        inSinkComponent.assign(n, false);
+        parentVertex.assign(n, noVertex);
+        parentEdge.assign(n, noEdge);
+    }
+
+public:
+    inline void run() noexcept {
+        if constexpr (MEASUREMENTS) timer.restart();
+        initialize();
+        globalRelabel();
+        while (!activeVertices.empty()) {
+            runRound();
+            if (workSinceLastUpdate > workLimit) {
+                globalRelabel();
+                workSinceLastUpdate = 0;
+            }
+        }
+        computeCut();
+        if constexpr (MEASUREMENTS) flowTime += timer.elapsedMicroseconds();
+    }
+
+    inline std::vector<Vertex> getSourceComponent() const noexcept {
+        std::vector<Vertex> component;
+        for (const Vertex vertex : graph->vertices()) {
+            if (!inSinkComponent[vertex]) component.emplace_back(vertex);
+        }
+        return component;
+    }
+
+    inline std::vector<Vertex> getSinkComponent() const noexcept {
+        std::vector<Vertex> component;
+        for (const Vertex vertex : graph->vertices()) {
+            if (inSinkComponent[vertex]) component.emplace_back(vertex);
+        }
+        return component;
+    }
+
+    inline const std::vector<bool>& getInSinkComponent() const noexcept {
+        return inSinkComponent;
+    }
+
+    inline bool isInSinkComponent(const Vertex vertex) const noexcept {
+        return inSinkComponent[vertex];
+    }
+
+    inline uint getSinkComponentDistance(const Vertex vertex) const noexcept {
+        return distance[vertex];
+    }
+
+    inline Vertex getParentVertex(const Vertex vertex) const noexcept {
+        return parentVertex[vertex];
+    }
+
+    inline Edge getParentEdge(const Vertex vertex) const noexcept {
+        return parentEdge[vertex];
+    }
+
+    inline std::vector<Edge> getCutEdges() const noexcept {
+        std::vector<Edge> edges;
+        for (const Vertex vertex : graph->vertices()) {
+            if (inSinkComponent[vertex]) continue;
+            for (const Edge edge : graph->edgesFrom(vertex)) {
+                const Vertex to = graph->get(ToVertex, edge);
+                if (!inSinkComponent[to]) continue;
+                edges.emplace_back(edge);
+            }
+        }
+        return edges;
+    }
+
+    inline FlowType getFlowValue() const noexcept {
+        FlowType flow = 0;
+        for (const Edge edge : graph->edgesFrom(sinkVertex)) {
+            const Edge reverseEdge = graph->get(ReverseEdge, edge);
+            flow += instance->getCapacity(reverseEdge) - residualCapacity[reverseEdge];
+        }
+        return flow;
+    }
+
+    inline const std::vector<FlowType>& getResidualCapacities() const noexcept {
+        return residualCapacity;
+    }
+
+    inline std::vector<FlowType> getCleanResidualCapacities() const noexcept {
+        std::vector<FlowType> result = getResidualCapacities();
+        for (size_t i = 0; i < result.size(); i++) {
+            if (result[i] > INFTY - 1000) result[i] = INFTY;
+        }
+        return result;
+    }
+
+    inline double getFlowTime() const noexcept {
+        return flowTime;
+    }
+
+    inline size_t getNumRounds() const noexcept {
+        return numRounds;
+    }
+
+    inline size_t getNumGlobalRelabels() const noexcept {
+        return numGlobalRelabels;
+    }
+
+private:
+    inline void initialize() noexcept {
+        for (const Edge edge : graph->edgesFrom(sourceVertex)) {
+            const FlowType capacity = instance->getCapacity(edge);
+            if (capacity == 0) continue;
+            const Edge reverseEdge = graph->get(ReverseEdge, edge);
+            residualCapacity[edge] = 0;
+            residualCapacity[reverseEdge] += capacity;
+            excess[graph->get(ToVertex, edge)] += capacity;
+        }
+    }
+
+    inline void runRound() noexcept {
+        if constexpr (MEASUREMENTS) numRounds++;
+        const size_t numActiveVertices = activeVertices.size();
+        forEach(numActiveVertices, [&](const size_t i, const int thread) {
+            pushExcess(activeVertices[i], verticesOfThread[thread]);
+        });
+        for (std::vector<Vertex>& activated : verticesOfThread) {
+            activeVertices.insert(activeVertices.end(), activated.begin(), activated.end());
+            activated.clear();
+        }
+        std::fill(workOfThread.begin(), workOfThread.end(), 0);
+        forEach(numActiveVertices, [&](const size_t i, const int thread) {
+            const Vertex vertex = activeVertices[i];
+            nextDistance[vertex] = distance[vertex];
+            if (pmf::isNumberPositive(excess[vertex])) workOfThread[thread] += relabel(vertex);
+        });
+        for (const int work : workOfThread) {
+            workSinceLastUpdate += work;
+        }
+        forEach(activeVertices.size(), [&](const size_t i, const int thread) {
+            const Vertex vertex = activeVertices[i];
+            if (i < numActiveVertices) distance[vertex] = nextDistance[vertex];
+            excess[vertex] += addedExcess[vertex];
+            addedExcess[vertex] = 0;
+            isActive[vertex] = distance[vertex] < n && pmf::isNumberPositive(excess[vertex]);
+            if (isActive[vertex]) verticesOfThread[thread].emplace_back(vertex);
+        });
+        collectActiveVertices();
+    }
+
+    // Pushes along the admissible edges of vertex, until its excess is gone or no admissible edge is left.
+    // Vertices that receive their first excess of the round are added to activated.
+    inline void pushExcess(const Vertex vertex, std::vector<Vertex>& activated) noexcept {
+        for (Edge edge = currentEdge[vertex]; edge < graph->endEdgeFrom(vertex); edge++) {
+            const Vertex to = graph->get(ToVertex, edge);
+            if (distance[to] != distance[vertex] - 1 || !isEdgeResidual(edge)) continue;
+            const FlowType flow = std::min(excess[vertex], residualCapacity[edge]);
+            residualCapacity[edge] -= flow;
+            residualCapacity[graph->get(ReverseEdge, edge)] += flow;
+            excess[vertex] -= flow;
+            if (to != sinkVertex) {
+                std::atomic_ref<FlowType>(addedExcess[to]).fetch_add(flow, std::memory_order_relaxed);
+                if (std::atomic_ref<uint8_t>(isActive[to]).exchange(1, std::memory_order_relaxed) == 0) activated.emplace_back(to);
+            }
+            if (!pmf::isNumberPositive(excess[vertex])) {
+                currentEdge[vertex] = edge;
+                return;
+            }
+        }
+        currentEdge[vertex] = graph->endEdgeFrom(vertex);
+    }
+
+    // Computes the new label of vertex from the labels of the last round. Returns the work spent.
+    inline int relabel(const Vertex vertex) noexcept {
+        int newDistance = n;
+        Edge newAdmissibleEdge = graph->beginEdgeFrom(vertex);
+        for (const Edge edge : graph->edgesFrom(vertex)) {
+            if (!isEdgeResidual(edge)) continue;
+            const Vertex to = graph->get(ToVertex, edge);
+            if (distance[to] + 1 < newDistance) {
+                newDistance = distance[to] + 1;
+                newAdmissibleEdge = edge;
+            }
+        }
+        Assert(newDistance > distance[vertex], "Relabel did not increase the distance!");
+        nextDistance[vertex] = newDistance;
+        currentEdge[vertex] = newAdmissibleEdge;
+        return VertexToEdgeRatio + graph->outDegree(vertex);
+    }
+
+    inline void globalRelabel() noexcept {
+        if constexpr (MEASUREMENTS) numGlobalRelabels++;
+        computeSinkDistances();
+        forEach(n, [&](const size_t i, const int thread) {
+            const Vertex vertex(i);
+            currentEdge[vertex] = graph->beginEdgeFrom(vertex);
+            isActive[vertex] = vertex != sourceVertex && vertex != sinkVertex && distance[vertex] < n && pmf::isNumberPositive(excess[vertex]);
+            if (isActive[vertex]) verticesOfThread[thread].emplace_back(vertex);
+        });
+        collectActiveVertices();
+    }
+
+    inline void collectActiveVertices() noexcept {
+        activeVertices.clear();
+        for (std::vector<Vertex>& active : verticesOfThread) {
+            activeVertices.insert(activeVertices.end(), active.begin(), active.end());
+            active.clear();
+        }
+    }
+
+    // Sets the distance of every vertex to its number of residual edges from the sink, or to n if it cannot reach it.
+    inline void computeSinkDistances() noexcept {
+        bfs.run(*graph, sinkVertex, distance, n, [&](const Vertex from, const Edge edge) {
+            return from != sourceVertex && isEdgeResidual(edge);
+        });
+    }
+
+    // The sink component consists of the vertices that can still reach the sink. Every vertex in it gets the first
+    // residual edge towards the previous BFS level as its parent edge, so the tree does not depend on the thread timing.
+    inline void computeCut() noexcept {
+        computeSinkDistances();
+        forEach(n, [&](const size_t i, const int) {
+            const Vertex vertex(i);
+            parentVertex[vertex] = noVertex;
+            parentEdge[vertex] = noEdge;
+            if (vertex == sinkVertex || distance[vertex] == n) return;
+            for (const Edge edge : graph->edgesFrom(vertex)) {
+                const Vertex to = graph->get(ToVertex, edge);
+                if (!isEdgeResidual(edge) || distance[to] != distance[vertex] - 1) continue;
+                parentVertex[vertex] = to;
+                parentEdge[vertex] = edge;
+                break;
+            }
+        });
+        for (const Vertex vertex : graph->vertices()) {
+            inSinkComponent[vertex] = distance[vertex] < n;
+        }
+        Assert(!inSinkComponent[sourceVertex], "No cut found!");
+    }
+
+    // Calls function(i, thread) for all i below size, in parallel if size is large enough. Entries are handed out in
+    // chunks, so that vertices of different degrees are balanced between the threads.
+    template<typename FUNCTION>
+    inline void forEach(const size_t size, const FUNCTION& function) const noexcept {
+        if (size < ParallelRoundThreshold || numThreads == 1) {
+            for (size_t i = 0; i < size; i++) {
+                function(i, 0);
+            }
+            return;
+        }
+        #pragma omp parallel for num_threads(numThreads) schedule(dynamic, 64)
+        for (size_t i = 0; i < size; i++) {
+            function(i, omp_get_thread_num());
+        }
+    }
+
+    inline bool isEdgeResidual(const Edge edge) const noexcept {
+        return pmf::isNumberPositive(residualCapacity[edge]);
+    }
+
+private:
+    const MaxFlowInstance* instance;
+    const GraphType* graph;
+    int n;
+    Vertex sourceVertex;
+    Vertex sinkVertex;
+    const size_t numThreads;
+    std::vector<FlowType> residualCapacity;
+    std::vector<int> distance;
+    std::vector<int> nextDistance;
+    std::vector<FlowType> excess;
+    // Flow that arrived at a vertex during the current round.
+    std::vector<FlowType> addedExcess;
+    std::vector<uint8_t> isActive;
+    std::vector<Edge> currentEdge;
+    std::vector<Vertex> activeVertices;
+    std::vector<std::vector<Vertex>> verticesOfThread;
+    std::vector<int> workOfThread;
+    ParallelResidualBFS<GraphType> bfs;
+    int workSinceLastUpdate;
+    int workLimit;
+    std::vector<bool> inSinkComponent;
+    std::vector<Vertex> parentVertex;
+    std::vector<Edge> parentEdge;
+
+    double flowTime = 0;
+    size_t numRounds = 0;
+    size_t numGlobalRelabels = 0;
+    Timer timer;
+};
@@ -0,0 +1,167 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+#include <omp.h>
+
+#include "../../DataStructures/Graph/Graph.h"
+
+#include "../../Helpers/Types.h"
+
+/**
+ * Level-synchronous parallel BFS towards a target vertex, as used for global relabeling and cut extraction.
+ * Every level is expanded in one of two directions, as proposed by Beamer et al.:
+ * - Top-down: every frontier vertex scans its edges and claims the unreached vertices that can use the reverse edge.
+ *   Claims are made with an atomic compare-and-swap on the distance label.
+ * - Bottom-up: every unreached vertex scans its own edges until it finds one into the frontier, which is kept as a
+ *   bitmap. Every vertex is written by the thread that scans it, so no atomics are needed, and the scan stops early.
+ * Bottom-up is chosen while the frontier is large compared to the unreached part of the graph. The distances
+ * are those of a sequential BFS, independently of the number of threads.
+ */
+template<typename GRAPH>
+class ParallelResidualBFS {
+public:
+    using GraphType = GRAPH;
+
+private:
+    // Levels with fewer vertices are expanded by the calling thread.
+    inline static constexpr size_t ParallelLevelThreshold = 256;
+    // Switch to bottom-up once the frontier has more than 1/Alpha of the unexplored edges, and back to top-down once
+    // it has fewer than 1/Beta of the vertices. Unlike in a plain BFS, large parts of the residual graph are usually
+    // unreachable, and every bottom-up level scans them. So a frontier that only has many edges, like the sink with
+    // its terminal edges, must also have 1/Beta of the vertices. A single thread always expands top-down, which is as
+    // fast as a queue-based BFS then.
+    inline static constexpr size_t Alpha = 14;
+    inline static constexpr size_t Beta = 24;
+
+public:
+    explicit ParallelResidualBFS(const size_t numThreads = omp_get_max_threads()) :
+        numThreads(std::max<size_t>(numThreads, 1)),
+        verticesOfThread(this->numThreads),
+        edgesOfThread(this->numThreads, 0) {
+    }
+
+    // Sets distance[v] to the number of edges on a shortest path from v to target, or to unreached if there is none.
+    // A path may use an edge from v only if canUse(v, edge) holds.
+    template<typename CAN_USE>
+    inline void run(const GraphType& graph, const Vertex target, std::vector<int>& distance, const int unreached, const CAN_USE& canUse) noexcept {
+        const size_t n = graph.numVertices();
+        distance.resize(n);
+        forEach(n, [&](const size_t i, const int) {
+            distance[i] = unreached;
+        });
+        distance[target] = 0;
+        frontier.assign(1, target);
+        size_t frontierEdges = graph.outDegree(target);
+        size_t unexploredEdges = graph.numEdges() - frontierEdges;
+        bool bottomUp = false;
+        for (int level = 1; !frontier.empty(); level++) {
+            if (!bottomUp && numThreads > 1 && frontierEdges > unexploredEdges / Alpha && frontier.size() >= n / Beta) {
+                bottomUp = true;
+            } else if (bottomUp && frontier.size() < n / Beta) {
+                bottomUp = false;
+            }
+            if (bottomUp) {
+                expandBottomUp(graph, distance, unreached, level, canUse);
+            } else {
+                expandTopDown(graph, distance, unreached, level, canUse);
+            }
+            frontier.clear();
+            frontierEdges = 0;
+            for (size_t thread = 0; thread < numThreads; thread++) {
+                frontier.insert(frontier.end(), verticesOfThread[thread].begin(), verticesOfThread[thread].end());
+                verticesOfThread[thread].clear();
+                frontierEdges += edgesOfThread[thread];
+                edgesOfThread[thread] = 0;
+            }
+            unexploredEdges -= std::min(unexploredEdges, frontierEdges);
+        }
+    }
+
+private:
+    template<typename CAN_USE>
+    inline void expandTopDown(const GraphType& graph, std::vector<int>& distance, const int unreached, const int level, const CAN_USE& canUse) noexcept {
+        if (!isParallel(frontier.size())) {
+            for (const Vertex vertex : frontier) {
+                for (const Edge edge : graph.edgesFrom(vertex)) {
+                    const Vertex from = graph.get(ToVertex, edge);
+                    if (distance[from] != unreached || !canUse(from, graph.get(ReverseEdge, edge))) continue;
+                    distance[from] = level;
+                    verticesOfThread[0].emplace_back(from);
+                    edgesOfThread[0] += graph.outDegree(from);
+                }
+            }
+            return;
+        }
+        forEach(frontier.size(), [&](const size_t i, const int thread) {
+            for (const Edge edge : graph.edgesFrom(frontier[i])) {
+                const Vertex from = graph.get(ToVertex, edge);
+                std::atomic_ref<int> label(distance[from]);
+                if (label.load(std::memory_order_relaxed) != unreached) continue;
+                if (!canUse(from, graph.get(ReverseEdge, edge))) continue;
+                int expected = unreached;
+                if (!label.compare_exchange_strong(expected, level, std::memory_order_relaxed)) continue;
+                verticesOfThread[thread].emplace_back(from);
+                edgesOfThread[thread] += graph.outDegree(from);
+            }
+        });
+    }
+
+    template<typename CAN_USE>
+    inline void expandBottomUp(const GraphType& graph, std::vector<int>& distance, const int unreached, const int level, const CAN_USE& canUse) noexcept {
+        const size_t n = graph.numVertices();
+        inFrontier.assign((n + 63) / 64, 0);
+        if (!isParallel(frontier.size())) {
+            for (const size_t vertex : frontier) {
+                inFrontier[vertex / 64] |= uint64_t(1) << (vertex % 64);
+            }
+        } else {
+            forEach(frontier.size(), [&](const size_t i, const int) {
+                const size_t vertex = frontier[i];
+                std::atomic_ref<uint64_t>(inFrontier[vertex / 64]).fetch_or(uint64_t(1) << (vertex % 64), std::memory_order_relaxed);
+            });
+        }
+        forEach(n, [&](const size_t i, const int thread) {
+            if (distance[i] != unreached) return;
+            const Vertex from(i);
+            for (const Edge edge : graph.edgesFrom(from)) {
+                const size_t to = graph.get(ToVertex, edge);
+                if (!(inFrontier[to / 64] & (uint64_t(1) << (to % 64))) || !canUse(from, edge)) continue;
+                distance[from] = level;
+                verticesOfThread[thread].emplace_back(from);
+                edgesOfThread[thread] += graph.outDegree(from);
+                break;
+            }
+        });
+    }
+
+    // Sequential levels do without atomics.
+    inline bool isParallel(const size_t size) const noexcept {
+        return size >= ParallelLevelThreshold && numThreads > 1;
+    }
+
+    // Calls function(i, thread) for all i below size, in parallel if size is large enough.
+    template<typename FUNCTION>
+    inline void forEach(const size_t size, const FUNCTION& function) const noexcept {
+        if (!isParallel(size)) {
+            for (size_t i = 0; i < size; i++) {
+                function(i, 0);
+            }
+            return;
+        }
+        #pragma omp parallel for num_threads(numThreads) schedule(dynamic, 256)
+        for (size_t i = 0; i < size; i++) {
+            function(i, omp_get_thread_num());
+        }
+    }
+
+private:
+    const size_t numThreads;
+    std::vector<Vertex> frontier;
+    std::vector<uint64_t> inFrontier;
+    std::vector<std::vector<Vertex>> verticesOfThread;
+    std::vector<size_t> edgesOfThread;
+};
@@ -1,201 +1,186 @@
 #pragma once
 
+#include <algorithm>
 #include <queue>
+#include <utility>
 #include <vector>
 
+#include <omp.h>
+
 #include "IBFS.h"
 
+#include "../../DataStructures/Container/ExternalKHeap.h"
+#include "../../DataStructures/Container/MonotoneRadixHeap.h"
 #include "../../DataStructures/Graph/Graph.h"
+#include "../../DataStructures/MaxFlowMinCut/BreakpointIndex.h"
+#include "../../DataStructures/MaxFlowMinCut/DistanceBuckets.h"
 #include "../../DataStructures/MaxFlowMinCut/FlowUtils.h"
 #include "../../DataStructures/MaxFlowMinCut/MaxFlowInstance.h"
+#include "../../DataStructures/MaxFlowMinCut/ParametricLinkCutTree.h"
 
 #include "../../Helpers/Assert.h"
 #include "../../Helpers/Meta.h"
 #include "../../Helpers/Types.h"
 #include "../../Helpers/Vector/Vector.h"
 
-template<Meta::Derived<pmf::flowFunction> FLOW_FUNCTION, bool MEASUREMENTS = false>
-class ParametricIBFS {
-public:
-    using FlowFunction = FLOW_FUNCTION;
-    using FlowGraph = ParametricFlowGraph<FlowFunction>;
-    using StaticWrapper = RestartableMaxFlowWrapper<FlowFunction>;
-    using IBFSType = IBFS<StaticWrapper>;
-
-private:
-    struct ExcessBuckets {
-        ExcessBuckets(const int n) :
-            positionOfVertex_(n, -1) {
-        }
-
-        inline void addVertex(const Vertex vertex, const int dist) noexcept {
-            if (positionOfVertex_[vertex] != -1) return;
-            if (static_cast<size_t>(dist) >= buckets_.size()) buckets_.resize(dist + 1);
-            positionOfVertex_[vertex] = buckets_[dist].size();
-            buckets_[dist].emplace_back(vertex);
-        }
+// Event queue policies of ParametricIBFS. The queue holds one label per tree vertex, keyed by the alpha at which its parent
+// edge becomes a bottleneck. nextBottleneck() returns a label whose key is alpha, the current minimum, or nullptr if
+// there is none left.
+struct KHeapAlphaQueue {
+    struct Label : public ExternalKHeapElement {
+        Label() : ExternalKHeapElement(), value_(INFTY) {}
 
-        inline void removeVertex(const Vertex vertex, const int dist) noexcept {
-            if (positionOfVertex_[vertex] == -1) return;
-            const Vertex other = buckets_[dist].back();
-            positionOfVertex_[other] = positionOfVertex_[vertex];
-            buckets_[dist][positionOfVertex_[vertex]] = other;
-            buckets_[dist].pop_back();
-            positionOfVertex_[vertex] = -1;
-            while (!buckets_.empty() && buckets_.back().empty()) buckets_.pop_back();
-        }
-
-        inline void increaseBucket(const Vertex vertex, const int oldDist, const int newDist) noexcept {
-            Assert(newDist > oldDist, "Distance has not increased!");
-            Assert(static_cast<size_t>(positionOfVertex_[vertex]) < buckets_[oldDist].size(), "Vertex is not in bucket!");
-            Assert(buckets_[oldDist][positionOfVertex_[vertex]] == vertex, "Vertex is not in bucket!");
-            const Vertex other = buckets_[oldDist].back();
-            positionOfVertex_[other] = positionOfVertex_[vertex];
-            buckets_[oldDist][positionOfVertex_[vertex]] = other;
-            buckets_[oldDist].pop_back();
-            if (static_cast<size_t>(newDist) >= buckets_.size()) buckets_.resize(newDist + 1);
-            positionOfVertex_[vertex] = buckets_[newDist].size();
-            buckets_[newDist].emplace_back(vertex);
-        }
-
-        inline bool empty() const noexcept {
-            return buckets_.empty();
-        }
-
-        inline Vertex pop() noexcept {
-            Assert(!empty(), "Buckets are empty!");
-            const Vertex vertex = buckets_.back().back();
-            buckets_.back().pop_back();
-            positionOfVertex_[vertex] = -1;
-            while (!buckets_.empty() && buckets_.back().empty()) buckets_.pop_back();
-            return vertex;
+        inline bool hasSmallerKey(const Label* other) const noexcept {
+            return value_ < other->value_;
         }
-
-        std::vector<std::vector<Vertex>> buckets_;
-        std::vector<int> positionOfVertex_;
+        double value_;
     };
+    using Queue = ExternalKHeap<2, Label>;
 
-    struct OrphanBuckets {
-        OrphanBuckets(const int n) :
-           positionOfVertex_(n, -1), minBucket_(INFTY) {
-        }
-
-        inline void assertVertexInBucket(const Vertex vertex, const int dist) const noexcept {
-            Assert(positionOfVertex_[vertex] != -1, "Vertex is not in bucket!");
-            Assert(static_cast<size_t>(dist) < buckets_.size(), "Vertex is not in bucket!");
-            Assert(static_cast<size_t>(positionOfVertex_[vertex]) < buckets_[dist].size(), "Vertex is not in bucket!");
-            Assert(buckets_[dist][positionOfVertex_[vertex]] == vertex, "Vertex is not in bucket!");
-        }
-
-        inline bool contains(const Vertex vertex) const noexcept {
-            return positionOfVertex_[vertex] != -1;
-        }
-
-        inline void addVertex(const Vertex vertex, const int dist) noexcept {
-            if (positionOfVertex_[vertex] != -1) {
-                assertVertexInBucket(vertex, dist);
-                return;
-            }
-            if (static_cast<size_t>(dist) >= buckets_.size()) {
-                buckets_.resize(dist + 1);
-            }
-            positionOfVertex_[vertex] = buckets_[dist].size();
-
-            buckets_[dist].emplace_back(vertex);
-            minBucket_ = std::min(minBucket_, dist);
-        }
-
-        inline void decreaseBucket(const Vertex vertex, const int oldDist, const int newDist) noexcept {
-            Assert(newDist < oldDist, "Distance has not decreased!");
-            assertVertexInBucket(vertex, oldDist);
-            const Vertex other = buckets_[oldDist].back();
-            positionOfVertex_[other] = positionOfVertex_[vertex];
-            buckets_[oldDist][positionOfVertex_[vertex]] = other;
-            buckets_[oldDist].pop_back();
-            positionOfVertex_[vertex] = buckets_[newDist].size();
-            buckets_[newDist].emplace_back(vertex);
-            if (static_cast<size_t>(oldDist) == buckets_.size() - 1) {
-                while (!buckets_.empty() && buckets_.back().empty()) buckets_.pop_back();
-            }
-            minBucket_ = std::min(minBucket_, newDist);
+    // Removes the labels of all bottlenecks up to limit from the queue, in increasing order of alpha.
+    inline static void extractBottlenecks(Queue& queue, const double limit, std::vector<Label*>& labels) noexcept {
+        while (!queue.empty() && queue.front()->value_ <= limit) {
+            labels.emplace_back(queue.front());
+            queue.remove(queue.front());
         }
+    }
+};
 
-        inline bool empty() const noexcept {
-            return buckets_.empty();
-        }
+// Keys never drop below the alpha of the current iteration, so a monotone radix heap can be used instead. Popping the
+// labels would raise the minimum of the heap above keys that are still to be inserted in this iteration, so the
+// bottlenecks are extracted without touching the minimum.
+struct RadixHeapAlphaQueue {
+    struct Label : public MonotoneRadixHeapElement {
+        Label() : MonotoneRadixHeapElement(), value_(INFTY) {}
 
-        inline Vertex front() noexcept {
-            Assert(!empty(), "Buckets are empty!");
-            return buckets_[minBucket_].back();
+        inline double getKey() const noexcept {
+            return value_;
         }
+        double value_;
+    };
+    using Queue = MonotoneRadixHeap<Label>;
 
-        inline Vertex pop() noexcept {
-            Assert(!empty(), "Buckets are empty!");
-            const Vertex vertex = buckets_[minBucket_].back();
-            buckets_[minBucket_].pop_back();
-            positionOfVertex_[vertex] = -1;
-            while (static_cast<size_t>(minBucket_) < buckets_.size() && buckets_[minBucket_].empty()) minBucket_++;
-            if (static_cast<size_t>(minBucket_) == buckets_.size()) {
-                buckets_.clear();
-                minBucket_ = INFTY;
-            }
-            return vertex;
-        }
+    inline static void extractBottlenecks(Queue& queue, const double limit, std::vector<Label*>& labels) noexcept {
+        queue.extractUpTo(limit, labels);
+    }
+};
 
-        std::vector<std::vector<Vertex>> buckets_;
-        std::vector<int> positionOfVertex_;
-        int minBucket_;
-    };
+// With GLOBAL_RELABEL, the tree is periodically rebuilt along exact distances to the sink, triggered by the amount of
+// work spent on relabeling orphans since the last rebuild, as in PushRelabel.
+// With DYNAMIC_TREES, the residuals of the tree edges are kept in a ParametricLinkCutTree, which drains every excess
+// to the sink in one path update and finds the bottlenecks itself. ALPHA_QUEUE is not used then.
+// INITIAL_FLOW computes the maximum flow at alphaMin, e.g. ParallelPushRelabel instead of IBFS. It must provide the
+// sink component together with a tree towards the sink in which every parent is one level closer to the sink.
+// With numThreads > 1, large levels of excess vertices are drained in parallel, see drainLevelInParallel.
+template<pmf::flowFunction FLOW_FUNCTION, bool MEASUREMENTS = false, typename ALPHA_QUEUE = KHeapAlphaQueue, bool GLOBAL_RELABEL = false, bool DYNAMIC_TREES = false, typename INITIAL_FLOW = IBFS<RestartableMaxFlowWrapper<FLOW_FUNCTION>>>
+class ParametricIBFS {
+public:
+    using FlowFunction = FLOW_FUNCTION;
+    using FlowType = FlowFunction::FlowType;
+    using FlowGraph = ParametricFlowGraph<FlowFunction>;
+    using StaticWrapper = RestartableMaxFlowWrapper<FlowFunction>;
+    using InitialFlowAlgorithm = INITIAL_FLOW;
 
+    // The helper structures are public so that they can be benchmarked in isolation.
+    // Flat tree: the children of a vertex form a doubly linked list through the per-vertex links, kept in the order
+    // in which they were added. Removing a child moves the last child into its place, as removal from an array would.
     struct TreeData {
+        struct Links {
+            Vertex firstChild = noVertex;
+            Vertex lastChild = noVertex;
+            Vertex nextSibling = noVertex;
+            Vertex prevSibling = noVertex;
+        };
+
         TreeData(const size_t n) :
             edgeToParent_(n, noEdge),
-            children_(n),
-            childIndex_(n, -1) {
+            links_(n) {
+        }
+
+        inline void clear() noexcept {
+            Vector::fill(edgeToParent_, noEdge);
+            Vector::fill(links_, Links());
         }
 
-        void addVertex(const Vertex parent, const Vertex child, const Edge edge) {
+        inline void addVertex(const Vertex parent, const Vertex child, const Edge edge) noexcept {
             edgeToParent_[child] = edge;
-            childIndex_[child] = children_[parent].size();
-            children_[parent].emplace_back(child);
+            Links& parentLinks = links_[parent];
+            links_[child].prevSibling = parentLinks.lastChild;
+            links_[child].nextSibling = noVertex;
+            if (parentLinks.lastChild == noVertex) {
+                parentLinks.firstChild = child;
+            } else {
+                links_[parentLinks.lastChild].nextSibling = child;
+            }
+            parentLinks.lastChild = child;
         }
 
-        void removeChild(const Vertex parent, const Vertex child) {
-            const uint index = childIndex_[child];
-            const Vertex back = children_[parent].back();
-            childIndex_[back] = index;
-            childIndex_[child] = -1;
-            children_[parent][index] = back;
-            children_[parent].pop_back();
+        inline void removeChild(const Vertex parent, const Vertex child) noexcept {
+            const Vertex last = links_[parent].lastChild;
+            unlink(parent, last);
+            if (last != child) {
+                const Links& childLinks = links_[child];
+                links_[last].prevSibling = childLinks.prevSibling;
+                links_[last].nextSibling = childLinks.nextSibling;
+                if (childLinks.prevSibling == noVertex) {
+                    links_[parent].firstChild = last;
+                } else {
+                    links_[childLinks.prevSibling].nextSibling = last;
+                }
+                if (childLinks.nextSibling == noVertex) {
+                    links_[parent].lastChild = last;
+                } else {
+                    links_[childLinks.nextSibling].prevSibling = last;
+                }
+            }
+            links_[child].nextSibling = noVertex;
+            links_[child].prevSibling = noVertex;
             edgeToParent_[child] = noEdge;
         }
 
         template<typename FUNCTION>
-        void removeChildren(const Vertex parent, const FUNCTION& callback) {
-            for (const Vertex child : children_[parent]) {
+        inline void removeChildren(const Vertex parent, const FUNCTION& callback) noexcept {
+            Vertex child = links_[parent].firstChild;
+            while (child != noVertex) {
+                const Vertex next = links_[child].nextSibling;
                 callback(child, edgeToParent_[child]);
                 edgeToParent_[child] = noEdge;
-                childIndex_[child] = -1;
+                links_[child].nextSibling = noVertex;
+                links_[child].prevSibling = noVertex;
+                child = next;
             }
-            children_[parent].clear();
+            links_[parent].firstChild = noVertex;
+            links_[parent].lastChild = noVertex;
         }
 
         std::vector<Edge> edgeToParent_;
-        std::vector<std::vector<Vertex>> children_;
-        std::vector<uint> childIndex_;
-    };
-
-    struct RootAlphaLabel : public ExternalKHeapElement {
-        RootAlphaLabel() : ExternalKHeapElement(), value_(INFTY) {}
+        std::vector<Links> links_;
 
-        inline bool hasSmallerKey(const RootAlphaLabel* other) const noexcept {
-            return value_ < other->value_;
+    private:
+        inline void unlink(const Vertex parent, const Vertex child) noexcept {
+            const Links& childLinks = links_[child];
+            if (childLinks.prevSibling == noVertex) {
+                links_[parent].firstChild = childLinks.nextSibling;
+            } else {
+                links_[childLinks.prevSibling].nextSibling = childLinks.nextSibling;
+            }
+            if (childLinks.nextSibling == noVertex) {
+                links_[parent].lastChild = childLinks.prevSibling;
+            } else {
+                links_[childLinks.nextSibling].prevSibling = childLinks.prevSibling;
+            }
         }
-        double value_;
     };
 
+    using RootAlphaLabel = typename ALPHA_QUEUE::Label;
+    using AlphaQueue = typename ALPHA_QUEUE::Queue;
+
+private:
+    inline static constexpr int VertexToEdgeRatio = 12;
+    inline static constexpr size_t ParallelDrainThreshold = 256;
+
 public:
-    ParametricIBFS(const ParametricMaxFlowInstance<FlowFunction>& instance) :
+    ParametricIBFS(const ParametricMaxFlowInstance<FlowFunction>& instance, const double mergeTolerance = 0, const size_t numThreads = 1) :
         instance_(instance),
         graph_(instance.graph),
         source_(instance.source),
@@ -203,21 +188,29 @@ public:
         alphaMin_(instance.alphaMin),
         alphaMax_(instance.alphaMax),
         n(graph_.numVertices()),
+        mergeTolerance_(mergeTolerance),
+        numThreads_(numThreads),
         wrapper(instance, instance.alphaMin),
         initialFlow(wrapper),
-        residualCapacity_(instance_.getCurrentCapacities()),
+        residualCapacity_(wrapper.getCurrentCapacities()),
+        parentEdgeResidual_(n, FlowFunction(0)),
         dist_(n, INFTY),
+        levelCount_(n + 2, 0),
         excessVertices_(n),
         breakpointOfVertex_(n, INFTY),
         breakpoints_(1, alphaMin_),
         treeData_(n),
         currentEdge_(n, noEdge),
-        rootAlpha_(n),
+        rootAlpha_(DYNAMIC_TREES ? 0 : n),
         alphaQ_(n),
+        dynamicTree_(DYNAMIC_TREES ? n : 0, alphaMax_),
         orphans_(n),
         threePassOrphans_(n),
         orphanTimestamp_(n, 0),
         currentTimestamp_(0),
+        oldParentEdge_(GLOBAL_RELABEL ? n : 0, noEdge),
+        workSinceLastRelabel_(0),
+        workLimit_(VertexToEdgeRatio * n + graph_.numEdges()),
         excess_at_vertex_(n, FlowFunction(0)) {
         for (const Vertex vertex : graph_.vertices()) {
             currentEdge_[vertex] = graph_.beginEdgeFrom(vertex);
@@ -231,12 +224,13 @@ public:
         double alpha = alphaMin_;
         while (pmf::doubleLessThanAbs(alpha, alphaMax_)) {
             if constexpr (MEASUREMENTS) numIterations++;
-            if (alphaQ_.empty()) break;
-            assert(alphaQ_.front()->value_ > alpha);
-            alpha = alphaQ_.front()->value_;
+            const double nextAlpha = getNextBottleneckAlpha();
+            if (nextAlpha == INFTY) break;
+            assert(nextAlpha > alpha);
+            alpha = nextAlpha;
             if (alpha > alphaMax_) break;
             if constexpr (MEASUREMENTS) timer.restart();
-            updateTree(alpha);
+            alpha = updateTree(alpha);
             if constexpr (MEASUREMENTS) updateTime += timer.elapsedMicroseconds();
             if constexpr (MEASUREMENTS) timer.restart();
             reconnectTree(alpha);
@@ -244,17 +238,28 @@ public:
             if constexpr (MEASUREMENTS) timer.restart();
             drainExcess(alpha);
             if constexpr (MEASUREMENTS) drainTime += timer.elapsedMicroseconds();
+            if constexpr (GLOBAL_RELABEL) {
+                if (workSinceLastRelabel_ > workLimit_) {
+                    if constexpr (MEASUREMENTS) timer.restart();
+                    globalRelabel(alpha);
+                    if constexpr (MEASUREMENTS) relabelTime += timer.elapsedMicroseconds();
+                }
+            }
         }
+        breakpointIndex_.build(instance_, breakpointOfVertex_);
         if constexpr (MEASUREMENTS) {
             std::cout << "#Iterations: " << numIterations << std::endl;
             std::cout << "#Bottlenecks: " << numBottlenecks << std::endl;
             std::cout << "#Adoptions: " << numAdoptions << std::endl;
             std::cout << "Avg. distance: " << getAvgDistance() << std::endl;
             std::cout << "#Drains: " << numDrains << std::endl;
+            std::cout << "#Gap vertices: " << numGapVertices << std::endl;
+            std::cout << "#Global relabels: " << numGlobalRelabels << std::endl;
             std::cout << "Init time: " << String::musToString(initTime) << std::endl;
             std::cout << "Update time: " << String::musToString(updateTime) << std::endl;
             std::cout << "Reconnect time: " << String::musToString(reconnectTime) << std::endl;
             std::cout << "Drain time: " << String::musToString(drainTime) << std::endl;
+            std::cout << "Relabel time: " << String::musToString(relabelTime) << std::endl;
         }
     }
 
@@ -266,26 +271,13 @@ public:
         return breakpointOfVertex_;
     }
 
-    inline std::vector<Vertex> getSinkComponent(const double alpha) const noexcept {
-        std::vector<Vertex> sinkComponent;
-        for (const Vertex vertex : graph_.vertices()) {
-            if (breakpointOfVertex_[vertex] <= alpha) continue;
-            sinkComponent.emplace_back(vertex);
-        }
-        return sinkComponent;
+    // The vertices are ordered by breakpoint, not by id.
+    inline std::span<const Vertex> getSinkComponent(const double alpha) const noexcept {
+        return breakpointIndex_.getSinkComponent(alpha);
     }
 
     inline double getFlowValue(const double alpha) const noexcept {
-        double flow = 0;
-        for (const Vertex from : graph_.vertices()) {
-            if (breakpointOfVertex_[from] > alpha) continue;
-            for (const Edge edge : graph_.edgesFrom(from)) {
-                const Vertex to = graph_.get(ToVertex, edge);
-                if (breakpointOfVertex_[to] <= alpha) continue;
-                flow += instance_.getCapacity(edge, alpha);
-            }
-        }
-        return flow;
+        return breakpointIndex_.getFlowValue(alpha);
     }
 
     inline double getInitTime() const noexcept {
@@ -333,6 +325,21 @@ public:
         return numDrains;
     }
 
+    inline long long getNumGapVertices() const noexcept {
+        // if (!MEASUREMENTS) throw std::runtime_error("Detailed measurements are only done if template parameter MEASUREMENTS is true");
+        return numGapVertices;
+    }
+
+    inline long long getNumGlobalRelabels() const noexcept {
+        // if (!MEASUREMENTS) throw std::runtime_error("Detailed measurements are only done if template parameter MEASUREMENTS is true");
+        return numGlobalRelabels;
+    }
+
+    inline double getRelabelTime() const noexcept {
+        // if (!MEASUREMENTS) throw std::runtime_error("Detailed measurements are only done if template parameter MEASUREMENTS is true");
+        return relabelTime;
+    }
+
 private:
     inline void initialize() noexcept {
         initialFlow.run();
@@ -340,6 +347,16 @@ private:
         std::vector<Vertex> sinkComponent;
         initializeSinkTree(sinkComponent);
         createInitialExcesses(sinkComponent, initialResidualCapacity);
+        if constexpr (DYNAMIC_TREES) {
+            // The residuals of the tree edges are only known now.
+            dynamicTree_.advance(alphaMin_);
+            for (const Vertex vertex : sinkComponent) {
+                const Edge e = treeData_.edgeToParent_[vertex];
+                if (e == noEdge) continue;
+                dynamicTree_.link(vertex, graph_.get(ToVertex, e), parentEdgeResidual_[vertex], residualCapacity_[e]);
+                parentEdgeResidual_[vertex] = FlowFunction(0);
+            }
+        }
         drainExcess(alphaMin_);
 
         /*#ifndef NDEBUG
@@ -351,10 +368,10 @@ private:
                     continue;
                 if (graph_.get(ToVertex, e) != sink_) {
                     std::cout << "Edge connecting " << v << " and " << graph_.get(ToVertex, e) << std::endl;
-                    std::cout << "Residual capacity of edge " << e << " is " << residualCapacity_[e].eval(instance_.alphaMin) << ", initial residual capacity is " << initialResidualCapacity[e] << std::endl;
-                    std::cout << "Residual capacity of reverse edge " << e << " is " << residualCapacity_[instance_.graph.get(ReverseEdge, e)].eval(instance_.alphaMin) << ", initial residual capacity is " << initialResidualCapacity[instance_.graph.get(ReverseEdge, e)] << std::endl;
+                    std::cout << "Residual capacity of edge " << e << " is " << getResidualCapacity(e, instance_.alphaMin) << ", initial residual capacity is " << initialResidualCapacity[e] << std::endl;
+                    std::cout << "Residual capacity of reverse edge " << e << " is " << getResidualCapacity(instance_.graph.get(ReverseEdge, e), instance_.alphaMin) << ", initial residual capacity is " << initialResidualCapacity[instance_.graph.get(ReverseEdge, e)] << std::endl;
                     std::cout << "Capacity of edge " << e << " is " << graph_.get(Capacity, e) << " and " << graph_.get(Capacity, graph_.get(ReverseEdge, e)) << " for reverse edge" << std::endl;
-                    assert(pmf::doubleEqualAbs(residualCapacity_[e].eval(instance_.alphaMin), initialResidualCapacity[e]));
+                    assert(pmf::doubleEqualAbs(getResidualCapacity(e, instance_.alphaMin), initialResidualCapacity[e]));
                 }
             }
         }
@@ -373,7 +390,7 @@ private:
             if (v != instance_.source && treeData_.edgeToParent_[v] != noEdge) {
                 for (Vertex w = v; initialSource[w]; w = graph_.get(ToVertex, treeData_.edgeToParent_[w])) {
                     std::cout << "Vertex " << w << " in initial flow source, but not parametric flow source" << std::endl;
-                    std::cout << "Residual capacity of parent edge " << residualCapacity_[treeData_.edgeToParent_[w]].eval(alphaMin_) << " and initial residual capacity is " << initialResidualCapacity[treeData_.edgeToParent_[w]] <<  std::endl;
+                    std::cout << "Residual capacity of parent edge " << getResidualCapacity(treeData_.edgeToParent_[w], alphaMin_) << " and initial residual capacity is " << initialResidualCapacity[treeData_.edgeToParent_[w]] <<  std::endl;
                 }
                 std::cout << std::endl << "Reached shared sink component" << std::endl << std::endl;
             }
@@ -385,7 +402,7 @@ private:
         for (const Vertex vertex : graph_.vertices()) {
             if (initialFlow.isInSinkComponent(vertex)) {
                 sinkComponent.emplace_back(vertex);
-                dist_[vertex] = initialFlow.getSinkComponentDistance(vertex);
+                setDistance(vertex, initialFlow.getSinkComponentDistance(vertex));
                 if (vertex == sink_) continue;
                 treeData_.addVertex(initialFlow.getParentVertex(vertex), vertex, initialFlow.getParentEdge(vertex));
             } else {
@@ -405,13 +422,12 @@ private:
                     saturateEdgeInitial(e, revE, to);
                 } else if (to == sink_) {
                     if (initialResidualCapacity[e] > 0) {
-                        initializeTreeSinkEdge(e, initialResidualCapacity[e]);
-                        initializeTreeSinkEdge(revE, initialResidualCapacity[revE]);
+                        initializeTreeSinkEdge(e, revE, from, initialResidualCapacity);
                     } else {
-                        saturateEdgeInitial(e, revE, to);
+                        saturateSinkEdgeInitial(e, revE, from);
                     }
                 } else {
-                    residualCapacity_[e] = FlowFunction(initialResidualCapacity[e]);
+                    residualCapacity_[e] = initialResidualCapacity[e];
                 }
             }
         }
@@ -419,29 +435,81 @@ private:
 
     inline void saturateEdgeInitial(const Edge e, const Edge revE, const Vertex to) noexcept {
         const FlowFunction& capacity = graph_.get(Capacity, e);
-        residualCapacity_[e] = FlowFunction(0);
-        residualCapacity_[revE] = capacity + graph_.get(Capacity, revE);
+        residualCapacity_[e] = 0;
+        residualCapacity_[revE] = (capacity + graph_.get(Capacity, revE)).eval(alphaMin_);
         excess_at_vertex_[to] += capacity - FlowFunction(capacity.eval(alphaMin_));
         excessVertices_.addVertex(to, dist_[to]);
     }
 
-    inline void initializeTreeSinkEdge(const Edge e, const double initialResidualCapacity) noexcept {
+    inline void saturateSinkEdgeInitial(const Edge e, const Edge revE, const Vertex from) noexcept {
+        const FlowFunction& capacity = graph_.get(Capacity, e);
+        residualCapacity_[e] = 0;
+        residualCapacity_[revE] = (capacity + graph_.get(Capacity, revE)).eval(alphaMin_);
+        excess_at_vertex_[from] -= capacity - FlowFunction(capacity.eval(alphaMin_));
+        excessVertices_.addVertex(from, dist_[from]);
+    }
+
+    inline void initializeTreeSinkEdge(const Edge e, const Edge revE, const Vertex from, const std::vector<double>& initialResidualCapacity) noexcept {
+        Assert(treeData_.edgeToParent_[from] == e, "Residual sink edge of vertex " << from << " is not its parent edge!");
         const FlowFunction& capacity = graph_.get(Capacity, e);
-        residualCapacity_[e] = capacity - FlowFunction(capacity.eval(alphaMin_) - initialResidualCapacity);
+        residualCapacity_[e] = initialResidualCapacity[e];
+        residualCapacity_[revE] = initialResidualCapacity[revE];
+        parentEdgeResidual_[from] = capacity - FlowFunction(capacity.eval(alphaMin_));
+        if constexpr (!DYNAMIC_TREES) recalculateRootAlpha(from, e, alphaMin_);
     }
 
-    inline void updateTree(const double nextAlpha) noexcept {
+    // Removes the bottlenecks of all events in [nextAlpha, nextAlpha + mergeTolerance_] as one batch and returns the last
+    // alpha among them, at which the tree is then reconnected. Every bottleneck edge is collapsed at its own zero
+    // crossing, so its scalar residual becomes zero instead of being evaluated past the crossing.
+    inline double updateTree(const double nextAlpha) noexcept {
         assert(orphans_.empty());
         assert(threePassOrphans_.empty());
-        while (!alphaQ_.empty() && alphaQ_.front()->value_ == nextAlpha) {
-            if constexpr (MEASUREMENTS) numBottlenecks++;
-            const Vertex v(alphaQ_.front() - &(rootAlpha_[0]));
-            const Edge e = treeData_.edgeToParent_[v];
-            assert(e != noEdge);
-            //assert(!isEdgeResidual(e, nextAlpha));
-            const Vertex parent = graph_.get(ToVertex, e);
-            removeTreeEdge<true>(e, v, parent, nextAlpha);
-            treeData_.removeChild(parent, v);
+        const double limit = std::max(nextAlpha, std::min(nextAlpha + mergeTolerance_, alphaMax_));
+        double batchAlpha = nextAlpha;
+        bottlenecks_.clear();
+        if constexpr (DYNAMIC_TREES) {
+            // Every bottleneck has to be cut before the tree can report the next one.
+            for (double alpha = nextAlpha; alpha != INFTY; alpha = dynamicTree_.nextEvent(limit)) {
+                dynamicTree_.advance(alpha);
+                for (Vertex v = dynamicTree_.nextBottleneck(alpha); v != noVertex; v = dynamicTree_.nextBottleneck(alpha)) {
+                    parentEdgeResidual_[v] = dynamicTree_.cut(v);
+                    bottlenecks_.emplace_back(v, alpha);
+                }
+                batchAlpha = alpha;
+            }
+        } else {
+            bottleneckLabels_.clear();
+            ALPHA_QUEUE::extractBottlenecks(alphaQ_, limit, bottleneckLabels_);
+            for (RootAlphaLabel* const label : bottleneckLabels_) {
+                batchAlpha = std::max(batchAlpha, label->value_);
+                bottlenecks_.emplace_back(Vertex(label - &(rootAlpha_[0])), label->value_);
+                label->value_ = INFTY;
+            }
+        }
+        for (const auto& [v, alpha] : bottlenecks_) {
+            removeBottleneck(v, alpha);
+        }
+        return batchAlpha;
+    }
+
+    inline void removeBottleneck(const Vertex v, const double nextAlpha) noexcept {
+        if constexpr (MEASUREMENTS) numBottlenecks++;
+        const Edge e = treeData_.edgeToParent_[v];
+        assert(e != noEdge);
+        //assert(!isEdgeResidual(e, nextAlpha));
+        const Vertex parent = graph_.get(ToVertex, e);
+        // The residual can only fall below zero by rounding, and never by more than it changes within the tolerance.
+        [[maybe_unused]] const double maxDeficit = std::abs(parentEdgeResidual_[v].eval(nextAlpha + mergeTolerance_) - parentEdgeResidual_[v].eval(nextAlpha)) + pmf::epsilon;
+        removeTreeEdge<true>(e, v, parent, nextAlpha);
+        Assert(residualCapacity_[e] >= -maxDeficit, "Bottleneck edge " << e << " has residual " << residualCapacity_[e] << " after its removal!");
+        treeData_.removeChild(parent, v);
+    }
+
+    inline double getNextBottleneckAlpha() noexcept {
+        if constexpr (DYNAMIC_TREES) {
+            return dynamicTree_.nextEvent();
+        } else {
+            return alphaQ_.empty() ? INFTY : alphaQ_.front()->value_;
         }
     }
 
@@ -473,6 +541,10 @@ private:
             treeData_.removeChildren(v, [&](const Vertex child, const Edge e) {
                 removeTreeEdge<false>(e, child, v, nextAlpha);
             });
+            if (levelCount_[dist_[v]] == 1) {
+                relabelGap(v, nextAlpha);
+                continue;
+            }
             if (adoptWithNewDist(v, nextAlpha)) {
                 if constexpr (MEASUREMENTS) {
                     numAdoptions++;
@@ -481,11 +553,7 @@ private:
                 continue;
             }
             moved.emplace_back(v);
-            dist_[v] = INFTY;
-            breakpointOfVertex_[v] = nextAlpha;
-            if (breakpoints_.back() != nextAlpha) {
-                breakpoints_.emplace_back(nextAlpha);
-            }
+            moveToSourceSide(v, nextAlpha);
         }
     }
 
@@ -495,7 +563,7 @@ private:
             const Vertex to = graph_.get(ToVertex, e);
             if (!isEdgeAdmissible(v, to)) continue;
             excessVertices_.addVertex(v, dist_[v]);
-            treeData_.addVertex(to, v, e);
+            addTreeEdge(to, v, e);
             currentEdge_[v] = e;
             return true;
         }
@@ -506,6 +574,7 @@ private:
         uint d_min = INFTY;
         Edge e_min = noEdge;
         Vertex v_min = noVertex;
+        if constexpr (GLOBAL_RELABEL) workSinceLastRelabel_ += VertexToEdgeRatio + graph_.outDegree(v);
 
         for (const Edge e : graph_.edgesFrom(v)) {
             if (!isEdgeResidual(e, nextAlpha)) continue;
@@ -522,9 +591,9 @@ private:
         }
 
         assert(d_min >= dist_[v]);
-        dist_[v] = d_min + 1;
+        setDistance(v, d_min + 1);
         excessVertices_.addVertex(v, dist_[v]);
-        treeData_.addVertex(v_min, v, e_min);
+        addTreeEdge(v_min, v, e_min);
         currentEdge_[v] = e_min;
         return true;
     }
@@ -562,11 +631,7 @@ private:
         for (const Vertex v : moved) {
             if (treeData_.edgeToParent_[v] != noEdge) continue;
             excessVertices_.removeVertex(v, dist_[v]);
-            dist_[v] = INFTY;
-            breakpointOfVertex_[v] = nextAlpha;
-            if (breakpoints_.back() != nextAlpha) {
-                breakpoints_.emplace_back(nextAlpha);
-            }
+            moveToSourceSide(v, nextAlpha);
         }
     }
 
@@ -588,7 +653,11 @@ private:
             treeData_.removeChildren(v, [&](const Vertex child, const Edge e) {
                 removeTreeEdge<false>(e, child, v, nextAlpha);
             });
-            dist_[v]++;
+            if (levelCount_[dist_[v]] == 1) {
+                relabelGap(v, nextAlpha);
+                continue;
+            }
+            setDistance(v, dist_[v] + 1);
             threePassOrphans_.addVertex(v, dist_[v]);
         }
     }
@@ -600,6 +669,7 @@ private:
         uint d_min = INFTY;
         Edge e_min = noEdge;
         Vertex v_min = noVertex;
+        if constexpr (GLOBAL_RELABEL) workSinceLastRelabel_ += VertexToEdgeRatio + graph_.outDegree(v);
 
         for (const Edge e : graph_.edgesFrom(v)) {
             if (!isEdgeResidual(e, nextAlpha)) continue;
@@ -622,7 +692,7 @@ private:
         treeData_.edgeToParent_[v] = e_min;
         //std::cout << "Set parent to " << v_min << " with " << dist_[v_min];
         if (d_min + 1 > dist_[v]) {
-            dist_[v] = d_min + 1;
+            setDistance(v, d_min + 1);
             threePassOrphans_.addVertex(v, dist_[v]);
             return true;
         }
@@ -638,7 +708,7 @@ private:
             if (!isEdgeAdmissible(v, to)) continue;
             if (treeData_.edgeToParent_[to] == noEdge) continue;
             excessVertices_.addVertex(v, dist_[v]);
-            treeData_.addVertex(to, v, e);
+            addTreeEdge(to, v, e);
             currentEdge_[v] = e;
             break;
         }
@@ -666,57 +736,218 @@ private:
                 }
             }
             treeData_.edgeToParent_[from] = rev;
-            dist_[from] = dist_[v] + 1;
+            setDistance(from, dist_[v] + 1);
+        }
+    }
+
+    // v is the last vertex on its distance level and is about to leave it. Every residual path to the sink would have to
+    // pass through that level, so v and all vertices above it are moved to the source side at once. These are exactly the
+    // remaining orphans above the level and their subtrees, since tree paths descend one level per edge.
+    inline void relabelGap(const Vertex v, const double nextAlpha) noexcept {
+        const int gap = dist_[v];
+        gapVertices_.clear();
+        gapVertices_.emplace_back(v);
+        const auto collect = [&](const Vertex u) { gapVertices_.emplace_back(u); };
+        orphans_.removeAbove(gap, collect);
+        threePassOrphans_.removeAbove(gap, collect);
+        for (size_t i = 0; i < gapVertices_.size(); i++) {
+            const Vertex u = gapVertices_[i];
+            treeData_.removeChildren(u, [&](const Vertex child, const Edge e) {
+                collapseTreeEdge(e, child, u, nextAlpha);
+                gapVertices_.emplace_back(child);
+            });
+            excessVertices_.removeVertex(u, dist_[u]);
+            moveToSourceSide(u, nextAlpha);
         }
+        if constexpr (MEASUREMENTS) numGapVertices += gapVertices_.size();
     }
 
+    // Rebuilds the tree as a BFS tree of the residual graph at alpha, which makes all distances exact. Must be called
+    // between iterations, when there are no orphans and all excesses are drained. All tree edges are collapsed first;
+    // the resulting excesses vanish at alpha and are drained along the new tree, which restores the parametric parts of
+    // the new parent edges. A previous parent edge may already be saturated at alpha, without having been processed as a
+    // bottleneck yet, so previous parent edges may be used by the BFS as well. This keeps the sink component unchanged.
+    inline void globalRelabel(const double alpha) noexcept {
+        assert(orphans_.empty());
+        assert(excessVertices_.empty());
+        if constexpr (MEASUREMENTS) numGlobalRelabels++;
+        for (const Vertex v : graph_.vertices()) {
+            const Edge e = treeData_.edgeToParent_[v];
+            oldParentEdge_[v] = e;
+            if (e == noEdge) continue;
+            collapseTreeEdge(e, v, graph_.get(ToVertex, e), alpha);
+        }
+        treeData_.clear();
+        relabelQueue_.clear();
+        relabelQueue_.emplace_back(sink_);
+        for (size_t i = 0; i < relabelQueue_.size(); i++) {
+            const Vertex u = relabelQueue_[i];
+            for (const Edge e : graph_.edgesFrom(u)) {
+                const Vertex v = graph_.get(ToVertex, e);
+                // Vertices without a previous parent edge are the sink and the source side.
+                if (oldParentEdge_[v] == noEdge || treeData_.edgeToParent_[v] != noEdge) continue;
+                const Edge rev = graph_.get(ReverseEdge, e);
+                if (!isEdgeResidual(rev, alpha) && oldParentEdge_[v] != rev) continue;
+                setDistance(v, dist_[u] + 1);
+                addTreeEdge(u, v, rev);
+                currentEdge_[v] = graph_.beginEdgeFrom(v);
+                excessVertices_.addVertex(v, dist_[v]);
+                relabelQueue_.emplace_back(v);
+            }
+        }
+        drainExcess(alpha);
+        workSinceLastRelabel_ = 0;
+    }
+
+    inline void moveToSourceSide(const Vertex v, const double nextAlpha) noexcept {
+        setDistance(v, INFTY);
+        breakpointOfVertex_[v] = nextAlpha;
+        if (breakpoints_.back() != nextAlpha) {
+            breakpoints_.emplace_back(nextAlpha);
+        }
+    }
+
+    inline void setDistance(const Vertex v, const uint dist) noexcept {
+        if (dist_[v] != INFTY) levelCount_[dist_[v]]--;
+        if (dist != INFTY) levelCount_[dist]++;
+        dist_[v] = dist;
+    }
+
+    // Drains one distance level at a time. Vertices of the same level only interact through shared parents, which lie
+    // one level lower, so the level is processed in the same order as popping the vertices one by one.
     inline void drainExcess(const double nextAlpha) noexcept {
+        if constexpr (DYNAMIC_TREES) {
+            drainExcessAlongPaths();
+            return;
+        }
         while (!excessVertices_.empty()) {
-            if constexpr (MEASUREMENTS) numDrains++;
-            const Vertex v = excessVertices_.pop();
-            if (v == sink_) continue;
-            assert(dist_[v] != INFTY);
+            excessVertices_.popLevel(drainLevel_);
+            if constexpr (MEASUREMENTS) numDrains += drainLevel_.size();
+            if (numThreads_ > 1 && drainLevel_.size() >= ParallelDrainThreshold) {
+                drainLevelInParallel(nextAlpha);
+                continue;
+            }
+            for (size_t i = drainLevel_.size(); i-- > 0;) {
+                const Vertex v = drainLevel_[i];
+                if (v == sink_) continue;
+                assert(dist_[v] != INFTY);
+                const Edge e = treeData_.edgeToParent_[v];
+                const Vertex w = graph_.get(ToVertex, e);
+                parentEdgeResidual_[v] -= excess_at_vertex_[v];
+                if (w != sink_) {
+                    excess_at_vertex_[w] += excess_at_vertex_[v];
+                    excessVertices_.addVertex(w, dist_[w]);
+                }
+                excess_at_vertex_[v] = FlowFunction(0);
+                recalculateRootAlpha(v, e, nextAlpha);
+            }
+        }
+    }
 
+    // Drains the popped level in three phases:
+    // 1. In parallel, every vertex subtracts its excess from its parent edge and computes its next zero crossing.
+    // 2. The vertices are sorted by parent, and the excesses of every parent's children are summed by one thread.
+    // 3. The parents are registered as excess vertices and the alpha queue is updated in one sequential pass.
+    // The sink is alone on level 0, so it is never part of a level that is large enough.
+    inline void drainLevelInParallel(const double nextAlpha) noexcept {
+        const size_t size = drainLevel_.size();
+        drainChildren_.resize(size);
+        drainAlpha_.resize(size);
+        #pragma omp parallel for num_threads(numThreads_) schedule(static)
+        for (size_t i = 0; i < size; i++) {
+            const Vertex v = drainLevel_[i];
+            assert(v != sink_ && dist_[v] != INFTY);
             const Edge e = treeData_.edgeToParent_[v];
-            const Edge revE = graph_.get(ReverseEdge, e);
-            const Vertex w = graph_.get(ToVertex, e);
+            parentEdgeResidual_[v] -= excess_at_vertex_[v];
+            drainChildren_[i] = std::make_pair(graph_.get(ToVertex, e), v);
+            drainAlpha_[i] = getNextZeroCrossing(v, e, nextAlpha);
+        }
 
-            residualCapacity_[e] -= excess_at_vertex_[v];
-            residualCapacity_[revE] += excess_at_vertex_[v];
-            if (w != sink_) {
-                excess_at_vertex_[w] += excess_at_vertex_[v];
-                excessVertices_.addVertex(w, dist_[w]);
+        std::sort(drainChildren_.begin(), drainChildren_.end());
+        drainParentBegin_.clear();
+        for (size_t i = 0; i < size; i++) {
+            if (i == 0 || drainChildren_[i].first != drainChildren_[i - 1].first) drainParentBegin_.emplace_back(i);
+        }
+        drainParentBegin_.emplace_back(size);
+        const size_t numParents = drainParentBegin_.size() - 1;
+        #pragma omp parallel for num_threads(numThreads_) schedule(dynamic, 64)
+        for (size_t p = 0; p < numParents; p++) {
+            const Vertex w = drainChildren_[drainParentBegin_[p]].first;
+            FlowFunction excess(0);
+            for (size_t i = drainParentBegin_[p]; i < drainParentBegin_[p + 1]; i++) {
+                const Vertex v = drainChildren_[i].second;
+                excess += excess_at_vertex_[v];
+                excess_at_vertex_[v] = FlowFunction(0);
             }
+            if (w != sink_) excess_at_vertex_[w] += excess;
+        }
+
+        for (size_t p = 0; p < numParents; p++) {
+            const Vertex w = drainChildren_[drainParentBegin_[p]].first;
+            if (w != sink_) excessVertices_.addVertex(w, dist_[w]);
+        }
+        for (size_t i = 0; i < size; i++) {
+            setRootAlpha(drainLevel_[i], drainAlpha_[i]);
+        }
+    }
+
+    // Every excess travels all the way to the sink, so each one is a single path update.
+    inline void drainExcessAlongPaths() noexcept {
+        while (!excessVertices_.empty()) {
+            const Vertex v = excessVertices_.pop();
+            if constexpr (MEASUREMENTS) numDrains++;
+            if (v == sink_) continue;
+            assert(dist_[v] != INFTY);
+            dynamicTree_.addToPath(v, FlowFunction(0) - excess_at_vertex_[v]);
             excess_at_vertex_[v] = FlowFunction(0);
-            recalculateRootAlpha(v, e, nextAlpha);
         }
     }
 
+    // The new tree edge e = (child, parent) is residual at the current alpha, without a parametric part.
+    inline void addTreeEdge(const Vertex parent, const Vertex child, const Edge e) noexcept {
+        treeData_.addVertex(parent, child, e);
+        if constexpr (DYNAMIC_TREES) dynamicTree_.link(child, parent, FlowFunction(0), residualCapacity_[e]);
+    }
+
     template<bool REGISTER_EXCESS>
     inline void removeTreeEdge(const Edge e, const Vertex from, const Vertex to, const double nextAlpha) noexcept {
+        collapseTreeEdge(e, from, to, nextAlpha);
+        if constexpr (REGISTER_EXCESS) excessVertices_.addVertex(to, dist_[to]);
+        orphans_.addVertex(from, dist_[from]);
+        assert(dist_[from] != INFTY);
+    }
+
+    inline void collapseTreeEdge(const Edge e, const Vertex from, const Vertex to, const double nextAlpha) noexcept {
         const Edge rev = graph_.get(ReverseEdge, e);
-        const FlowFunction oldResidualCapacity = residualCapacity_[e];
-        const FlowFunction newResidualCapacity(residualCapacity_[e].eval(nextAlpha));
-        const FlowFunction add = newResidualCapacity - oldResidualCapacity;
+        if constexpr (DYNAMIC_TREES) {
+            // Bottlenecks have already been cut while collecting them.
+            if (dynamicTree_.hasParent(from)) parentEdgeResidual_[from] = dynamicTree_.cut(from);
+        }
+        // Collapse the parametric part of the residual capacity into the scalar residuals.
+        const FlowType residualChange = parentEdgeResidual_[from].eval(nextAlpha);
+        const FlowFunction add = FlowFunction(residualChange) - parentEdgeResidual_[from];
         //Don't add orphan to excessVertices_ yet. Wait until it has been adopted.
         excess_at_vertex_[from] += add;
         excess_at_vertex_[to] -= add;
-        residualCapacity_[e] = newResidualCapacity;
-        residualCapacity_[rev] -= add;
-        if constexpr (REGISTER_EXCESS) excessVertices_.addVertex(to, dist_[to]);
-        clearRootAlpha(from);
-        orphans_.addVertex(from, dist_[from]);
-        assert(dist_[from] != INFTY);
+        residualCapacity_[e] += residualChange;
+        residualCapacity_[rev] -= residualChange;
+        parentEdgeResidual_[from] = FlowFunction(0);
+        if constexpr (!DYNAMIC_TREES) clearRootAlpha(from);
     }
 
-    inline double getNextZeroCrossing(const Edge e, const double alpha) const noexcept {
-        const double crossing = residualCapacity_[e].getNextZeroCrossing(alpha);
+    // e must be the parent edge of v.
+    inline double getNextZeroCrossing(const Vertex v, const Edge e, const double alpha) const noexcept {
+        const double crossing = (parentEdgeResidual_[v] + FlowFunction(residualCapacity_[e])).getNextZeroCrossing(alpha);
         return (crossing == alpha) ? std::nextafter(alpha, instance_.alphaMax) : crossing;
     }
 
     inline void recalculateRootAlpha(const Vertex v, const Edge e, const double alpha) noexcept {
+        setRootAlpha(v, getNextZeroCrossing(v, e, alpha));
+    }
+
+    inline void setRootAlpha(const Vertex v, const double value) noexcept {
         const double oldValue = rootAlpha_[v].value_;
-        rootAlpha_[v].value_ = getNextZeroCrossing(e, alpha);
+        rootAlpha_[v].value_ = value;
         if (rootAlpha_[v].value_ == INFTY) {
             if (oldValue < INFTY) {
                 alphaQ_.remove(&rootAlpha_[v]);
@@ -737,8 +968,27 @@ private:
         return dist_[from] == dist_[to] + 1;
     }
 
-    inline bool isEdgeResidual(const Edge edge, const double alpha) const noexcept {
-        return pmf::doubleIsPositive(residualCapacity_[edge].eval(alpha));
+    // Only valid for edges that are neither tree edges nor reverse tree edges.
+    inline bool isEdgeResidual(const Edge edge, const double) const noexcept {
+        return pmf::doubleIsPositive(residualCapacity_[edge]);
+    }
+
+    // With DYNAMIC_TREES, the parametric parts of the tree edges are kept in dynamicTree_ instead.
+    inline FlowFunction getResidualCapacity(const Edge edge) const noexcept {
+        const Edge reverseEdge = graph_.get(ReverseEdge, edge);
+        const Vertex from = graph_.get(ToVertex, reverseEdge);
+        const Vertex to = graph_.get(ToVertex, edge);
+        if (treeData_.edgeToParent_[from] == edge) {
+            return parentEdgeResidual_[from] + FlowFunction(residualCapacity_[edge]);
+        } else if (treeData_.edgeToParent_[to] == reverseEdge) {
+            return FlowFunction(residualCapacity_[edge]) - parentEdgeResidual_[to];
+        } else {
+            return FlowFunction(residualCapacity_[edge]);
+        }
+    }
+
+    inline FlowType getResidualCapacity(const Edge edge, const double alpha) const noexcept {
+        return getResidualCapacity(edge).eval(alpha);
     }
 
     inline void checkTree(const bool allowOrphans, const double alpha) const noexcept {
@@ -769,16 +1019,14 @@ private:
     }
 
     inline void checkExcessBuckets() noexcept {
-        for (size_t i = 0; i < excessVertices_.buckets_.size(); i++) {
-            for (const Vertex v : excessVertices_.buckets_[i]) {
-                assert(dist_[v] == i);
-            }
-        }
+        excessVertices_.forEach([&](const Vertex v, const int dist) {
+            assert(dist_[v] == static_cast<uint>(dist));
+        });
     }
 
     inline void checkCapacityConstraints(const double alpha) const noexcept {
         for (const Edge edge : graph_.edges()) {
-            Assert(!pmf::isNumberNegative(residualCapacity_[edge].eval(alpha)), "Capacity constraint violated!");
+            Assert(!pmf::isNumberNegative(getResidualCapacity(edge, alpha)), "Capacity constraint violated!");
         }
     }
 
@@ -798,7 +1046,7 @@ private:
         FlowFunction inflow(0);
         for (const Edge edge : graph_.edgesFrom(vertex)) {
             const Edge reverseEdge = graph_.get(ReverseEdge, edge);
-            inflow += instance_.getCapacity(reverseEdge) - residualCapacity_[reverseEdge];
+            inflow += instance_.getCapacity(reverseEdge) - getResidualCapacity(reverseEdge);
         }
         return inflow;
     }
@@ -834,36 +1082,60 @@ private:
     const Vertex& source_, sink_;
     const double& alphaMin_, alphaMax_;
     const int n;
+    // Events at most this far apart are processed in the same iteration.
+    const double mergeTolerance_;
+    const size_t numThreads_;
 
     StaticWrapper wrapper;
-    IBFSType initialFlow;
+    InitialFlowAlgorithm initialFlow;
 
-    std::vector<FlowFunction> residualCapacity_;
+    // Scalar residual capacities; tree edges additionally carry a parametric part, indexed by their child vertex.
+    std::vector<FlowType> residualCapacity_;
+    std::vector<FlowFunction> parentEdgeResidual_;
     std::vector<uint> dist_;
+    // Number of vertices per finite distance label, to detect gaps.
+    std::vector<uint> levelCount_;
     ExcessBuckets excessVertices_;
 
     std::vector<double> breakpointOfVertex_;
     std::vector<double> breakpoints_;
+    BreakpointIndex<FlowFunction> breakpointIndex_;
     TreeData treeData_;
     std::vector<Edge> currentEdge_;
 
     std::vector<RootAlphaLabel> rootAlpha_;
-    ExternalKHeap<2, RootAlphaLabel> alphaQ_;
+    AlphaQueue alphaQ_;
+    ParametricLinkCutTree<FlowFunction> dynamicTree_;
+    std::vector<RootAlphaLabel*> bottleneckLabels_;
+    std::vector<std::pair<Vertex, double>> bottlenecks_;
 
     OrphanBuckets orphans_;
     OrphanBuckets threePassOrphans_;
     std::vector<int> orphanTimestamp_;
     int currentTimestamp_;
+    std::vector<Vertex> gapVertices_;
+
+    std::vector<Edge> oldParentEdge_;
+    std::vector<Vertex> relabelQueue_;
+    long long workSinceLastRelabel_;
+    long long workLimit_;
 
     std::vector<FlowFunction> excess_at_vertex_;
+    std::vector<Vertex> drainLevel_;
+    std::vector<std::pair<Vertex, Vertex>> drainChildren_;
+    std::vector<double> drainAlpha_;
+    std::vector<size_t> drainParentBegin_;
 
     double initTime = 0;
     double updateTime = 0;
     double reconnectTime = 0;
     double drainTime = 0;
+    double relabelTime = 0;
     long long numIterations = 0;
     long long numBottlenecks = 0;
     long long numAdoptions = 0;
     long long avgDistance = 0;
     long long numDrains = 0;
+    long long numGapVertices = 0;
+    long long numGlobalRelabels = 0;
 };
@@ -0,0 +1,247 @@
+#pragma once
+
+#include <algorithm>
+#include <span>
+#include <vector>
+
+#include "Pseudoflow.h"
+
+#include "../../DataStructures/Graph/Graph.h"
+#include "../../DataStructures/MaxFlowMinCut/BreakpointIndex.h"
+#include "../../DataStructures/MaxFlowMinCut/FlowUtils.h"
+#include "../../DataStructures/MaxFlowMinCut/MaxFlowInstance.h"
+
+#include "../../Helpers/Assert.h"
+#include "../../Helpers/String/String.h"
+#include "../../Helpers/Timer.h"
+#include "../../Helpers/Types.h"
+
+/**
+ * Computes all breakpoints of a source-sink monotone parametric instance with the pseudoflow algorithm.
+ * The breakpoints are found by the same divide and conquer as in the chord scheme: the cuts at the ends of an interval
+ * fix all vertices outside of it, and the interval is split at the intersection of their capacity functions. Instead
+ * of building contracted graphs, all subproblems run on the original graph, and the fixed vertices are only marked as
+ * source or sink side. This allows every subproblem to start from the flow of the cut at the left end of its interval,
+ * as in the parametric pseudoflow algorithm of Hochbaum: raising alpha only adds excess, which is why the flow on the
+ * interior arcs stays valid. The right half of an interval continues with the flow of the split point, the left half
+ * restores the flow from before, which is saved for the vertices that moved to the source side.
+ * Like ParametricIBFS, only arcs incident to the source or the sink may depend on alpha.
+ */
+template<pmf::flowFunction FLOW_FUNCTION, bool MEASUREMENTS = false>
+class ParametricPseudoflow {
+public:
+    using FlowFunction = FLOW_FUNCTION;
+    using FlowType = FlowFunction::FlowType;
+    using ParametricInstance = ParametricMaxFlowInstance<FlowFunction>;
+    using GraphType = ParametricInstance::GraphType;
+    using Core = HighestLabelPseudoflow<GraphType, FlowType>;
+    using Side = Core::Side;
+
+private:
+    // The vertices of a subproblem, split by the minimum cut at some alpha, and the capacity function of that cut.
+    struct Split {
+        std::vector<Vertex> sourceSide;
+        std::vector<Vertex> sinkSide;
+        FlowFunction cutCapacity;
+    };
+
+public:
+    explicit ParametricPseudoflow(const ParametricInstance& instance) :
+        instance(instance),
+        graph(instance.graph),
+        breakpointOfVertex(instance.graph.numVertices(), INFTY) {
+    }
+
+    inline void run() noexcept {
+        Timer timer;
+        core.initialize(graph.numVertices(), graph.numEdges());
+        for (const Edge edge : graph.edges()) {
+            core.residualCapacity[edge] = instance.getCapacity(edge, instance.alphaMin);
+        }
+        core.side[instance.source] = Side::Source;
+        core.side[instance.sink] = Side::Sink;
+        std::vector<Vertex> interior;
+        for (const Vertex vertex : graph.vertices()) {
+            if (vertex != instance.source && vertex != instance.sink) interior.emplace_back(vertex);
+        }
+
+        // Every vertex starts on the sink side, so the initial cut consists of the source arcs.
+        FlowFunction sourceCut(0);
+        for (const Edge edge : graph.edgesFrom(instance.source)) {
+            sourceCut += graph.get(Capacity, edge);
+        }
+        Split splitMin = solve(interior, instance.alphaMin, sourceCut);
+        discardSavedFlow(splitMin.sourceSide);
+        setSide(splitMin.sourceSide, Side::Source);
+        setBreakpoints(splitMin.sourceSide, instance.alphaMin);
+        breakpointOfVertex[instance.source] = instance.alphaMin;
+
+        Split splitMax = solve(splitMin.sinkSide, instance.alphaMax, splitMin.cutCapacity);
+        setSide(splitMax.sinkSide, Side::Sink);
+        restoreSavedFlow(splitMax.sourceSide);
+        setSide(splitMax.sourceSide, Side::Interior);
+        recurse(instance.alphaMin, instance.alphaMax, splitMax.sourceSide, splitMin.cutCapacity, splitMax.cutCapacity);
+
+        breakpointIndex.build(instance, breakpointOfVertex);
+        if constexpr (MEASUREMENTS) {
+            totalTime = timer.elapsedMicroseconds();
+            std::cout << "Flow time: " << String::musToString(flowTime) << std::endl;
+            std::cout << "Total time: " << String::musToString(totalTime) << std::endl;
+            std::cout << "#Subproblems: " << numSubproblems << std::endl;
+            std::cout << "#Vertices (total): " << totalVertices << std::endl;
+            std::cout << "#Merges: " << core.getNumMerges() << std::endl;
+            std::cout << "#Relabels: " << core.getNumRelabels() << std::endl;
+        }
+    }
+
+    inline const std::vector<double>& getBreakpoints() const noexcept {
+        return breakpointIndex.getBreakpoints();
+    }
+
+    inline const std::vector<double>& getVertexBreakpoints() const noexcept {
+        return breakpointOfVertex;
+    }
+
+    // The vertices are ordered by breakpoint, not by id.
+    inline std::span<const Vertex> getSinkComponent(const double alpha) const noexcept {
+        return breakpointIndex.getSinkComponent(alpha);
+    }
+
+    inline double getFlowValue(const double alpha) const noexcept {
+        return breakpointIndex.getFlowValue(alpha);
+    }
+
+    inline double getFlowTime() const noexcept {
+        return flowTime;
+    }
+
+    inline size_t getNumSubproblems() const noexcept {
+        return numSubproblems;
+    }
+
+    inline long long getTotalVertices() const noexcept {
+        return totalVertices;
+    }
+
+private:
+    // The interior vertices are those of the interval (left, right). They start with the flow of the cut at left.
+    inline void recurse(const double left, const double right, const std::vector<Vertex>& interior, const FlowFunction& leftCut, const FlowFunction& rightCut) noexcept {
+        if (interior.empty()) return;
+        const double mid = findIntersectionPoint(leftCut, rightCut);
+        if (mid <= left || mid >= right) {
+            setBreakpoints(interior, left);
+            return;
+        }
+
+        Split split = solve(interior, mid, leftCut);
+        const double oldValue = leftCut.eval(mid);
+        const double newValue = split.cutCapacity.eval(mid);
+        // At a breakpoint, the minimal sink component of the split point is that of the right end, so no interior vertex
+        // stays on the sink side.
+        if (split.sinkSide.empty() || oldValue <= newValue) {
+            discardSavedFlow(split.sourceSide);
+            setBreakpoints(interior, mid);
+            return;
+        }
+
+        setSide(split.sourceSide, Side::Source);
+        recurse(mid, right, split.sinkSide, split.cutCapacity, rightCut);
+        setSide(split.sinkSide, Side::Sink);
+        restoreSavedFlow(split.sourceSide);
+        setSide(split.sourceSide, Side::Interior);
+        recurse(left, mid, split.sourceSide, leftCut, split.cutCapacity);
+    }
+
+    // Computes the minimum cut at alpha, starting from the current flow of the interior. The residual capacities
+    // from before are saved for the vertices that end up on the source side. The capacity of the new cut is derived
+    // from the previous one by moving these vertices to the source side.
+    inline Split solve(const std::vector<Vertex>& interior, const double alpha, const FlowFunction& previousCut) noexcept {
+        Timer timer;
+        const size_t frame = savedResidualCapacity.size();
+        for (const Vertex vertex : interior) {
+            for (const Edge edge : graph.edgesFrom(vertex)) {
+                savedResidualCapacity.emplace_back(core.residualCapacity[edge]);
+            }
+        }
+        core.run(graph, interior, [&](const Edge edge) {
+            return instance.getCapacity(edge, alpha);
+        });
+        if constexpr (MEASUREMENTS) {
+            flowTime += timer.elapsedMicroseconds();
+            numSubproblems++;
+            totalVertices += interior.size();
+        }
+
+        Split split;
+        split.cutCapacity = previousCut;
+        size_t read = frame;
+        size_t write = frame;
+        for (const Vertex vertex : interior) {
+            if (core.inSinkComponent[vertex]) {
+                split.sinkSide.emplace_back(vertex);
+                read += graph.outDegree(vertex);
+                continue;
+            }
+            split.sourceSide.emplace_back(vertex);
+            for (const Edge edge : graph.edgesFrom(vertex)) {
+                savedResidualCapacity[write++] = savedResidualCapacity[read++];
+                const Vertex to = graph.get(ToVertex, edge);
+                if (core.side[to] == Side::Source) {
+                    split.cutCapacity -= graph.get(Capacity, graph.get(ReverseEdge, edge));
+                } else if (core.side[to] == Side::Sink || core.inSinkComponent[to]) {
+                    split.cutCapacity += graph.get(Capacity, edge);
+                }
+            }
+        }
+        savedResidualCapacity.resize(write);
+        return split;
+    }
+
+    inline void restoreSavedFlow(const std::vector<Vertex>& vertices) noexcept {
+        size_t i = savedResidualCapacity.size() - numEdgesFrom(vertices);
+        const size_t frame = i;
+        for (const Vertex vertex : vertices) {
+            for (const Edge edge : graph.edgesFrom(vertex)) {
+                core.residualCapacity[edge] = savedResidualCapacity[i++];
+            }
+        }
+        savedResidualCapacity.resize(frame);
+    }
+
+    inline void discardSavedFlow(const std::vector<Vertex>& vertices) noexcept {
+        savedResidualCapacity.resize(savedResidualCapacity.size() - numEdgesFrom(vertices));
+    }
+
+    inline size_t numEdgesFrom(const std::vector<Vertex>& vertices) const noexcept {
+        size_t result = 0;
+        for (const Vertex vertex : vertices) {
+            result += graph.outDegree(vertex);
+        }
+        return result;
+    }
+
+    inline void setSide(const std::vector<Vertex>& vertices, const Side side) noexcept {
+        for (const Vertex vertex : vertices) {
+            core.side[vertex] = side;
+        }
+    }
+
+    inline void setBreakpoints(const std::vector<Vertex>& vertices, const double breakpoint) noexcept {
+        for (const Vertex vertex : vertices) {
+            breakpointOfVertex[vertex] = breakpoint;
+        }
+    }
+
+private:
+    const ParametricInstance& instance;
+    const GraphType& graph;
+    Core core;
+    std::vector<FlowType> savedResidualCapacity;
+    BreakpointIndex<FlowFunction> breakpointIndex;
+    std::vector<double> breakpointOfVertex;
+
+    double flowTime = 0;
+    double totalTime = 0;
+    size_t numSubproblems = 0;
+    long long totalVertices = 0;
+};
@@ -0,0 +1,453 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include "../../DataStructures/Graph/Graph.h"
+#include "../../DataStructures/MaxFlowMinCut/FlowUtils.h"
+#include "../../DataStructures/MaxFlowMinCut/MaxFlowInstance.h"
+
+#include "../../Helpers/Assert.h"
+#include "../../Helpers/Timer.h"
+#include "../../Helpers/Types.h"
+
+/**
+ * Phase one of Hochbaum's pseudoflow algorithm (HPF) with highest-label selection, as in the reference implementation
+ * by Chandran and Hochbaum. It runs on the interior vertices of a graph; all other vertices are contracted into the
+ * source or the sink, as given by side. Arcs between the interior and a terminal side are kept saturated, so the
+ * terminals only show up as excesses and deficits of the interior vertices. The residual capacities of the interior
+ * arcs are taken as they are, which allows a warm start from the flow of an earlier run.
+ * The interior vertices form a forest of normalized trees, whose roots carry the excess or deficit of the tree. The
+ * highest-labeled strong root is repeatedly picked, and its tree is searched for a residual arc into a vertex whose
+ * label is one lower. If there is one, the tree is hung below it and the excess is pushed to the new root, splitting
+ * the path at saturated arcs. Otherwise, all vertices of the tree with the root's label are relabeled. Trees above an
+ * empty label can never reach a deficit and are moved to the source side.
+ * Labels are recomputed by a BFS towards the deficits at the start of every run, so they are valid for any residual
+ * capacities. The sink component is the set of vertices that can reach a deficit, which is the minimal sink component
+ * of every maximum flow derived from the final pseudoflow. Phase two is not needed for the cut.
+ */
+template<typename GRAPH, typename FLOW_TYPE>
+class HighestLabelPseudoflow {
+public:
+    using GraphType = GRAPH;
+    using FlowType = FLOW_TYPE;
+
+    enum class Side : uint8_t {
+        Interior,
+        Source,
+        Sink
+    };
+
+public:
+    // Resets all vertices to the interior. The residual capacities are left to the caller.
+    inline void initialize(const size_t numVertices, const size_t numEdges) noexcept {
+        n = numVertices;
+        residualCapacity.resize(numEdges);
+        side.assign(n, Side::Interior);
+        inSinkComponent.assign(n, false);
+        excess.assign(n, 0);
+        label.assign(n, 0);
+        labelCount.assign(n + 1, 0);
+        parent.assign(n, noVertex);
+        parentEdge.assign(n, noEdge);
+        firstChild.assign(n, noVertex);
+        nextSibling.assign(n, noVertex);
+        previousSibling.assign(n, noVertex);
+        nextScan.assign(n, noVertex);
+        currentEdge.assign(n, noEdge);
+        bucket.assign(n + 1, noVertex);
+        nextInBucket.assign(n, noVertex);
+        highestLabel = 0;
+    }
+
+    // Saturates the arcs between the interior and the terminal sides at the given capacities and computes a minimum
+    // cut of the contracted graph. Afterwards, inSinkComponent is set for all interior vertices.
+    template<typename CAPACITY>
+    inline void run(const GraphType& graph, const std::vector<Vertex>& interior, const CAPACITY& capacity) noexcept {
+        saturateBoundary(graph, interior, capacity);
+        computeLabels(graph, interior);
+        for (Vertex root = getHighestStrongRoot(); root != noVertex; root = getHighestStrongRoot()) {
+            processRoot(graph, root);
+        }
+        computeSinkComponent(graph, interior);
+        for (const Vertex vertex : interior) {
+            labelCount[label[vertex]] = 0;
+        }
+        highestLabel = 0;
+    }
+
+    inline size_t getNumMerges() const noexcept {
+        return numMerges;
+    }
+
+    inline size_t getNumRelabels() const noexcept {
+        return numRelabels;
+    }
+
+private:
+    template<typename CAPACITY>
+    inline void saturateBoundary(const GraphType& graph, const std::vector<Vertex>& interior, const CAPACITY& capacity) noexcept {
+        for (const Vertex vertex : interior) {
+            excess[vertex] = 0;
+            for (const Edge edge : graph.edgesFrom(vertex)) {
+                const Vertex to = graph.get(ToVertex, edge);
+                if (side[to] != Side::Interior) {
+                    const Edge reverseEdge = graph.get(ReverseEdge, edge);
+                    const FlowType total = capacity(edge) + capacity(reverseEdge);
+                    residualCapacity[edge] = (side[to] == Side::Source) ? total : 0;
+                    residualCapacity[reverseEdge] = total - residualCapacity[edge];
+                }
+                excess[vertex] += residualCapacity[edge] - capacity(edge);
+            }
+        }
+    }
+
+    // Sets every label to the residual distance to the nearest deficit. Vertices that cannot reach a deficit are on
+    // the source side of every minimum cut, so they are lifted right away.
+    inline void computeLabels(const GraphType& graph, const std::vector<Vertex>& interior) noexcept {
+        queue.clear();
+        for (const Vertex vertex : interior) {
+            parent[vertex] = noVertex;
+            firstChild[vertex] = noVertex;
+            currentEdge[vertex] = graph.beginEdgeFrom(vertex);
+            if (pmf::isNumberNegative(excess[vertex])) {
+                label[vertex] = 0;
+                queue.emplace_back(vertex);
+            } else {
+                label[vertex] = n;
+            }
+        }
+        for (size_t i = 0; i < queue.size(); i++) {
+            const Vertex vertex = queue[i];
+            for (const Edge edge : graph.edgesFrom(vertex)) {
+                const Vertex from = graph.get(ToVertex, edge);
+                if (side[from] != Side::Interior || label[from] != n) continue;
+                if (!pmf::isNumberPositive(residualCapacity[graph.get(ReverseEdge, edge)])) continue;
+                label[from] = label[vertex] + 1;
+                queue.emplace_back(from);
+            }
+        }
+        for (const Vertex vertex : queue) {
+            labelCount[label[vertex]]++;
+            if (pmf::isNumberPositive(excess[vertex])) addToBucket(vertex);
+        }
+    }
+
+    inline void addToBucket(const Vertex root) noexcept {
+        nextInBucket[root] = bucket[label[root]];
+        bucket[label[root]] = root;
+        highestLabel = std::max(highestLabel, label[root]);
+    }
+
+    // Strong roots above an empty label are lifted instead of being returned.
+    inline Vertex getHighestStrongRoot() noexcept {
+        for (int i = highestLabel; i >= 0; i--) {
+            if (bucket[i] == noVertex) continue;
+            if (i > 0 && labelCount[i - 1] == 0) {
+                while (bucket[i] != noVertex) {
+                    const Vertex root = bucket[i];
+                    bucket[i] = nextInBucket[root];
+                    liftTree(root);
+                }
+                continue;
+            }
+            highestLabel = i;
+            const Vertex root = bucket[i];
+            bucket[i] = nextInBucket[root];
+            return root;
+        }
+        highestLabel = 0;
+        return noVertex;
+    }
+
+    // Searches the vertices of the tree that share the label of the root in depth-first order. A vertex is relabeled
+    // once none of its children with the same label is left, so labels never decrease from a root towards the leaves.
+    inline void processRoot(const GraphType& graph, const Vertex root) noexcept {
+        const int rootLabel = label[root];
+        Vertex vertex = root;
+        nextScan[root] = firstChild[root];
+        if (mergeIfPossible(graph, root, root)) return;
+        while (true) {
+            while (nextScan[vertex] != noVertex && label[nextScan[vertex]] != rootLabel) {
+                nextScan[vertex] = nextSibling[nextScan[vertex]];
+            }
+            if (nextScan[vertex] != noVertex) {
+                const Vertex child = nextScan[vertex];
+                nextScan[vertex] = nextSibling[child];
+                vertex = child;
+                nextScan[vertex] = firstChild[vertex];
+                if (mergeIfPossible(graph, root, vertex)) return;
+            } else {
+                relabel(graph, vertex);
+                if (vertex == root) break;
+                vertex = parent[vertex];
+            }
+        }
+        addToBucket(root);
+    }
+
+    inline bool mergeIfPossible(const GraphType& graph, const Vertex root, const Vertex vertex) noexcept {
+        const int targetLabel = label[vertex] - 1;
+        if (targetLabel < 0) return false;
+        for (Edge edge = currentEdge[vertex]; edge < graph.endEdgeFrom(vertex); edge++) {
+            const Vertex to = graph.get(ToVertex, edge);
+            if (side[to] != Side::Interior || label[to] != targetLabel) continue;
+            if (!pmf::isNumberPositive(residualCapacity[edge])) continue;
+            currentEdge[vertex] = edge;
+            merge(graph, vertex, to, edge);
+            pushExcess(graph, root);
+            return true;
+        }
+        currentEdge[vertex] = graph.endEdgeFrom(vertex);
+        return false;
+    }
+
+    inline void relabel(const GraphType& graph, const Vertex vertex) noexcept {
+        labelCount[label[vertex]]--;
+        label[vertex]++;
+        Assert(label[vertex] < n, "Label of vertex " << vertex << " is too high!");
+        labelCount[label[vertex]]++;
+        currentEdge[vertex] = graph.beginEdgeFrom(vertex);
+        numRelabels++;
+    }
+
+    // Hangs the tree of the strong vertex below the weak vertex, reversing the path from the strong vertex to its root.
+    inline void merge(const GraphType& graph, const Vertex strongVertex, const Vertex weakVertex, const Edge edge) noexcept {
+        Vertex vertex = strongVertex;
+        Vertex newParent = weakVertex;
+        Edge newParentEdge = edge;
+        while (parent[vertex] != noVertex) {
+            const Vertex oldParent = parent[vertex];
+            const Edge oldParentEdge = parentEdge[vertex];
+            removeChild(oldParent, vertex);
+            addChild(newParent, vertex, newParentEdge);
+            newParent = vertex;
+            newParentEdge = graph.get(ReverseEdge, oldParentEdge);
+            vertex = oldParent;
+        }
+        addChild(newParent, vertex, newParentEdge);
+        numMerges++;
+    }
+
+    // Pushes the excess of the former root up to the new root. A saturated arc splits off its lower part as a new strong tree.
+    inline void pushExcess(const GraphType& graph, const Vertex formerRoot) noexcept {
+        Vertex vertex = formerRoot;
+        FlowType parentExcess = 0;
+        while (pmf::isNumberPositive(excess[vertex]) && parent[vertex] != noVertex) {
+            const Vertex p = parent[vertex];
+            const Edge edge = parentEdge[vertex];
+            const Edge reverseEdge = graph.get(ReverseEdge, edge);
+            parentExcess = excess[p];
+            const FlowType flow = std::min(excess[vertex], residualCapacity[edge]);
+            residualCapacity[edge] -= flow;
+            residualCapacity[reverseEdge] += flow;
+            excess[vertex] -= flow;
+            excess[p] += flow;
+            if (pmf::isNumberPositive(excess[vertex])) {
+                removeChild(p, vertex);
+                addToBucket(vertex);
+            } else {
+                excess[p] += excess[vertex];
+                excess[vertex] = 0;
+            }
+            vertex = p;
+        }
+        if (parent[vertex] == noVertex && pmf::isNumberPositive(excess[vertex]) && !pmf::isNumberPositive(parentExcess)) {
+            addToBucket(vertex);
+        }
+    }
+
+    inline void liftTree(const Vertex root) noexcept {
+        queue.assign(1, root);
+        for (size_t i = 0; i < queue.size(); i++) {
+            const Vertex vertex = queue[i];
+            labelCount[label[vertex]]--;
+            label[vertex] = n;
+            for (Vertex child = firstChild[vertex]; child != noVertex; child = nextSibling[child]) {
+                queue.emplace_back(child);
+            }
+        }
+    }
+
+    inline void addChild(const Vertex p, const Vertex child, const Edge edge) noexcept {
+        parent[child] = p;
+        parentEdge[child] = edge;
+        previousSibling[child] = noVertex;
+        nextSibling[child] = firstChild[p];
+        if (firstChild[p] != noVertex) previousSibling[firstChild[p]] = child;
+        firstChild[p] = child;
+    }
+
+    inline void removeChild(const Vertex p, const Vertex child) noexcept {
+        if (previousSibling[child] == noVertex) {
+            firstChild[p] = nextSibling[child];
+        } else {
+            nextSibling[previousSibling[child]] = nextSibling[child];
+        }
+        if (nextSibling[child] != noVertex) previousSibling[nextSibling[child]] = previousSibling[child];
+        parent[child] = noVertex;
+    }
+
+    inline void computeSinkComponent(const GraphType& graph, const std::vector<Vertex>& interior) noexcept {
+        queue.clear();
+        for (const Vertex vertex : interior) {
+            inSinkComponent[vertex] = pmf::isNumberNegative(excess[vertex]);
+            if (inSinkComponent[vertex]) queue.emplace_back(vertex);
+        }
+        for (size_t i = 0; i < queue.size(); i++) {
+            for (const Edge edge : graph.edgesFrom(queue[i])) {
+                const Vertex from = graph.get(ToVertex, edge);
+                if (side[from] != Side::Interior || inSinkComponent[from]) continue;
+                if (!pmf::isNumberPositive(residualCapacity[graph.get(ReverseEdge, edge)])) continue;
+                Assert(!pmf::isNumberPositive(excess[from]), "Vertex " << from << " with excess can reach a deficit!");
+                inSinkComponent[from] = true;
+                queue.emplace_back(from);
+            }
+        }
+    }
+
+public:
+    std::vector<FlowType> residualCapacity;
+    std::vector<Side> side;
+    std::vector<bool> inSinkComponent;
+
+private:
+    int n = 0;
+    std::vector<FlowType> excess;
+    std::vector<int> label;
+    std::vector<int> labelCount;
+    std::vector<Vertex> parent;
+    std::vector<Edge> parentEdge;
+    std::vector<Vertex> firstChild;
+    std::vector<Vertex> nextSibling;
+    std::vector<Vertex> previousSibling;
+    std::vector<Vertex> nextScan;
+    std::vector<Edge> currentEdge;
+    std::vector<Vertex> bucket;
+    std::vector<Vertex> nextInBucket;
+    int highestLabel = 0;
+    std::vector<Vertex> queue;
+
+    size_t numMerges = 0;
+    size_t numRelabels = 0;
+};
+
+/**
+ * Static maximum-flow solver based on the pseudoflow algorithm. It provides the same interface as PushRelabel, so it
+ * can be used as the search algorithm of the chord scheme.
+ */
+template<typename MAX_FLOW_INSTANCE, bool MEASUREMENTS = false>
+class Pseudoflow {
+
+public:
+    using MaxFlowInstance = MAX_FLOW_INSTANCE;
+    using FlowType = MaxFlowInstance::FlowType;
+    using GraphType = MaxFlowInstance::GraphType;
+    using Core = HighestLabelPseudoflow<GraphType, FlowType>;
+    using Side = Core::Side;
+
+public:
+    explicit Pseudoflow(const MaxFlowInstance& instance) {
+        reset(instance);
+    }
+
+    // Re-targets the algorithm to another instance, reusing the memory of earlier runs.
+    inline void reset(const MaxFlowInstance& newInstance) noexcept {
+        instance = &newInstance;
+        graph = &newInstance.graph;
+        sourceVertex = newInstance.source;
+        sinkVertex = newInstance.sink;
+        flowValue = 0;
+        inSinkComponent.assign(graph->numVertices(), false);
+    }
+
+public:
+    inline void run() noexcept {
+        if constexpr (MEASUREMENTS) timer.restart();
+        core.initialize(graph->numVertices(), graph->numEdges());
+        core.residualCapacity = instance->getCurrentCapacities();
+        core.side[sourceVertex] = Side::Source;
+        core.side[sinkVertex] = Side::Sink;
+        interior.clear();
+        for (const Vertex vertex : graph->vertices()) {
+            if (vertex != sourceVertex && vertex != sinkVertex) interior.emplace_back(vertex);
+        }
+        core.run(*graph, interior, [&](const Edge edge) {
+            return instance->getCapacity(edge);
+        });
+        for (const Vertex vertex : interior) {
+            inSinkComponent[vertex] = core.inSinkComponent[vertex];
+        }
+        inSinkComponent[sourceVertex] = false;
+        inSinkComponent[sinkVertex] = true;
+        flowValue = 0;
+        for (const Edge edge : getCutEdges()) {
+            flowValue += instance->getCapacity(edge);
+        }
+        if constexpr (MEASUREMENTS) flowTime += timer.elapsedMicroseconds();
+    }
+
+    inline std::vector<Vertex> getSourceComponent() const noexcept {
+        std::vector<Vertex> component;
+        for (const Vertex vertex : graph->vertices()) {
+            if (!inSinkComponent[vertex]) component.emplace_back(vertex);
+        }
+        return component;
+    }
+
+    inline std::vector<Vertex> getSinkComponent() const noexcept {
+        std::vector<Vertex> component;
+        for (const Vertex vertex : graph->vertices()) {
+            if (inSinkComponent[vertex]) component.emplace_back(vertex);
+        }
+        return component;
+    }
+
+    inline const std::vector<bool>& getInSinkComponent() const noexcept {
+        return inSinkComponent;
+    }
+
+    inline std::vector<Edge> getCutEdges() const noexcept {
+        std::vector<Edge> edges;
+        for (const Vertex vertex : graph->vertices()) {
+            if (inSinkComponent[vertex]) continue;
+            for (const Edge edge : graph->edgesFrom(vertex)) {
+                const Vertex to = graph->get(ToVertex, edge);
+                if (!inSinkComponent[to]) continue;
+                edges.emplace_back(edge);
+            }
+        }
+        return edges;
+    }
+
+    // The capacity of the minimum cut, since phase two is skipped.
+    inline FlowType getFlowValue() const noexcept {
+        return flowValue;
+    }
+
+    inline double getFlowTime() const noexcept {
+        return flowTime;
+    }
+
+    inline size_t getNumMerges() const noexcept {
+        return core.getNumMerges();
+    }
+
+    inline size_t getNumRelabels() const noexcept {
+        return core.getNumRelabels();
+    }
+
+private:
+    const MaxFlowInstance* instance;
+    const GraphType* graph;
+    Vertex sourceVertex;
+    Vertex sinkVertex;
+    Core core;
+    std::vector<Vertex> interior;
+    std::vector<bool> inSinkComponent;
+    FlowType flowValue;
+
+    double flowTime = 0;
+    Timer timer;
+};
@@ -1,8 +1,13 @@
 #pragma once
 
+#include <atomic>
+#include <numeric>
 #include <queue>
+#include <type_traits>
 #include <vector>
 
+#include "ParallelResidualBFS.h"
+
 #include "../../DataStructures/Graph/Graph.h"
 #include "../../DataStructures/MaxFlowMinCut/MaxFlowInstance.h"
 
@@ -10,7 +15,10 @@
 #include "../../Helpers/Types.h"
 #include "../../Helpers/Vector/Vector.h"
 
-template<typename MAX_FLOW_INSTANCE, bool MEASUREMENTS = false>
+// With PARALLEL_BFS, the global distance updates and the final cut are computed by a ParallelResidualBFS, and the
+// vertex buckets are rebuilt in parallel, using the number of threads passed to the constructor (default 1). Without
+// PARALLEL_BFS, the solver is sequential and keeps no parallel state.
+template<typename MAX_FLOW_INSTANCE, bool MEASUREMENTS = false, bool PARALLEL_BFS = false>
 class PushRelabel {
 
 public:
@@ -21,12 +29,31 @@ public:
 private:
     inline static constexpr int VertexToEdgeRatio = 12;
 
+    // Stands in for the ParallelResidualBFS of a sequential solver.
+    struct NoBFS {
+        explicit NoBFS(const size_t) noexcept {}
+    };
+
 public:
     struct VertexBuckets {
         VertexBuckets(const int n) :
             activeVertices(n), inactiveVertices(n), isVertexActive(n, false), positionOfVertex(Vector::id<int>(n)), maxActiveBucket(-1), maxBucket(-1) {
         }
 
+        inline void reset(const int n) noexcept {
+            activeVertices.resize(n);
+            inactiveVertices.resize(n);
+            for (int i = 0; i < n; i++) {
+                activeVertices[i].clear();
+                inactiveVertices[i].clear();
+            }
+            isVertexActive.assign(n, false);
+            positionOfVertex.resize(n);
+            std::iota(positionOfVertex.begin(), positionOfVertex.end(), 0);
+            maxActiveBucket = -1;
+            maxBucket = -1;
+        }
+
         inline void initialize(const int sink) {
             for (int i = 0; static_cast<size_t>(i) < isVertexActive.size(); i++) {
                 if (i == sink) continue;
@@ -55,6 +82,54 @@ public:
             }
         }
 
+        // Same as rebuild(), but the buckets are sized by a parallel counting pass and then filled in parallel.
+        // The order of the vertices within a bucket is unspecified.
+        inline void rebuildParallel(const std::vector<int>& distances, const int sink, const size_t numThreads) {
+            if (numThreads == 1) {
+                rebuild(distances, sink);
+                return;
+            }
+            const int numBuckets = activeVertices.size();
+            const int numVertices = isVertexActive.size();
+            activeCount.assign(numBuckets, 0);
+            inactiveCount.assign(numBuckets, 0);
+            int newMaxActiveBucket = -1;
+            int newMaxBucket = -1;
+            #pragma omp parallel for num_threads(numThreads) schedule(static) reduction(max: newMaxActiveBucket, newMaxBucket)
+            for (int i = 0; i < numVertices; i++) {
+                if (i == sink || distances[i] == numBuckets) continue;
+                newMaxBucket = std::max(newMaxBucket, distances[i]);
+                if (isVertexActive[i]) {
+                    std::atomic_ref<int>(activeCount[distances[i]]).fetch_add(1, std::memory_order_relaxed);
+                    newMaxActiveBucket = std::max(newMaxActiveBucket, distances[i]);
+                } else {
+                    std::atomic_ref<int>(inactiveCount[distances[i]]).fetch_add(1, std::memory_order_relaxed);
+                }
+            }
+            maxActiveBucket = newMaxActiveBucket;
+            maxBucket = newMaxBucket;
+
+            #pragma omp parallel for num_threads(numThreads) schedule(static)
+            for (int d = 0; d < numBuckets; d++) {
+                activeVertices[d].resize(activeCount[d]);
+                inactiveVertices[d].resize(inactiveCount[d]);
+                activeCount[d] = 0;
+                inactiveCount[d] = 0;
+            }
+
+            #pragma omp parallel for num_threads(numThreads) schedule(static)
+            for (int i = 0; i < numVertices; i++) {
+                if (i == sink || distances[i] == numBuckets) continue;
+                if (isVertexActive[i]) {
+                    positionOfVertex[i] = std::atomic_ref<int>(activeCount[distances[i]]).fetch_add(1, std::memory_order_relaxed);
+                    activeVertices[distances[i]][positionOfVertex[i]] = Vertex(i);
+                } else {
+                    positionOfVertex[i] = std::atomic_ref<int>(inactiveCount[distances[i]]).fetch_add(1, std::memory_order_relaxed);
+                    inactiveVertices[distances[i]][positionOfVertex[i]] = Vertex(i);
+                }
+            }
+        }
+
         inline void activateVertex(const Vertex vertex, const int dist) noexcept {
             Assert(checkInvariant(vertex, dist), "Vertex position is invalid");
             if (isVertexActive[vertex]) return;
@@ -132,11 +207,18 @@ public:
         std::vector<int> positionOfVertex;
         int maxActiveBucket;
         int maxBucket;
+        // Bucket sizes and fill positions of rebuildParallel().
+        std::vector<int> activeCount;
+        std::vector<int> inactiveCount;
     };
 
     struct Cut {
         Cut(const int n) : inSinkComponent(n, false) {}
 
+        inline void reset(const int n) noexcept {
+            inSinkComponent.assign(n, false);
+        }
+
         inline std::vector<Vertex> getSourceComponent() const noexcept {
             std::vector<Vertex> component;
             for (size_t i = 0; i < inSinkComponent.size(); i++) {
@@ -157,10 +239,11 @@ public:
     };
 
 public:
-    explicit PushRelabel(const MaxFlowInstance& instance) :
-        instance(instance),
-        graph(instance.graph),
-        n(graph.numVertices()),
+    explicit PushRelabel(const MaxFlowInstance& instance, const size_t numThreads = 1) :
+        numThreads(std::max<size_t>(numThreads, 1)),
+        instance(&instance),
+        graph(&instance.graph),
+        n(graph->numVertices()),
         sourceVertex(instance.source),
         sinkVertex(instance.sink),
         residualCapacity(instance.getCurrentCapacities()),
@@ -169,13 +252,34 @@ public:
         currentEdge(n, noEdge),
         vertexBuckets(n),
         workSinceLastUpdate(0),
-        workLimit(VertexToEdgeRatio * graph.numVertices() + graph.numEdges()),
-        cut(n) {
-        for (const Vertex vertex : graph.vertices()) {
-            currentEdge[vertex] = graph.beginEdgeFrom(vertex);
+        workLimit(VertexToEdgeRatio * graph->numVertices() + graph->numEdges()),
+        cut(n),
+        bfs(this->numThreads) {
+        for (const Vertex vertex : graph->vertices()) {
+            currentEdge[vertex] = graph->beginEdgeFrom(vertex);
         }
     }
 
+    // Re-targets the algorithm to another instance, reusing the memory of earlier runs.
+    inline void reset(const MaxFlowInstance& newInstance) noexcept {
+        instance = &newInstance;
+        graph = &newInstance.graph;
+        n = graph->numVertices();
+        sourceVertex = newInstance.source;
+        sinkVertex = newInstance.sink;
+        residualCapacity = newInstance.getCurrentCapacities();
+        distance.assign(n, 0);
+        excess.assign(n, 0);
+        currentEdge.resize(n);
+        for (const Vertex vertex : graph->vertices()) {
+            currentEdge[vertex] = graph->beginEdgeFrom(vertex);
+        }
+        vertexBuckets.reset(n);
+        workSinceLastUpdate = 0;
+        workLimit = VertexToEdgeRatio * graph->numVertices() + graph->numEdges();
+        cut.reset(n);
+    }
+
 public:
     inline void run() noexcept {
         if (MEASUREMENTS) timer.restart();
@@ -209,10 +313,10 @@ public:
 
     inline std::vector<Edge> getCutEdges() const noexcept {
         std::vector<Edge> edges;
-        for (const Vertex vertex : graph.vertices()) {
+        for (const Vertex vertex : graph->vertices()) {
             if (cut.inSinkComponent[vertex]) continue;
-            for (const Edge edge : graph.edgesFrom(vertex)) {
-                const Vertex to = graph.get(ToVertex, edge);
+            for (const Edge edge : graph->edgesFrom(vertex)) {
+                const Vertex to = graph->get(ToVertex, edge);
                 if (!cut.inSinkComponent[to]) continue;
                 edges.emplace_back(edge);
             }
@@ -222,9 +326,9 @@ public:
 
     inline FlowType getFlowValue() const noexcept {
         FlowType flow = 0;
-        for (const Edge edge : graph.edgesFrom(sinkVertex)) {
-            const Edge reverseEdge = graph.get(ReverseEdge, edge);
-            flow += instance.getCapacity(reverseEdge) - residualCapacity[reverseEdge];
+        for (const Edge edge : graph->edgesFrom(sinkVertex)) {
+            const Edge reverseEdge = graph->get(ReverseEdge, edge);
+            flow += instance->getCapacity(reverseEdge) - residualCapacity[reverseEdge];
         }
         return flow;
     }
@@ -241,13 +345,13 @@ private:
     inline void initialize() noexcept {
         vertexBuckets.initialize(sinkVertex);
         distance[sourceVertex] = distance.size();
-        for (const Edge edge : graph.edgesFrom(sourceVertex)) {
-            const FlowType capacity = instance.getCapacity(edge);
+        for (const Edge edge : graph->edgesFrom(sourceVertex)) {
+            const FlowType capacity = instance->getCapacity(edge);
             if (capacity == 0) continue;
-            const Edge reverseEdge = graph.get(ReverseEdge, edge);
+            const Edge reverseEdge = graph->get(ReverseEdge, edge);
             residualCapacity[edge] = 0;
             residualCapacity[reverseEdge] += capacity;
-            const Vertex to = graph.get(ToVertex, edge);
+            const Vertex to = graph->get(ToVertex, edge);
             excess[to] = capacity;
             makeVertexActive(to);
         }
@@ -269,18 +373,28 @@ private:
         computeCut();
     }
 
-    //TODO: Can this be done faster?
     inline void computeCut() noexcept {
-        std::vector<bool>(n, false).swap(cut.inSinkComponent);
+        if constexpr (PARALLEL_BFS) {
+            bfs.run(*graph, sinkVertex, cutDistance, n, [&](const Vertex, const Edge edge) {
+                return isEdgeResidual(edge);
+            });
+            cut.inSinkComponent.assign(n, false);
+            for (const Vertex vertex : graph->vertices()) {
+                cut.inSinkComponent[vertex] = cutDistance[vertex] < n;
+            }
+            Assert(!cut.inSinkComponent[sourceVertex], "No cut found!");
+            return;
+        }
+        cut.inSinkComponent.assign(n, false);
         std::queue<Vertex> queue;
         queue.push(sinkVertex);
         cut.inSinkComponent[sinkVertex] = true;
         while (!queue.empty()) {
             const Vertex vertex = queue.front();
             queue.pop();
-            for (const Edge edge : graph.edgesFrom(vertex)) {
-                const Vertex to = graph.get(ToVertex, edge);
-                const Edge edgeToSink = graph.get(ReverseEdge, edge);
+            for (const Edge edge : graph->edgesFrom(vertex)) {
+                const Vertex to = graph->get(ToVertex, edge);
+                const Edge edgeToSink = graph->get(ReverseEdge, edge);
                 if (!isEdgeResidual(edgeToSink)) continue;
                 if (!cut.inSinkComponent[to]) {
                     queue.push(to);
@@ -293,15 +407,15 @@ private:
     }
 
     inline void updateCapacities() noexcept {
-        Edge edgeFromSource = graph.beginEdgeFrom(sourceVertex);
-        const std::vector<FlowType>& sourceDiff = instance.getSourceDiff();
+        Edge edgeFromSource = graph->beginEdgeFrom(sourceVertex);
+        const std::vector<FlowType>& sourceDiff = instance->getSourceDiff();
         for (size_t i = 0; i < sourceDiff.size(); i++, edgeFromSource++) {
             Assert(sourceDiff[i] >= 0, "Capacity of source-incident edge has decreased!");
             residualCapacity[edgeFromSource] += sourceDiff[i];
-            const Vertex to = graph.get(ToVertex, edgeFromSource);
+            const Vertex to = graph->get(ToVertex, edgeFromSource);
             if (distance[to] < n && isEdgeResidual(edgeFromSource)) {
                 const FlowType add = residualCapacity[edgeFromSource];
-                const Edge edgeToSource = graph.get(ReverseEdge, edgeFromSource);
+                const Edge edgeToSource = graph->get(ReverseEdge, edgeFromSource);
                 residualCapacity[edgeFromSource] = 0;
                 residualCapacity[edgeToSource] += add;
                 excess[to] += add;
@@ -309,15 +423,15 @@ private:
             }
         }
 
-        Edge edgeFromSink = graph.beginEdgeFrom(sinkVertex);
-        const std::vector<FlowType>& sinkDiff = instance.getSinkDiff();
+        Edge edgeFromSink = graph->beginEdgeFrom(sinkVertex);
+        const std::vector<FlowType>& sinkDiff = instance->getSinkDiff();
         for (size_t i = 0; i < sinkDiff.size(); i++, edgeFromSink++) {
             Assert(sinkDiff[i] <= 0, "Capacity of sink-incident edge has increased!");
-            const Edge edgeToSink = graph.get(ReverseEdge, edgeFromSink);
+            const Edge edgeToSink = graph->get(ReverseEdge, edgeFromSink);
             residualCapacity[edgeToSink] += sinkDiff[i];
             if (pmf::isNumberNegative(residualCapacity[edgeToSink])) {
                 const FlowType add = -residualCapacity[edgeToSink];
-                const Vertex from = graph.get(ToVertex, edgeFromSink);
+                const Vertex from = graph->get(ToVertex, edgeFromSink);
                 residualCapacity[edgeFromSink] -= add;
                 residualCapacity[edgeToSink] = 0;
                 excess[from] += add;
@@ -333,14 +447,14 @@ private:
                 relabel(vertex);
                 break;
             }
-            const Vertex to = graph.get(ToVertex, edge);
+            const Vertex to = graph->get(ToVertex, edge);
             pushFlow(vertex, to, edge);
         }
     }
 
     inline Edge findPushableEdge(const Vertex vertex) noexcept {
-        for (Edge edge = currentEdge[vertex]; edge < graph.endEdgeFrom(vertex); edge++) {
-            const Vertex to = graph.get(ToVertex, edge);
+        for (Edge edge = currentEdge[vertex]; edge < graph->endEdgeFrom(vertex); edge++) {
+            const Vertex to = graph->get(ToVertex, edge);
             if (isEdgeResidual(edge) && isEdgeAdmissible(vertex, to)) {
                 currentEdge[vertex] = edge;
                 return edge;
@@ -351,7 +465,7 @@ private:
 
     inline void pushFlow(const Vertex from, const Vertex to, const Edge edge) noexcept {
         const FlowType flow = std::min(excess[from], residualCapacity[edge]);
-        const Edge reverseEdge = graph.get(ReverseEdge, edge);
+        const Edge reverseEdge = graph->get(ReverseEdge, edge);
         pushFlow(from, to, edge, reverseEdge, flow);
     }
 
@@ -367,10 +481,10 @@ private:
         const int oldDistance = distance[vertex];
         int newDistance = n;
         Edge newAdmissibleEdge = noEdge;
-        workSinceLastUpdate += VertexToEdgeRatio + graph.outDegree(vertex);
-        for (const Edge edge : graph.edgesFrom(vertex)) {
+        workSinceLastUpdate += VertexToEdgeRatio + graph->outDegree(vertex);
+        for (const Edge edge : graph->edgesFrom(vertex)) {
             if (!isEdgeResidual(edge)) continue;
-            const Vertex to = graph.get(ToVertex, edge);
+            const Vertex to = graph->get(ToVertex, edge);
             if (distance[to] + 1 < newDistance) {
                 newDistance = distance[to] + 1;
                 newAdmissibleEdge = edge;
@@ -401,6 +515,17 @@ private:
     }
 
     inline void globalDistanceUpdate() noexcept {
+        if constexpr (PARALLEL_BFS) {
+            bfs.run(*graph, sinkVertex, distance, n, [&](const Vertex, const Edge edge) {
+                return isEdgeResidual(edge);
+            });
+            #pragma omp parallel for num_threads(numThreads) schedule(static)
+            for (int i = 0; i < n; i++) {
+                if (distance[i] < n) currentEdge[i] = graph->beginEdgeFrom(Vertex(i));
+            }
+            vertexBuckets.rebuildParallel(distance, sinkVertex, numThreads);
+            return;
+        }
         Vector::fill(distance, n);
         std::queue<Vertex> Q;
 
@@ -410,12 +535,12 @@ private:
         while (!Q.empty()) {
             const Vertex u = Q.front();
             Q.pop();
-            for (const Edge e : graph.edgesFrom(u)) {
-                const Edge re = graph.get(ReverseEdge, e);
+            for (const Edge e : graph->edgesFrom(u)) {
+                const Edge re = graph->get(ReverseEdge, e);
                 if (!isEdgeResidual(re)) continue;
-                const Vertex v = graph.get(ToVertex, e);
+                const Vertex v = graph->get(ToVertex, e);
                 if (distance[v] < n) continue;
-                currentEdge[v] = graph.beginEdgeFrom(v);
+                currentEdge[v] = graph->beginEdgeFrom(v);
                 distance[v] = std::min(distance[v], distance[u] + 1);
                 Q.push(v);
             }
@@ -425,7 +550,7 @@ private:
     }
 
     inline bool checkBucketInvariants() noexcept {
-        for (const Vertex vertex : graph.vertices()) {
+        for (const Vertex vertex : graph->vertices()) {
             if (vertex == sourceVertex || vertex == sinkVertex) continue;
             if (!vertexBuckets.checkInvariant(vertex, distance[vertex])) return false;
         }
@@ -433,24 +558,24 @@ private:
     }
 
     inline bool checkCurrentEdgeInvariant(const Vertex vertex) const noexcept {
-        for (Edge edge = graph.beginEdgeFrom(vertex); edge < currentEdge[vertex]; edge++) {
-            const Vertex to = graph.get(ToVertex, edge);
+        for (Edge edge = graph->beginEdgeFrom(vertex); edge < currentEdge[vertex]; edge++) {
+            const Vertex to = graph->get(ToVertex, edge);
             if (isEdgeResidual(edge) && isEdgeAdmissible(vertex, to)) return false;
         }
         return true;
     }
 
     inline void checkFlowConservation() const noexcept {
-        for (const Vertex vertex : graph.vertices()) {
+        for (const Vertex vertex : graph->vertices()) {
             checkFlowConservation(vertex);
         }
     }
 
     inline FlowType getInflow(const Vertex vertex) const noexcept {
         FlowType inflow = 0;
-        for (const Edge edge : graph.edgesFrom(vertex)) {
-            const Edge reverseEdge = graph.get(ReverseEdge, edge);
-            inflow += instance.getCapacity(reverseEdge) - residualCapacity[reverseEdge];
+        for (const Edge edge : graph->edgesFrom(vertex)) {
+            const Edge reverseEdge = graph->get(ReverseEdge, edge);
+            inflow += instance->getCapacity(reverseEdge) - residualCapacity[reverseEdge];
         }
         return inflow;
     }
@@ -461,25 +586,29 @@ private:
     }
 
     inline void checkCapacityConstraints() const noexcept {
-        for (const Edge edge : graph.edges()) {
+        for (const Edge edge : graph->edges()) {
             Assert(residualCapacity[edge] >= 0, "Capacity constraint violated!");
         }
     }
 
 private:
-    const MaxFlowInstance& instance;
-    const GraphType& graph;
-    const int n;
-    const Vertex sourceVertex;
-    const Vertex sinkVertex;
+    const size_t numThreads;
+    const MaxFlowInstance* instance;
+    const GraphType* graph;
+    int n;
+    Vertex sourceVertex;
+    Vertex sinkVertex;
     std::vector<FlowType> residualCapacity;
     std::vector<int> distance;
     std::vector<FlowType> excess;
     std::vector<Edge> currentEdge;
     VertexBuckets vertexBuckets;
     int workSinceLastUpdate;
-    const int workLimit;
+    int workLimit;
     Cut cut;
+    [[no_unique_address]] std::conditional_t<PARALLEL_BFS, ParallelResidualBFS<GraphType>, NoBFS> bfs;
+    // Distances of the final BFS, which must not overwrite the labels of a restartable run.
+    std::vector<int> cutDistance;
 
     double updateTime = 0;
     double flowTime = 0;
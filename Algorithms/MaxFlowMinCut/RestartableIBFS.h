@@ -4,6 +4,7 @@
 #include <vector>
 
 #include "../../DataStructures/Graph/Graph.h"
+#include "../../DataStructures/MaxFlowMinCut/DistanceBuckets.h"
 #include "../../DataStructures/MaxFlowMinCut/MaxFlowInstance.h"
 
 #include "../../Helpers/Assert.h"
@@ -19,126 +20,6 @@ public:
     using GraphType = MaxFlowInstance::GraphType;
 
 private:
-    struct ExcessBuckets {
-        ExcessBuckets(const int n) :
-            buckets(n), positionOfVertex(n, -1), maxBucket(-1) {
-        }
-
-        inline void addVertex(const Vertex vertex, const int dist) noexcept {
-            if (positionOfVertex[vertex] != -1) return;
-            positionOfVertex[vertex] = buckets[dist].size();
-            buckets[dist].emplace_back(vertex);
-            maxBucket = std::max(maxBucket, dist);
-        }
-
-        inline void removeVertex(const Vertex vertex, const int dist) noexcept {
-            if (positionOfVertex[vertex] == -1) return;
-            const Vertex other = buckets[dist].back();
-            positionOfVertex[other] = positionOfVertex[vertex];
-            buckets[dist][positionOfVertex[vertex]] = other;
-            buckets[dist].pop_back();
-            positionOfVertex[vertex] = -1;
-            if (maxBucket == dist && buckets[dist].empty()) {
-                while (maxBucket >= 0 && buckets[maxBucket].empty()) maxBucket--;
-            }
-        }
-
-        inline void increaseBucket(const Vertex vertex, const int oldDist, const int newDist) noexcept {
-            Assert(newDist > oldDist, "Distance has not increased!");
-            Assert(static_cast<size_t>(positionOfVertex[vertex]) < buckets[oldDist].size(), "Vertex is not in bucket!");
-            Assert(buckets[oldDist][positionOfVertex[vertex]] == vertex, "Vertex is not in bucket!");
-            const Vertex other = buckets[oldDist].back();
-            positionOfVertex[other] = positionOfVertex[vertex];
-            buckets[oldDist][positionOfVertex[vertex]] = other;
-            buckets[oldDist].pop_back();
-            positionOfVertex[vertex] = buckets[newDist].size();
-            buckets[newDist].emplace_back(vertex);
-            maxBucket = std::max(maxBucket, newDist);
-        }
-
-        inline bool empty() const noexcept {
-            return maxBucket < 0;
-        }
-
-        inline Vertex front() const noexcept {
-            Assert(!empty(), "Buckets are empty!");
-            return buckets[maxBucket].back();
-        }
-
-        std::vector<std::vector<Vertex>> buckets;
-        std::vector<int> positionOfVertex;
-        int maxBucket;
-    };
-
-    struct OrphanBuckets {
-        OrphanBuckets(const int n) :
-            positionOfVertex_(n, -1), minBucket_(INFTY) {
-        }
-
-        inline void assertVertexInBucket(const Vertex vertex, const int dist) const noexcept {
-            Assert(positionOfVertex_[vertex] != -1, "Vertex is not in bucket!");
-            Assert(static_cast<size_t>(dist) < buckets_.size(), "Vertex is not in bucket!");
-            Assert(static_cast<size_t>(positionOfVertex_[vertex]) < buckets_[dist].size(), "Vertex is not in bucket!");
-            Assert(buckets_[dist][positionOfVertex_[vertex]] == vertex, "Vertex is not in bucket!");
-        }
-
-        inline bool contains(const Vertex vertex) const noexcept {
-            return positionOfVertex_[vertex] != -1;
-        }
-
-        inline void addVertex(const Vertex vertex, const int dist) noexcept {
-            if (positionOfVertex_[vertex] != -1) {
-                assertVertexInBucket(vertex, dist);
-                return;
-            }
-            if (static_cast<size_t>(dist) >= buckets_.size()) buckets_.resize(dist + 1);
-            positionOfVertex_[vertex] = buckets_[dist].size();
-            buckets_[dist].emplace_back(vertex);
-            minBucket_ = std::min(minBucket_, dist);
-        }
-
-        inline void decreaseBucket(const Vertex vertex, const int oldDist, const int newDist) noexcept {
-            Assert(newDist < oldDist, "Distance has not decreased!");
-            assertVertexInBucket(vertex, oldDist);
-            const Vertex other = buckets_[oldDist].back();
-            positionOfVertex_[other] = positionOfVertex_[vertex];
-            buckets_[oldDist][positionOfVertex_[vertex]] = other;
-            buckets_[oldDist].pop_back();
-            positionOfVertex_[vertex] = buckets_[newDist].size();
-            buckets_[newDist].emplace_back(vertex);
-            if (static_cast<size_t>(oldDist) == buckets_.size() - 1) {
-                while (!buckets_.empty() && buckets_.back().empty()) buckets_.pop_back();
-            }
-            minBucket_ = std::min(minBucket_, newDist);
-        }
-
-        inline bool empty() const noexcept {
-            return buckets_.empty();
-        }
-
-        inline Vertex front() noexcept {
-            Assert(!empty(), "Buckets are empty!");
-            return buckets_[minBucket_].back();
-        }
-
-        inline Vertex pop() noexcept {
-            Assert(!empty(), "Buckets are empty!");
-            const Vertex vertex = buckets_[minBucket_].back();
-            buckets_[minBucket_].pop_back();
-            positionOfVertex_[vertex] = -1;
-            while (static_cast<size_t>(minBucket_) < buckets_.size() && buckets_[minBucket_].empty()) minBucket_++;
-            if (static_cast<size_t>(minBucket_) == buckets_.size()) {
-                buckets_.clear();
-                minBucket_ = INFTY;
-            }
-            return vertex;
-        }
-
-        std::vector<std::vector<Vertex>> buckets_;
-        std::vector<int> positionOfVertex_;
-        int minBucket_;
-    };
-
     struct TreeData {
         TreeData(const size_t n) :
             parentEdge(n, noEdge),
@@ -801,12 +682,10 @@ private:
 
     template<int DIRECTION>
     inline void checkBuckets() const noexcept {
-        for (size_t i = 0; static_cast<int>(i) <= excessVertices[DIRECTION].maxBucket; i++) {
-            for (const Vertex vertex : excessVertices[DIRECTION].buckets[i]) {
-                Assert(getExcess<DIRECTION>(vertex) > 0, "Vertex in bucket has no excess!");
-                Assert(getDistance<DIRECTION>(vertex) == int(i), "Vertex is in wrong bucket!");
-            }
-        }
+        excessVertices[DIRECTION].forEach([&](const Vertex vertex, const int dist) {
+            Assert(getExcess<DIRECTION>(vertex) > 0, "Vertex in bucket has no excess!");
+            Assert(getDistance<DIRECTION>(vertex) == dist, "Vertex is in wrong bucket!");
+        });
     }
 
     template<int DIRECTION>
@@ -0,0 +1,185 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+#include "../../Helpers/Assert.h"
+
+class MonotoneRadixHeapElement {
+
+public:
+    inline int getHeapBucket() const noexcept {return heapBucket;}
+    inline int getHeapPosition() const noexcept {return heapPosition;}
+    inline void setHeapPosition(const int b, const int p) noexcept {heapBucket = b; heapPosition = p;}
+    inline bool isOnHeap() const noexcept {return heapBucket != -1;}
+    MonotoneRadixHeapElement() : heapBucket(-1), heapPosition(-1) {}
+
+private:
+    int heapBucket;
+    int heapPosition;
+
+};
+
+/**
+ * Radix heap over double keys, for workloads in which no key smaller than the current minimum is ever inserted.
+ * Keys are mapped to their order-preserving 64-bit pattern. Bucket 0 holds the keys equal to the last minimum, bucket i
+ * the keys whose highest bit differing from it is bit i - 1. Push and remove are O(1), front() is O(1) amortized, since
+ * every key moves to a strictly lower bucket whenever it is redistributed.
+ * The element type must inherit from MonotoneRadixHeapElement and provide getKey(). The key of an element may only be
+ * changed while it is not on the heap, or right before calling update() on it.
+ */
+template<typename ELEMENT_TYPE>
+class MonotoneRadixHeap {
+
+public:
+    using ElementType = ELEMENT_TYPE;
+    static constexpr int NumBuckets = 65;
+
+public:
+    MonotoneRadixHeap(const int initialNumberOfElements = 1000) : buckets(NumBuckets), numberOfElements(0), last(0) {
+        static_assert(std::is_base_of<MonotoneRadixHeapElement, ElementType>::value, "Element type must inherit from MonotoneRadixHeapElement");
+        redistributed.reserve(initialNumberOfElements);
+    }
+
+    inline int size() const noexcept {return numberOfElements;}
+    inline bool empty() const noexcept {return size() == 0;}
+
+    inline ElementType* front() noexcept {
+        Assert(!empty(), "An empty heap has no front!");
+        if (buckets[0].empty()) redistribute();
+        return buckets[0].back();
+    }
+
+    // An element whose key equals the minimum found by the last call of front(), or nullptr if none is left. Unlike
+    // front(), this never raises the minimum, so keys between it and the next larger key can still be inserted.
+    inline ElementType* lastMinimum() const noexcept {
+        return buckets[0].empty() ? nullptr : buckets[0].back();
+    }
+
+    // Removes all elements with a key of at most limit and appends them to elements. Like lastMinimum(), this does not
+    // raise the minimum. Every key in a bucket below the one of limit is smaller than limit, so only that bucket is
+    // filtered. Elements with the last minimum come first, in the order in which lastMinimum() would return them.
+    inline void extractUpTo(const double limit, std::vector<ElementType*>& elements) noexcept {
+        const uint64_t limitKey = orderedBits(limit);
+        if (limitKey < last) return;
+        const int limitBucket = bucketOf(limitKey);
+        for (int b = 0; b <= limitBucket; b++) {
+            std::vector<ElementType*>& bucket = buckets[b];
+            for (size_t i = bucket.size(); i-- > 0;) {
+                ElementType* const element = bucket[i];
+                if (b == limitBucket && orderedBits(element->getKey()) > limitKey) continue;
+                remove(element);
+                elements.emplace_back(element);
+            }
+        }
+    }
+
+    inline ElementType& min() noexcept {
+        return *front();
+    }
+
+    inline ElementType* extractFront() noexcept {
+        ElementType* element = front();
+        remove(element);
+        return element;
+    }
+    inline ElementType* pop() noexcept {return extractFront();}
+
+    inline void update(ElementType* const element) noexcept {
+        if (element->isOnHeap()) {
+            removeFromBucket(element);
+        } else {
+            numberOfElements++;
+        }
+        insert(element);
+    }
+    inline void update(ElementType& element) noexcept {update(&element);}
+    inline void push(ElementType* const element) noexcept {update(element);}
+    inline void push(ElementType& element) noexcept {update(&element);}
+
+    inline void remove(ElementType* const element) noexcept {
+        Assert(element->isOnHeap(), "Element is not on heap!");
+        removeFromBucket(element);
+        element->setHeapPosition(-1, -1);
+        numberOfElements--;
+    }
+
+    inline bool contains(const ElementType* const element) const noexcept {
+        return element->isOnHeap();
+    }
+
+    inline void reserve(const int size) noexcept {
+        redistributed.reserve(size);
+    }
+
+    inline void reset() noexcept {
+        clear();
+    }
+
+    inline void clear() noexcept {
+        for (std::vector<ElementType*>& bucket : buckets) {
+            for (ElementType* element : bucket) {
+                element->setHeapPosition(-1, -1);
+            }
+            bucket.clear();
+        }
+        numberOfElements = 0;
+        last = 0;
+    }
+
+private:
+    inline static uint64_t orderedBits(const double key) noexcept {
+        // -0.0 is mapped to the pattern of 0.0, so that keys which compare equal are mapped to the same pattern. This is
+        // done on the bits, since -ffast-math may fold away a floating-point normalization such as key + 0.0.
+        uint64_t bits = std::bit_cast<uint64_t>(key);
+        if ((bits << 1) == 0) bits = 0;
+        return (bits >> 63) ? ~bits : (bits | (uint64_t(1) << 63));
+    }
+
+    inline int bucketOf(const uint64_t key) const noexcept {
+        return (key == last) ? 0 : 64 - std::countl_zero(key ^ last);
+    }
+
+    inline void insert(ElementType* const element) noexcept {
+        const uint64_t key = orderedBits(element->getKey());
+        Assert(key >= last, "Key " << element->getKey() << " is smaller than the last minimum!");
+        const int b = bucketOf(key);
+        element->setHeapPosition(b, buckets[b].size());
+        buckets[b].emplace_back(element);
+    }
+
+    inline void removeFromBucket(ElementType* const element) noexcept {
+        std::vector<ElementType*>& bucket = buckets[element->getHeapBucket()];
+        const int position = element->getHeapPosition();
+        Assert(bucket[position] == element, "Malformed heap!");
+        bucket[position] = bucket.back();
+        bucket[position]->setHeapPosition(element->getHeapBucket(), position);
+        bucket.pop_back();
+    }
+
+    // Moves the minimum to the last minimum and spreads the first non-empty bucket over the lower buckets.
+    inline void redistribute() noexcept {
+        int i = 1;
+        while (buckets[i].empty()) i++;
+        uint64_t minKey = orderedBits(buckets[i][0]->getKey());
+        for (const ElementType* element : buckets[i]) {
+            minKey = std::min(minKey, orderedBits(element->getKey()));
+        }
+        last = minKey;
+        redistributed.swap(buckets[i]);
+        for (ElementType* element : redistributed) {
+            insert(element);
+        }
+        redistributed.clear();
+    }
+
+private:
+    std::vector<std::vector<ElementType*>> buckets;
+    std::vector<ElementType*> redistributed;
+    int numberOfElements;
+    uint64_t last;
+
+};
@@ -6,6 +6,7 @@
 #include <type_traits>
 #include <iomanip>
 #include <algorithm>
+#include <span>
 
 #include "GraphInterface.h"
 
@@ -189,6 +190,33 @@ public:
         edgeAttributes.reserve(numEdges);
     }
 
+    // Replaces the adjacency structure by the given offsets (one per vertex plus the end). Like setOutDegrees(), edge
+    // attributes are default initialized and have to be filled in by the caller.
+    inline void setBeginOut(const std::span<const Edge> newBeginOut) noexcept {
+        Assert(!newBeginOut.empty() && newBeginOut.front() == 0, "Invalid adjacency structure!");
+        beginOut.assign(newBeginOut.begin(), newBeginOut.end());
+        vertexAttributes.clear();
+        vertexAttributes.resize(beginOut.size() - 1);
+        edgeAttributes.clear();
+        edgeAttributes.resize(beginOut.back());
+    }
+
+    // Replaces the graph by one with the given out-degrees. Edge attributes are default initialized; the caller has to
+    // fill in the edges of every vertex v, which are beginEdgeFrom(v), ..., endEdgeFrom(v) - 1.
+    template<typename T>
+    inline void setOutDegrees(const std::vector<T>& outDegree) noexcept {
+        beginOut.clear();
+        beginOut.reserve(outDegree.size() + 1);
+        beginOut.emplace_back(Edge(0));
+        for (const T degree : outDegree) {
+            beginOut.emplace_back(Edge(beginOut.back() + degree));
+        }
+        vertexAttributes.clear();
+        vertexAttributes.resize(outDegree.size());
+        edgeAttributes.clear();
+        edgeAttributes.resize(beginOut.back());
+    }
+
     inline Vertex addVertex() noexcept {
         addVertices();
         return Vertex(numVertices() - 1);
@@ -0,0 +1,102 @@
+#pragma once
+
+#include <algorithm>
+#include <span>
+#include <vector>
+
+#include "../Graph/Graph.h"
+
+#include "FlowUtils.h"
+#include "MaxFlowInstance.h"
+
+#include "../../Helpers/Assert.h"
+#include "../../Helpers/Types.h"
+#include "../../Helpers/Vector/Vector.h"
+
+/**
+ * Query index over the result of a parametric max-flow computation.
+ * Vertices are sorted by their breakpoint, so the sink component for any alpha is a suffix of this order.
+ * Between two consecutive breakpoints the minimum cut does not change, so its capacity is stored as a single flow
+ * function per breakpoint. Both queries cost one binary search over the distinct breakpoints. The index also holds the
+ * sorted list of distinct breakpoints, starting with alphaMin, so that solvers which only fill breakpointOfVertex can
+ * answer all result queries from it.
+ */
+template<pmf::flowFunction FLOW_FUNCTION>
+class BreakpointIndex {
+public:
+    using FlowFunction = FLOW_FUNCTION;
+    using FlowType = FlowFunction::FlowType;
+    using InstanceType = ParametricMaxFlowInstance<FlowFunction>;
+
+    BreakpointIndex() : cutCapacity_(1, FlowFunction(0)), sourceComponentSize_(1, 0) {}
+
+    inline void build(const InstanceType& instance, const std::vector<double>& breakpointOfVertex) noexcept {
+        const auto& graph = instance.graph;
+        Assert(breakpointOfVertex.size() == graph.numVertices(), "Breakpoints do not match the graph!");
+        vertices_ = Vector::id<Vertex>(graph.numVertices());
+        std::stable_sort(vertices_.begin(), vertices_.end(), [&](const Vertex a, const Vertex b) {
+            return breakpointOfVertex[a] < breakpointOfVertex[b];
+        });
+        alphas_.clear();
+        breakpoints_.assign(1, instance.alphaMin);
+        cutCapacity_.assign(1, FlowFunction(0));
+        sourceComponentSize_.assign(1, 0);
+
+        // All vertices sharing a breakpoint are moved at once, so that only edges of the previous cut are subtracted.
+        std::vector<bool> inSourceComponent(graph.numVertices(), false);
+        size_t i = 0;
+        while (i < vertices_.size() && breakpointOfVertex[vertices_[i]] < INFTY) {
+            const double alpha = breakpointOfVertex[vertices_[i]];
+            size_t j = i;
+            for (; j < vertices_.size() && breakpointOfVertex[vertices_[j]] == alpha; j++) {
+                inSourceComponent[vertices_[j]] = true;
+            }
+            FlowFunction cutCapacity = cutCapacity_.back();
+            for (size_t k = i; k < j; k++) {
+                for (const Edge edge : graph.edgesFrom(vertices_[k])) {
+                    const Vertex to = graph.get(ToVertex, edge);
+                    if (!inSourceComponent[to]) {
+                        cutCapacity += graph.get(Capacity, edge);
+                    } else if (breakpointOfVertex[to] < alpha) {
+                        cutCapacity -= graph.get(Capacity, graph.get(ReverseEdge, edge));
+                    }
+                }
+            }
+            alphas_.emplace_back(alpha);
+            if (alpha > instance.alphaMin) breakpoints_.emplace_back(alpha);
+            cutCapacity_.emplace_back(cutCapacity);
+            sourceComponentSize_.emplace_back(j);
+            i = j;
+        }
+    }
+
+    inline const std::vector<double>& getBreakpoints() const noexcept {
+        return breakpoints_;
+    }
+
+    // The vertices are ordered by breakpoint, not by id.
+    inline std::span<const Vertex> getSinkComponent(const double alpha) const noexcept {
+        return std::span<const Vertex>(vertices_).subspan(sourceComponentSize_[getIndex(alpha)]);
+    }
+
+    inline const FlowFunction& getCutCapacity(const double alpha) const noexcept {
+        return cutCapacity_[getIndex(alpha)];
+    }
+
+    inline FlowType getFlowValue(const double alpha) const noexcept {
+        return getCutCapacity(alpha).eval(alpha);
+    }
+
+private:
+    // Number of distinct breakpoints that are <= alpha.
+    inline size_t getIndex(const double alpha) const noexcept {
+        return std::upper_bound(alphas_.begin(), alphas_.end(), alpha) - alphas_.begin();
+    }
+
+private:
+    std::vector<Vertex> vertices_;
+    std::vector<double> alphas_;
+    std::vector<double> breakpoints_;
+    std::vector<FlowFunction> cutCapacity_;
+    std::vector<size_t> sourceComponentSize_;
+};
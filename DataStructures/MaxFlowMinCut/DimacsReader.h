@@ -0,0 +1,211 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "../Graph/Graph.h"
+
+#include "FlowGraphBuilder.h"
+
+#include "../../Helpers/Assert.h"
+#include "../../Helpers/Timer.h"
+#include "../../Helpers/IO/MappedFile.h"
+#include "../../Helpers/String/String.h"
+
+/**
+ * Parallel reader for DIMACS max-flow files ("p <problem> n m", "n <id> s", "n <id> t", followed by one
+ * "a <from> <to> <value>..." line per arc).
+ * The file is mapped into memory, the header is read sequentially, and the arc section is split into newline-aligned
+ * chunks that are parsed in parallel with std::from_chars. The graph is then built with buildFlowGraph().
+ */
+namespace pmf::Dimacs {
+
+    // Number of bytes of the arc section that are parsed as one unit of work.
+    inline constexpr size_t ChunkSize = 1 << 20;
+
+    template<typename CAPACITY>
+    struct Chunk {
+        std::vector<FlowArc<CAPACITY>> arcs;
+        std::vector<std::string> messages;
+        bool failed = false;
+    };
+
+    inline bool isSpace(const char c) noexcept {
+        return c == ' ' || c == '\t' || c == '\r';
+    }
+
+    inline std::string_view nextLine(const char*& position, const char* end) noexcept {
+        const char* lineEnd = static_cast<const char*>(std::memchr(position, '\n', end - position));
+        if (!lineEnd) lineEnd = end;
+        const std::string_view line(position, lineEnd - position);
+        position = (lineEnd == end) ? end : lineEnd + 1;
+        return line;
+    }
+
+    inline std::string_view nextToken(const char*& position, const char* end) noexcept {
+        while (position < end && isSpace(*position)) position++;
+        const char* tokenBegin = position;
+        while (position < end && !isSpace(*position)) position++;
+        return std::string_view(tokenBegin, position - tokenBegin);
+    }
+
+    template<typename T>
+    inline bool parseNumber(const std::string_view token, T& value) noexcept {
+        const auto [end, error] = std::from_chars(token.data(), token.data() + token.size(), value);
+        return error == std::errc() && end == token.data() + token.size();
+    }
+
+    inline std::vector<std::string_view> tokenize(const std::string_view line) noexcept {
+        std::vector<std::string_view> tokens;
+        const char* position = line.data();
+        const char* end = line.data() + line.size();
+        while (true) {
+            const std::string_view token = nextToken(position, end);
+            if (token.empty()) break;
+            tokens.emplace_back(token);
+        }
+        return tokens;
+    }
+
+    inline std::string_view trim(const std::string_view line) noexcept {
+        size_t first = 0;
+        size_t last = line.size();
+        while (first < last && isSpace(line[first])) first++;
+        while (last > first && isSpace(line[last - 1])) last--;
+        return line.substr(first, last - first);
+    }
+
+    // Parses the "p" and "n" lines. Returns a pointer to the first byte of the arc section, or nullptr on error.
+    inline const char* readHeader(const char* position, const char* end, const std::string_view problem, size_t& numVertices, size_t& numArcs, Vertex& source, Vertex& sink) noexcept {
+        numVertices = -1;
+        numArcs = -1;
+        source = noVertex;
+        sink = noVertex;
+        while (position < end && (source == noVertex || sink == noVertex)) {
+            const std::string_view line = trim(nextLine(position, end));
+            if (line.empty() || line[0] == 'c') continue;
+            const std::vector<std::string_view> tokens = tokenize(line);
+            if (numVertices == size_t(-1)) {
+                if (tokens.size() != 4 || tokens[0] != "p" || tokens[1] != problem || !parseNumber(tokens[2], numVertices) || !parseNumber(tokens[3], numArcs)) {
+                    numVertices = -1;
+                    std::cout << "ERROR, invalid DIMACS .max-file header: " << line << std::endl;
+                    return nullptr;
+                }
+            } else {
+                size_t id = 0;
+                if (tokens.size() != 3 || tokens[0] != "n" || (tokens[2] != "s" && tokens[2] != "t") || !parseNumber(tokens[1], id)) {
+                    std::cout << "ERROR, invalid DIMACS .max-file header: " << line << std::endl;
+                    return nullptr;
+                }
+                if (id == 0 || id > numVertices) {
+                    std::cout << "ERROR, " << tokens[1] << " does not name a vertex!" << std::endl;
+                    return nullptr;
+                }
+                (tokens[2] == "s" ? source : sink) = Vertex(id - 1);
+            }
+        }
+        return position;
+    }
+
+    template<typename VALUE, size_t NUM_VALUES, typename CAPACITY, typename MAKE_CAPACITY>
+    inline void parseChunk(const char* position, const char* end, const size_t numVertices, const MAKE_CAPACITY& makeCapacity, Chunk<CAPACITY>& chunk) noexcept {
+        chunk.arcs.reserve((end - position) / 16);
+        while (position < end) {
+            const std::string_view line = nextLine(position, end);
+            const char* token = line.data();
+            const char* lineEnd = line.data() + line.size();
+            const std::string_view type = nextToken(token, lineEnd);
+            if (type.empty() || type[0] == 'c') continue;
+            const std::string_view fromToken = nextToken(token, lineEnd);
+            const std::string_view toToken = nextToken(token, lineEnd);
+            size_t from = 0;
+            size_t to = 0;
+            std::array<VALUE, NUM_VALUES> values;
+            bool valid = (type == "a") && parseNumber(fromToken, from) && parseNumber(toToken, to);
+            for (size_t i = 0; i < NUM_VALUES; i++) {
+                valid = valid && parseNumber(nextToken(token, lineEnd), values[i]);
+            }
+            if (!valid || !nextToken(token, lineEnd).empty()) {
+                chunk.messages.emplace_back("WARNING, ignoring line in .max-file: " + std::string(trim(line)));
+                continue;
+            }
+            if (from == 0 || from > numVertices) {
+                chunk.messages.emplace_back("ERROR, " + std::string(fromToken) + " does not name a vertex!");
+                chunk.failed = true;
+                return;
+            } else if (to == 0 || to > numVertices) {
+                chunk.messages.emplace_back("ERROR, " + std::string(toToken) + " does not name a vertex!");
+                chunk.failed = true;
+                return;
+            }
+            chunk.arcs.emplace_back(FlowArc<CAPACITY>{Vertex(from - 1), Vertex(to - 1), makeCapacity(values)});
+        }
+    }
+
+    // Reads a DIMACS file whose arc lines carry NUM_VALUES numbers of type VALUE after the two endpoints. The numbers
+    // of each arc are turned into its capacity by makeCapacity(const std::array<VALUE, NUM_VALUES>&).
+    // As before, reading stops at the first arc with an invalid endpoint; all arcs before it are kept.
+    template<bool VERBOSE, typename VALUE, size_t NUM_VALUES, typename GRAPH, typename MAKE_CAPACITY>
+    inline void read(const std::string& fileName, const std::string_view problem, GRAPH& graph, Vertex& source, Vertex& sink, const MAKE_CAPACITY& makeCapacity) noexcept {
+        using CapacityType = typename GRAPH::template EdgeAttributeType<Capacity>;
+        Timer timer;
+        const IO::MappedFile file(fileName);
+        file.adviseSequential();
+        const char* end = file.data() + file.size();
+
+        size_t numVertices = 0;
+        size_t numArcs = 0;
+        const char* arcSection = readHeader(file.data(), end, problem, numVertices, numArcs, source, sink);
+        if (numVertices == size_t(-1)) {
+            graph.clear();
+            return;
+        }
+        if (!arcSection) arcSection = end;
+
+        const size_t numChunks = std::max<size_t>(1, (end - arcSection + ChunkSize - 1) / ChunkSize);
+        std::vector<const char*> chunkBegin(numChunks + 1, end);
+        chunkBegin[0] = arcSection;
+        for (size_t i = 1; i < numChunks; i++) {
+            const char* position = std::max(chunkBegin[i - 1], arcSection + i * ChunkSize);
+            while (position < end && position[-1] != '\n') position++;
+            chunkBegin[i] = position;
+        }
+
+        std::vector<Chunk<CapacityType>> chunks(numChunks);
+        #pragma omp parallel for schedule(dynamic, 1)
+        for (size_t i = 0; i < numChunks; i++) {
+            parseChunk<VALUE, NUM_VALUES>(chunkBegin[i], chunkBegin[i + 1], numVertices, makeCapacity, chunks[i]);
+        }
+
+        size_t numArcsRead = 0;
+        for (size_t i = 0; i < numChunks; i++) {
+            for (const std::string& message : chunks[i].messages) {
+                std::cout << message << std::endl;
+            }
+            numArcsRead += chunks[i].arcs.size();
+            if (chunks[i].failed) {
+                chunks.resize(i + 1);
+                break;
+            }
+        }
+        if (numArcsRead != numArcs) {
+            std::cout << "WARNING, found " << numArcsRead << " edges, but " << numArcs << " edges were declared." << std::endl;
+        }
+        if constexpr (VERBOSE) std::cout << "Parsed " << numArcsRead << " arcs in " << String::msToString(timer.elapsedMilliseconds()) << std::endl;
+
+        std::vector<std::vector<FlowArc<CapacityType>>> arcs;
+        for (Chunk<CapacityType>& chunk : chunks) {
+            arcs.emplace_back(std::move(chunk.arcs));
+        }
+        chunks.clear();
+        buildFlowGraph(graph, numVertices, arcs);
+        if constexpr (VERBOSE) std::cout << "Built graph with " << graph.numVertices() << " vertices and " << graph.numEdges() << " edges in " << String::msToString(timer.elapsedMilliseconds()) << std::endl;
+    }
+
+}
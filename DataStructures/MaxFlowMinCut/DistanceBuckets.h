@@ -0,0 +1,205 @@
+#pragma once
+
+#include <algorithm>
+#include <vector>
+
+#include "../Graph/Graph.h"
+
+#include "../../Helpers/Assert.h"
+#include "../../Helpers/Types.h"
+
+/**
+ * Vertices bucketed by their distance label, as used for the excess and orphan queues of the IBFS variants.
+ * Every bucket is an intrusive doubly linked list threaded through a per-vertex link array, so after construction no
+ * operation allocates. Vertices are appended to the back of their bucket and taken from the back as well.
+ * HIGHEST_FIRST selects whether front() and pop() take from the highest (excesses) or the lowest (orphans) non-empty
+ * bucket. Distances must lie in [0, n].
+ */
+template<bool HIGHEST_FIRST>
+class DistanceBuckets {
+
+private:
+    struct Link {
+        Vertex next = noVertex;
+        Vertex prev = noVertex;
+        int bucket = -1;
+    };
+
+public:
+    DistanceBuckets(const int n) {
+        reset(n);
+    }
+
+    inline void reset(const int n) noexcept {
+        links_.assign(n, Link());
+        head_.assign(n + 1, noVertex);
+        tail_.assign(n + 1, noVertex);
+        minBucket_ = n + 1;
+        maxBucket_ = -1;
+    }
+
+    inline void assertVertexInBucket(const Vertex vertex, const int dist) const noexcept {
+        Assert(links_[vertex].bucket == dist, "Vertex is not in bucket!");
+    }
+
+    inline bool contains(const Vertex vertex) const noexcept {
+        return links_[vertex].bucket != -1;
+    }
+
+    inline bool empty() const noexcept {
+        return maxBucket_ < 0;
+    }
+
+    inline int minBucket() const noexcept {
+        return minBucket_;
+    }
+
+    inline int maxBucket() const noexcept {
+        return maxBucket_;
+    }
+
+    inline void addVertex(const Vertex vertex, const int dist) noexcept {
+        if (contains(vertex)) {
+            if constexpr (!HIGHEST_FIRST) assertVertexInBucket(vertex, dist);
+            return;
+        }
+        link(vertex, dist);
+    }
+
+    inline void removeVertex(const Vertex vertex, [[maybe_unused]] const int dist) noexcept {
+        if (!contains(vertex)) return;
+        assertVertexInBucket(vertex, dist);
+        unlink(vertex);
+    }
+
+    inline void increaseBucket(const Vertex vertex, const int oldDist, const int newDist) noexcept {
+        Assert(newDist > oldDist, "Distance has not increased!");
+        assertVertexInBucket(vertex, oldDist);
+        unlink(vertex);
+        link(vertex, newDist);
+    }
+
+    inline void decreaseBucket(const Vertex vertex, const int oldDist, const int newDist) noexcept {
+        Assert(newDist < oldDist, "Distance has not decreased!");
+        assertVertexInBucket(vertex, oldDist);
+        unlink(vertex);
+        link(vertex, newDist);
+    }
+
+    inline Vertex front() const noexcept {
+        Assert(!empty(), "Buckets are empty!");
+        return tail_[frontBucket()];
+    }
+
+    inline Vertex pop() noexcept {
+        const Vertex vertex = front();
+        unlink(vertex);
+        return vertex;
+    }
+
+    // Removes all vertices of the front bucket at once, in the order in which they were added.
+    inline void popLevel(std::vector<Vertex>& level) noexcept {
+        Assert(!empty(), "Buckets are empty!");
+        level.clear();
+        const int bucket = frontBucket();
+        for (Vertex vertex = head_[bucket]; vertex != noVertex;) {
+            level.emplace_back(vertex);
+            const Vertex next = links_[vertex].next;
+            links_[vertex] = Link();
+            vertex = next;
+        }
+        head_[bucket] = noVertex;
+        tail_[bucket] = noVertex;
+        bucketEmptied(bucket);
+    }
+
+    // Removes all vertices with a distance greater than dist at once and calls function(vertex) for each of them.
+    template<typename FUNCTION>
+    inline void removeAbove(const int dist, const FUNCTION& function) noexcept {
+        while (maxBucket_ > dist) {
+            const int bucket = maxBucket_;
+            for (Vertex vertex = head_[bucket]; vertex != noVertex;) {
+                const Vertex next = links_[vertex].next;
+                links_[vertex] = Link();
+                function(vertex);
+                vertex = next;
+            }
+            head_[bucket] = noVertex;
+            tail_[bucket] = noVertex;
+            bucketEmptied(bucket);
+        }
+    }
+
+    template<typename FUNCTION>
+    inline void forEach(const FUNCTION& function) const noexcept {
+        for (int bucket = minBucket_; bucket <= maxBucket_; bucket++) {
+            for (Vertex vertex = head_[bucket]; vertex != noVertex; vertex = links_[vertex].next) {
+                function(vertex, bucket);
+            }
+        }
+    }
+
+private:
+    inline int frontBucket() const noexcept {
+        return HIGHEST_FIRST ? maxBucket_ : minBucket_;
+    }
+
+    inline void link(const Vertex vertex, const int bucket) noexcept {
+        Assert(bucket >= 0 && static_cast<size_t>(bucket) < head_.size(), "Distance " << bucket << " is out of range!");
+        Link& l = links_[vertex];
+        l.bucket = bucket;
+        l.prev = tail_[bucket];
+        l.next = noVertex;
+        if (tail_[bucket] == noVertex) {
+            head_[bucket] = vertex;
+        } else {
+            links_[tail_[bucket]].next = vertex;
+        }
+        tail_[bucket] = vertex;
+        minBucket_ = std::min(minBucket_, bucket);
+        maxBucket_ = std::max(maxBucket_, bucket);
+    }
+
+    inline void unlink(const Vertex vertex) noexcept {
+        const Link l = links_[vertex];
+        if (l.prev == noVertex) {
+            head_[l.bucket] = l.next;
+        } else {
+            links_[l.prev].next = l.next;
+        }
+        if (l.next == noVertex) {
+            tail_[l.bucket] = l.prev;
+        } else {
+            links_[l.next].prev = l.prev;
+        }
+        links_[vertex] = Link();
+        if (head_[l.bucket] == noVertex) bucketEmptied(l.bucket);
+    }
+
+    inline void bucketEmptied(const int bucket) noexcept {
+        if (bucket == maxBucket_) {
+            while (maxBucket_ >= minBucket_ && head_[maxBucket_] == noVertex) maxBucket_--;
+        }
+        if (bucket == minBucket_) {
+            while (minBucket_ <= maxBucket_ && head_[minBucket_] == noVertex) minBucket_++;
+        }
+        if (maxBucket_ < minBucket_) {
+            minBucket_ = static_cast<int>(head_.size());
+            maxBucket_ = -1;
+        }
+    }
+
+private:
+    std::vector<Link> links_;
+    std::vector<Vertex> head_;
+    std::vector<Vertex> tail_;
+    int minBucket_;
+    int maxBucket_;
+
+};
+
+// Vertices with excess, drained from the highest distance down.
+using ExcessBuckets = DistanceBuckets<true>;
+
+// Orphans, adopted from the lowest distance up.
+using OrphanBuckets = DistanceBuckets<false>;
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <vector>
+
+#include "../Graph/Graph.h"
+
+#include "../../Helpers/Assert.h"
+
+namespace pmf {
+
+    template<typename CAPACITY>
+    struct FlowArc {
+        Vertex from;
+        Vertex to;
+        CAPACITY capacity;
+    };
+
+    template<typename CAPACITY>
+    struct OutEdge {
+        Vertex to;
+        CAPACITY capacity;
+    };
+
+    // Builds a flow graph on numVertices vertices from blocks of arcs with a parallel counting sort by tail vertex.
+    // Every arc (u, v) yields the edges (u, v) and (v, u), the latter with zero capacity. Parallel edges are merged by
+    // summing their capacities, the out-edges of every vertex are sorted by head, and every edge is paired with its
+    // reverse. The blocks are processed in parallel, so callers should produce many of them.
+    template<typename GRAPH, typename CAPACITY>
+    inline void buildFlowGraph(GRAPH& graph, const size_t numVertices, const std::vector<std::vector<FlowArc<CAPACITY>>>& arcs) noexcept {
+        std::vector<size_t> edgeBegin(numVertices + 1, 0);
+        #pragma omp parallel for schedule(dynamic, 1)
+        for (size_t i = 0; i < arcs.size(); i++) {
+            for (const FlowArc<CAPACITY>& arc : arcs[i]) {
+                std::atomic_ref<size_t>(edgeBegin[arc.from + 1]).fetch_add(1, std::memory_order_relaxed);
+                std::atomic_ref<size_t>(edgeBegin[arc.to + 1]).fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+        for (size_t v = 0; v < numVertices; v++) {
+            edgeBegin[v + 1] += edgeBegin[v];
+        }
+
+        std::vector<OutEdge<CAPACITY>> outEdges(edgeBegin.back());
+        std::vector<size_t> nextEdge(edgeBegin.begin(), edgeBegin.end() - 1);
+        #pragma omp parallel for schedule(dynamic, 1)
+        for (size_t i = 0; i < arcs.size(); i++) {
+            for (const FlowArc<CAPACITY>& arc : arcs[i]) {
+                outEdges[std::atomic_ref<size_t>(nextEdge[arc.from]).fetch_add(1, std::memory_order_relaxed)] = OutEdge<CAPACITY>{arc.to, arc.capacity};
+                outEdges[std::atomic_ref<size_t>(nextEdge[arc.to]).fetch_add(1, std::memory_order_relaxed)] = OutEdge<CAPACITY>{arc.from, CAPACITY(0)};
+            }
+        }
+
+        std::vector<size_t> outDegree(numVertices);
+        #pragma omp parallel for schedule(dynamic, 1024)
+        for (size_t v = 0; v < numVertices; v++) {
+            const auto first = outEdges.begin() + edgeBegin[v];
+            const auto last = outEdges.begin() + edgeBegin[v + 1];
+            std::sort(first, last, [](const OutEdge<CAPACITY>& a, const OutEdge<CAPACITY>& b) {
+                return a.to < b.to;
+            });
+            auto merged = first;
+            for (auto edge = first; edge != last; edge++) {
+                if (merged != first && (merged - 1)->to == edge->to) {
+                    (merged - 1)->capacity += edge->capacity;
+                } else {
+                    *merged++ = *edge;
+                }
+            }
+            outDegree[v] = merged - first;
+        }
+
+        graph.setOutDegrees(outDegree);
+        #pragma omp parallel for schedule(dynamic, 1024)
+        for (size_t v = 0; v < numVertices; v++) {
+            size_t from = edgeBegin[v];
+            for (const Edge edge : graph.edgesFrom(Vertex(v))) {
+                graph.set(ToVertex, edge, outEdges[from].to);
+                graph.set(Capacity, edge, outEdges[from].capacity);
+                from++;
+            }
+        }
+        #pragma omp parallel for schedule(dynamic, 1024)
+        for (size_t v = 0; v < numVertices; v++) {
+            for (const Edge edge : graph.edgesFrom(Vertex(v))) {
+                const Vertex to = graph.get(ToVertex, edge);
+                const auto first = graph[ToVertex].begin() + graph.beginEdgeFrom(to);
+                const auto last = graph[ToVertex].begin() + graph.endEdgeFrom(to);
+                const auto reverse = std::lower_bound(first, last, Vertex(v));
+                Assert(reverse != last && *reverse == Vertex(v), "Edge (" << v << ", " << to << ") has no reverse edge!");
+                graph.set(ReverseEdge, edge, Edge(reverse - graph[ToVertex].begin()));
+            }
+        }
+    }
+
+}
@@ -3,6 +3,7 @@
 #include <concepts>
 #include <numeric>
 #include <cstdlib>
+#include <type_traits>
 
 #include "../../Helpers/Types.h"
 #include "../../Helpers/IO/Serialization.h"
@@ -79,47 +80,34 @@ namespace pmf {
     }
 
     /**
-     * Abstract class for functions to be used for parametric maxFlow
+     * Concept for functions to be used for parametric maxFlow.
+     * Flow functions are stored per edge and per vertex, so they are required to be trivially copyable (no virtual
+     * methods) to keep the capacity arrays dense.
+     * Implementations of operator== should consider float inaccuracy.
      */
-    class flowFunction {
+    template<typename T>
+    concept flowFunction = std::is_trivially_copyable_v<T> && requires(T f, const T& g, const double x) {
+        typename T::FlowType;
+        T(x);
         /**
          * Returns the zero crossing of f with minimum x coordinate for which x >= minVal
          * @param minVal minimum value for the zero crossing
          * @return the zero crossing, std::numeric_limits<double>::infinity() if none exists
          */
-        virtual double getNextZeroCrossing(double) const {
-            throw std::runtime_error("Flow function used directly, use class implementing flow function instead");
-        };
-
-        [[nodiscard]] virtual double eval(double) const {
-            throw std::runtime_error("Flow function used directly, use class implementing flow function instead");
-        };
-
-        friend flowFunction &operator+(flowFunction, const flowFunction&) {
-            throw std::runtime_error("Flow function used directly, use class implementing flow function instead");
-        };
-
-        virtual flowFunction operator+=(const flowFunction&) {
-            throw std::runtime_error("Flow function used directly, use class implementing flow function instead");
-        };
-
-        virtual flowFunction operator-=(const flowFunction&) {
-            throw std::runtime_error("Flow function used directly, use class implementing flow function instead");
-        };
-
-        /**
-         * When overriding this operator float inaccuracy should be considered
-         */
-        virtual bool operator==(const flowFunction &&) const {
-            throw std::runtime_error("Flow function used directly, use class implementing flow function instead");
-        };
+        { g.getNextZeroCrossing(x) } -> std::convertible_to<double>;
+        { g.eval(x) } -> std::convertible_to<double>;
+        { g + g } -> std::convertible_to<T>;
+        { g - g } -> std::convertible_to<T>;
+        { f += g };
+        { f -= g };
+        { g == g } -> std::convertible_to<bool>;
     };
 
 
 /**
  * Class to wrap "linear" functions of form f(x) = ax + b
  */
-    class linearFlowFunction : public flowFunction {
+    class linearFlowFunction {
     public:
         using FlowType = double;
         inline static constexpr double CONST_INF = INFTY;
@@ -130,7 +118,7 @@ namespace pmf {
 
         explicit linearFlowFunction() : a(0), b(0) {};
 
-        double getNextZeroCrossing(double minVal) const override {
+        double getNextZeroCrossing(double minVal) const {
             if (a == 0) {
                 if (b <= epsilon) {
                     return minVal;
@@ -148,12 +136,16 @@ namespace pmf {
             return std::to_string(b) + " " + std::to_string(a);
         }
 
-        [[nodiscard]] double eval(double x) const override {
+        [[nodiscard]] double eval(double x) const {
             if (x == CONST_INF) return a;
             if (b == CONST_INF) return CONST_INF;
             return x * a + b;
         }
 
+        [[nodiscard]] double getSlope() const {
+            return a;
+        }
+
         friend double findIntersectionPoint(const linearFlowFunction& lhs, const linearFlowFunction& rhs) {
             if (lhs.a == rhs.a) return CONST_INF;
             return (rhs.b - lhs.b)/(lhs.a - rhs.a);
@@ -225,4 +217,7 @@ namespace pmf {
     private:
         double a, b;
     };
+
+    static_assert(flowFunction<linearFlowFunction>, "linearFlowFunction does not satisfy the flow function concept!");
+    static_assert(sizeof(linearFlowFunction) == 2 * sizeof(double), "linearFlowFunction should not carry any overhead!");
 } // namespace pmf
\ No newline at end of file
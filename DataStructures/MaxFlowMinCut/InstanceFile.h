@@ -0,0 +1,155 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <span>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "../Graph/Graph.h"
+
+#include "../../Helpers/Assert.h"
+#include "../../Helpers/FileSystem/FileSystem.h"
+#include "../../Helpers/IO/MappedFile.h"
+#include "../../Helpers/IO/Serialization.h"
+
+/**
+ * Single-file binary format for max-flow instances.
+ * The file starts with a fixed-size header, followed by the CSR arrays of the graph (beginOut, ToVertex, ReverseEdge,
+ * Capacity). Every array starts at a page-aligned offset that is recorded in the header. Reading maps the file and
+ * copies each section into the graph's own vectors, so the graph does not reference the file after read() returns.
+ * Loading therefore still costs one pass over the data, and every process holds its own copy of the graph: the format
+ * does not give near-instant startup or share the instance through the page cache, which would need a graph that is
+ * backed by the mapping itself. Every header field and section is validated before it is used, so a corrupt or
+ * truncated file is rejected instead of being read out of bounds.
+ */
+namespace pmf::InstanceFile {
+
+    inline constexpr char Magic[8] = {'P', 'M', 'F', 'I', 'N', 'S', 'T', '\0'};
+    inline constexpr uint32_t Version = 1;
+    inline constexpr uint64_t SectionAlignment = 4096;
+
+    struct Header {
+        char magic[8];
+        uint32_t version;
+        uint32_t capacitySize;
+        uint64_t numVertices;
+        uint64_t numEdges;
+        uint64_t source;
+        uint64_t sink;
+        double alphaMin;
+        double alphaMax;
+        uint64_t beginOutOffset;
+        uint64_t toVertexOffset;
+        uint64_t reverseEdgeOffset;
+        uint64_t capacityOffset;
+    };
+    static_assert(std::is_trivially_copyable_v<Header>);
+
+    inline constexpr uint64_t alignSection(const uint64_t offset) noexcept {
+        return (offset + SectionAlignment - 1) / SectionAlignment * SectionAlignment;
+    }
+
+    inline bool isInstanceFile(const std::string& fileName) noexcept {
+        std::ifstream is(fileName, std::ios::binary);
+        if (!is) return false;
+        char magic[sizeof(Magic)];
+        is.read(magic, sizeof(Magic));
+        return is && std::memcmp(magic, Magic, sizeof(Magic)) == 0;
+    }
+
+    template<typename GRAPH>
+    using CapacityType = typename GRAPH::template EdgeAttributeType<Capacity>;
+
+    template<typename GRAPH, typename CAPACITY = CapacityType<GRAPH>>
+    inline void write(const std::string& fileName, const GRAPH& graph, const Vertex source, const Vertex sink, const double alphaMin, const double alphaMax) noexcept {
+        static_assert(std::is_trivially_copyable_v<CAPACITY>, "Capacities must be trivially copyable!");
+        std::vector<Edge> beginOut(graph.numVertices() + 1);
+        for (size_t i = 0; i < beginOut.size(); i++) {
+            beginOut[i] = graph.beginEdgeFrom(Vertex(i));
+        }
+
+        Header header{};
+        std::memcpy(header.magic, Magic, sizeof(Magic));
+        header.version = Version;
+        header.capacitySize = sizeof(CAPACITY);
+        header.numVertices = graph.numVertices();
+        header.numEdges = graph.numEdges();
+        header.source = source;
+        header.sink = sink;
+        header.alphaMin = alphaMin;
+        header.alphaMax = alphaMax;
+        header.beginOutOffset = alignSection(sizeof(Header));
+        header.toVertexOffset = alignSection(header.beginOutOffset + beginOut.size() * sizeof(Edge));
+        header.reverseEdgeOffset = alignSection(header.toVertexOffset + header.numEdges * sizeof(Vertex));
+        header.capacityOffset = alignSection(header.reverseEdgeOffset + header.numEdges * sizeof(Edge));
+
+        std::ofstream os(FileSystem::ensureDirectoryExists(fileName), std::ios::binary);
+        IO::checkStream(os, fileName);
+        uint64_t position = 0;
+        const auto writeSection = [&](const uint64_t offset, const void* data, const uint64_t bytes) {
+            Assert(offset >= position, "Sections overlap!");
+            for (; position < offset; position++) os.put('\0');
+            os.write(static_cast<const char*>(data), bytes);
+            position += bytes;
+        };
+        writeSection(0, &header, sizeof(Header));
+        writeSection(header.beginOutOffset, beginOut.data(), beginOut.size() * sizeof(Edge));
+        writeSection(header.toVertexOffset, graph[ToVertex].data(), header.numEdges * sizeof(Vertex));
+        writeSection(header.reverseEdgeOffset, graph[ReverseEdge].data(), header.numEdges * sizeof(Edge));
+        writeSection(header.capacityOffset, graph[Capacity].data(), header.numEdges * sizeof(CAPACITY));
+        Ensure(os.good(), "cannot write file: " << fileName);
+    }
+
+    template<typename GRAPH, typename CAPACITY = CapacityType<GRAPH>>
+    inline void read(const std::string& fileName, GRAPH& graph, Vertex& source, Vertex& sink, double& alphaMin, double& alphaMax) noexcept {
+        static_assert(std::is_trivially_copyable_v<CAPACITY>, "Capacities must be trivially copyable!");
+        const IO::MappedFile file(fileName);
+        file.adviseSequential();
+        Ensure(file.size() >= sizeof(Header), "file is too small to be an instance: " << fileName);
+        Header header;
+        std::memcpy(&header, file.data(), sizeof(Header));
+        Ensure(std::memcmp(header.magic, Magic, sizeof(Magic)) == 0, "not an instance file: " << fileName);
+        Ensure(header.version == Version, "unsupported instance file version " << header.version << " (expected " << Version << "): " << fileName);
+        Ensure(header.capacitySize == sizeof(CAPACITY), "instance file " << fileName << " stores capacities of " << header.capacitySize << " bytes, expected " << sizeof(CAPACITY));
+        // Every vertex and edge occupies at least one byte of the file, which also keeps the section sizes below from
+        // overflowing.
+        Ensure(header.numVertices < file.size() && header.numEdges < file.size(), "invalid vertex or edge count in instance file: " << fileName);
+        Ensure(header.numVertices < noVertex && header.numEdges < noEdge, "instance file is too large for the vertex and edge types: " << fileName);
+        Ensure(header.source < header.numVertices && header.sink < header.numVertices && header.source != header.sink, "invalid source or sink in instance file: " << fileName);
+
+        // The sections must be page-aligned, in the order in which they are written, and must not overlap.
+        uint64_t sectionEnd = sizeof(Header);
+        const auto checkSection = [&](const uint64_t offset, const uint64_t bytes, const char* name) {
+            Ensure(offset % SectionAlignment == 0, "section " << name << " is not aligned in instance file: " << fileName);
+            Ensure(offset >= sectionEnd, "section " << name << " overlaps the previous one in instance file: " << fileName);
+            Ensure(offset <= file.size() && bytes <= file.size() - offset, "section " << name << " is truncated in instance file: " << fileName);
+            sectionEnd = offset + bytes;
+        };
+        checkSection(header.beginOutOffset, (header.numVertices + 1) * sizeof(Edge), "beginOut");
+        checkSection(header.toVertexOffset, header.numEdges * sizeof(Vertex), "ToVertex");
+        checkSection(header.reverseEdgeOffset, header.numEdges * sizeof(Edge), "ReverseEdge");
+        checkSection(header.capacityOffset, header.numEdges * sizeof(CAPACITY), "Capacity");
+
+        const std::span<const Edge> beginOut(reinterpret_cast<const Edge*>(file.data() + header.beginOutOffset), header.numVertices + 1);
+        Ensure(beginOut.front() == 0 && beginOut.back() == header.numEdges, "beginOut does not span all edges in instance file: " << fileName);
+        Ensure(std::is_sorted(beginOut.begin(), beginOut.end()), "beginOut is not monotone in instance file: " << fileName);
+
+        graph.setBeginOut(beginOut);
+        std::memcpy(graph[ToVertex].data(), file.data() + header.toVertexOffset, header.numEdges * sizeof(Vertex));
+        std::memcpy(graph[ReverseEdge].data(), file.data() + header.reverseEdgeOffset, header.numEdges * sizeof(Edge));
+        std::memcpy(graph[Capacity].data(), file.data() + header.capacityOffset, header.numEdges * sizeof(CAPACITY));
+        for (const Edge edge : graph.edges()) {
+            Ensure(graph.get(ToVertex, edge) < header.numVertices && graph.get(ReverseEdge, edge) < header.numEdges, "edge " << edge << " points out of the graph in instance file: " << fileName);
+        }
+        source = Vertex(header.source);
+        sink = Vertex(header.sink);
+        alphaMin = header.alphaMin;
+        alphaMax = header.alphaMax;
+        Assert(graph.satisfiesInvariants(), "Invariants not satisfied!");
+    }
+
+}
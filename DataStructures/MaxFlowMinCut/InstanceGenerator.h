@@ -0,0 +1,267 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <numbers>
+#include <vector>
+
+#include "../Graph/Graph.h"
+
+#include "FlowGraphBuilder.h"
+#include "FlowUtils.h"
+#include "MaxFlowInstance.h"
+
+#include "../../Helpers/Assert.h"
+
+/**
+ * Generators for synthetic parametric max-flow instances with source 0, sink 1 and alpha in [0, 1].
+ * Source edges are non-decreasing and sink edges non-increasing in alpha, so every instance is source-sink monotone.
+ * The work is split into blocks of BlockSize generation units (pixels, points, projects, ...), each with its own random
+ * stream derived from the seed and the block index. Blocks are generated in parallel, and the result only depends on
+ * the seed, not on the number of threads.
+ */
+namespace pmf::InstanceGenerator {
+
+    using FlowFunction = linearFlowFunction;
+    using InstanceType = ParametricMaxFlowInstance<FlowFunction>;
+    using FlowGraph = InstanceType::GraphType;
+    using Arcs = std::vector<FlowArc<FlowFunction>>;
+
+    inline constexpr size_t BlockSize = 1 << 14;
+    inline constexpr Vertex Source = Vertex(0);
+    inline constexpr Vertex Sink = Vertex(1);
+
+    enum class CapacityDistribution {
+        Uniform,
+        Exponential
+    };
+
+    struct Parameters {
+        uint64_t seed = 42;
+        CapacityDistribution distribution = CapacityDistribution::Uniform;
+        double minCapacity = 1;
+        double maxCapacity = 100;
+        // Fraction of terminal edges with a non-zero slope. Lower values yield fewer breakpoints.
+        double parametricFraction = 1;
+    };
+
+    // SplitMix64, which is cheap to seed, so every block can get its own stream.
+    class Random {
+    public:
+        Random(const uint64_t seed, const uint64_t stream) : state(mix(seed ^ mix(stream + 0x632BE59BD9B4E019ull))) {}
+
+        inline uint64_t next() noexcept {
+            state += 0x9E3779B97F4A7C15ull;
+            return mix(state);
+        }
+
+        // Uniform in [0, 1).
+        inline double uniform() noexcept {
+            return (next() >> 11) * 0x1.0p-53;
+        }
+
+        inline double uniform(const double min, const double max) noexcept {
+            return min + uniform() * (max - min);
+        }
+
+        // Uniform in {0, ..., n - 1}.
+        inline size_t index(const size_t n) noexcept {
+            return next() % n;
+        }
+
+    private:
+        inline static uint64_t mix(uint64_t x) noexcept {
+            x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+            x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+            return x ^ (x >> 31);
+        }
+
+        uint64_t state;
+    };
+
+    inline double capacity(const Parameters& parameters, Random& random) noexcept {
+        switch (parameters.distribution) {
+            case CapacityDistribution::Exponential: {
+                const double mean = (parameters.maxCapacity - parameters.minCapacity) / 8;
+                return std::min(parameters.maxCapacity, parameters.minCapacity - mean * std::log1p(-random.uniform()));
+            }
+            default:
+                return random.uniform(parameters.minCapacity, parameters.maxCapacity);
+        }
+    }
+
+    inline double slope(const Parameters& parameters, Random& random) noexcept {
+        return (random.uniform() < parameters.parametricFraction) ? capacity(parameters, random) : 0;
+    }
+
+    // Source edge increasing from c to c + a, sink edge decreasing from c' + a' to c'.
+    inline void addTerminalArcs(const Parameters& parameters, Random& random, const Vertex vertex, Arcs& arcs) noexcept {
+        const double sourceSlope = slope(parameters, random);
+        arcs.emplace_back(FlowArc<FlowFunction>{Source, vertex, FlowFunction(sourceSlope, capacity(parameters, random))});
+        const double sinkSlope = slope(parameters, random);
+        arcs.emplace_back(FlowArc<FlowFunction>{vertex, Sink, FlowFunction(-sinkSlope, sinkSlope + capacity(parameters, random))});
+    }
+
+    inline void addSymmetricArcs(const Vertex from, const Vertex to, const double capacity, Arcs& arcs) noexcept {
+        arcs.emplace_back(FlowArc<FlowFunction>{from, to, FlowFunction(capacity)});
+        arcs.emplace_back(FlowArc<FlowFunction>{to, from, FlowFunction(capacity)});
+    }
+
+    // Calls generateUnit(unit, random, arcs) for every unit in parallel and builds the instance from the result.
+    template<typename GENERATE_UNIT>
+    inline InstanceType generate(const Parameters& parameters, const uint64_t family, const size_t numVertices, const size_t numUnits, const GENERATE_UNIT& generateUnit) noexcept {
+        std::vector<Arcs> arcs((numUnits + BlockSize - 1) / BlockSize);
+        #pragma omp parallel for schedule(dynamic, 1)
+        for (size_t block = 0; block < arcs.size(); block++) {
+            Random random(parameters.seed, (family << 48) | block);
+            for (size_t unit = block * BlockSize; unit < std::min(numUnits, (block + 1) * BlockSize); unit++) {
+                generateUnit(unit, random, arcs[block]);
+            }
+        }
+        InstanceType instance;
+        buildFlowGraph(instance.graph, numVertices, arcs);
+        instance.source = Source;
+        instance.sink = Sink;
+        instance.alphaMin = 0;
+        instance.alphaMax = 1;
+        return instance;
+    }
+
+    // Image segmentation on a width x height x depth grid (depth 1 for 2D). Every pixel has terminal edges and
+    // symmetric smoothness edges to its grid neighbors.
+    inline InstanceType grid(const Parameters& parameters, const size_t width, const size_t height, const size_t depth = 1) noexcept {
+        Assert(width > 0 && height > 0 && depth > 0, "Grid dimensions must be positive!");
+        const size_t numPixels = width * height * depth;
+        const auto pixel = [](const size_t index) { return Vertex(index + 2); };
+        return generate(parameters, 1, numPixels + 2, numPixels, [&](const size_t index, Random& random, Arcs& arcs) {
+            const size_t x = index % width;
+            const size_t y = (index / width) % height;
+            const size_t z = index / (width * height);
+            addTerminalArcs(parameters, random, pixel(index), arcs);
+            if (x + 1 < width) addSymmetricArcs(pixel(index), pixel(index + 1), capacity(parameters, random), arcs);
+            if (y + 1 < height) addSymmetricArcs(pixel(index), pixel(index + width), capacity(parameters, random), arcs);
+            if (z + 1 < depth) addSymmetricArcs(pixel(index), pixel(index + width * height), capacity(parameters, random), arcs);
+        });
+    }
+
+    // Random geometric graph: n points in the unit square, connected if their distance is below the radius that yields
+    // the given expected average degree. Edge capacities fall off linearly with the distance.
+    inline InstanceType geometric(const Parameters& parameters, const size_t n, const double averageDegree) noexcept {
+        Assert(n > 0, "Number of points must be positive!");
+        const double radius = std::min(1.0, std::sqrt(averageDegree / (std::numbers::pi * n)));
+        const size_t cellsPerAxis = std::max<size_t>(1, 1 / radius);
+        const auto cellOf = [&](const double coordinate) {
+            return std::min(cellsPerAxis - 1, static_cast<size_t>(coordinate * cellsPerAxis));
+        };
+
+        std::vector<double> x(n);
+        std::vector<double> y(n);
+        #pragma omp parallel for schedule(dynamic, 1)
+        for (size_t block = 0; block < (n + BlockSize - 1) / BlockSize; block++) {
+            Random random(parameters.seed, (uint64_t(2) << 48) | (uint64_t(1) << 47) | block);
+            for (size_t i = block * BlockSize; i < std::min(n, (block + 1) * BlockSize); i++) {
+                x[i] = random.uniform();
+                y[i] = random.uniform();
+            }
+        }
+
+        std::vector<size_t> cellBegin(cellsPerAxis * cellsPerAxis + 1, 0);
+        for (size_t i = 0; i < n; i++) {
+            cellBegin[cellOf(y[i]) * cellsPerAxis + cellOf(x[i]) + 1]++;
+        }
+        for (size_t cell = 1; cell < cellBegin.size(); cell++) {
+            cellBegin[cell] += cellBegin[cell - 1];
+        }
+        std::vector<size_t> pointsByCell(n);
+        std::vector<size_t> nextPoint(cellBegin.begin(), cellBegin.end() - 1);
+        for (size_t i = 0; i < n; i++) {
+            pointsByCell[nextPoint[cellOf(y[i]) * cellsPerAxis + cellOf(x[i])]++] = i;
+        }
+
+        const auto point = [](const size_t index) { return Vertex(index + 2); };
+        return generate(parameters, 2, n + 2, n, [&](const size_t i, Random& random, Arcs& arcs) {
+            addTerminalArcs(parameters, random, point(i), arcs);
+            const size_t cellX = cellOf(x[i]);
+            const size_t cellY = cellOf(y[i]);
+            for (size_t cy = (cellY > 0) ? cellY - 1 : 0; cy <= std::min(cellsPerAxis - 1, cellY + 1); cy++) {
+                for (size_t cx = (cellX > 0) ? cellX - 1 : 0; cx <= std::min(cellsPerAxis - 1, cellX + 1); cx++) {
+                    const size_t cell = cy * cellsPerAxis + cx;
+                    for (size_t k = cellBegin[cell]; k < cellBegin[cell + 1]; k++) {
+                        const size_t j = pointsByCell[k];
+                        if (j <= i) continue;
+                        const double distance = std::hypot(x[i] - x[j], y[i] - y[j]);
+                        if (distance >= radius) continue;
+                        addSymmetricArcs(point(i), point(j), capacity(parameters, random) * (1 - distance / radius), arcs);
+                    }
+                }
+            }
+        });
+    }
+
+    // Project selection: the source edge of a project is its profit, every project requires toolsPerProject random
+    // tools (infinite edges), and the sink edge of a tool is its cost. Costs are scaled by the expected number of
+    // projects that share a tool, so that profits and costs are balanced and the selection changes with alpha.
+    inline InstanceType projectSelection(const Parameters& parameters, const size_t numProjects, const size_t numTools, const size_t toolsPerProject) noexcept {
+        Assert(numTools > 0, "Number of tools must be positive!");
+        const double costScale = std::max(1.0, static_cast<double>(numProjects) / numTools);
+        const auto project = [](const size_t index) { return Vertex(index + 2); };
+        const auto tool = [&](const size_t index) { return Vertex(numProjects + index + 2); };
+        return generate(parameters, 3, numProjects + numTools + 2, numProjects + numTools, [&](const size_t unit, Random& random, Arcs& arcs) {
+            if (unit < numProjects) {
+                const double profitSlope = slope(parameters, random);
+                arcs.emplace_back(FlowArc<FlowFunction>{Source, project(unit), FlowFunction(profitSlope, capacity(parameters, random))});
+                for (size_t i = 0; i < toolsPerProject; i++) {
+                    arcs.emplace_back(FlowArc<FlowFunction>{project(unit), tool(random.index(numTools)), FlowFunction(INFTY)});
+                }
+            } else {
+                const double costSlope = costScale * slope(parameters, random);
+                const double cost = costScale * capacity(parameters, random);
+                arcs.emplace_back(FlowArc<FlowFunction>{tool(unit - numProjects), Sink, FlowFunction(-costSlope, costSlope + cost)});
+            }
+        });
+    }
+
+    // Goldberg's densest subgraph construction on a random graph with n vertices and m weighted edges: every edge is a
+    // vertex with a source edge of its weight and infinite edges to its endpoints, and every vertex has a sink edge of
+    // capacity lambda = (1 - alpha) * lambdaMax, where lambdaMax is half the maximum weighted degree. As alpha grows,
+    // subgraphs of decreasing density join the source side. The parametric fraction is not used.
+    inline InstanceType densestSubgraph(const Parameters& parameters, const size_t n, const size_t m) noexcept {
+        Assert(n > 1, "Densest subgraph instances need at least two vertices!");
+        const auto vertex = [](const size_t index) { return Vertex(index + 2); };
+        const auto edge = [&](const size_t index) { return Vertex(n + index + 2); };
+        InstanceType instance = generate(parameters, 4, n + m + 2, m + n, [&](const size_t unit, Random& random, Arcs& arcs) {
+            if (unit >= m) {
+                // The sink edges are set below, once the maximum weighted degree is known.
+                arcs.emplace_back(FlowArc<FlowFunction>{vertex(unit - m), Sink, FlowFunction(0)});
+                return;
+            }
+            const size_t u = random.index(n);
+            size_t v = random.index(n - 1);
+            if (v >= u) v++;
+            arcs.emplace_back(FlowArc<FlowFunction>{Source, edge(unit), FlowFunction(capacity(parameters, random))});
+            arcs.emplace_back(FlowArc<FlowFunction>{edge(unit), vertex(u), FlowFunction(INFTY)});
+            arcs.emplace_back(FlowArc<FlowFunction>{edge(unit), vertex(v), FlowFunction(INFTY)});
+        });
+        FlowGraph& graph = instance.graph;
+        std::vector<double> weightedDegree(n, 0);
+        for (const Edge e : graph.edgesFrom(Source)) {
+            const Vertex edgeVertex = graph.get(ToVertex, e);
+            if (edgeVertex < edge(0)) continue;
+            const double weight = graph.get(Capacity, e).eval(0);
+            for (const Edge endpointEdge : graph.edgesFrom(edgeVertex)) {
+                const Vertex endpoint = graph.get(ToVertex, endpointEdge);
+                if (endpoint != Source) weightedDegree[endpoint - 2] += weight;
+            }
+        }
+        const double lambdaMax = *std::max_element(weightedDegree.begin(), weightedDegree.end()) / 2;
+        for (size_t i = 0; i < n; i++) {
+            for (const Edge e : graph.edgesFrom(vertex(i))) {
+                if (graph.get(ToVertex, e) != Sink) continue;
+                graph.set(Capacity, e, FlowFunction(-lambdaMax, lambdaMax));
+            }
+        }
+        return instance;
+    }
+
+}
@@ -1,19 +1,21 @@
 #pragma once
 
+#include <array>
 #include <iostream>
 #include <vector>
 #include <string>
 
 #include "../../Shell/Shell.h"
 
-#include "../../Helpers/Console/ProgressBar.h"
 #include "../../Helpers/IO/Serialization.h"
 #include "../../Helpers/String/String.h"
 #include "../../Helpers/Meta.h"
 
 #include "../Graph/Graph.h"
 
+#include "DimacsReader.h"
 #include "FlowUtils.h"
+#include "InstanceFile.h"
 
 template<typename FLOW_TYPE = int>
 class StaticMaxFlowInstance {
@@ -28,13 +30,18 @@ public:
     }
 
     inline void serialize(const std::string& fileName) const noexcept {
-        IO::serialize(fileName, source, sink);
-        graph.writeBinary(fileName + ".graph");
+        pmf::InstanceFile::write(fileName, graph, source, sink, 0, INFTY);
     }
 
+    // Also reads the legacy layout, which stores the graph in a separate ".graph" file per attribute.
     inline void deserialize(const std::string& fileName) noexcept {
-        IO::deserialize(fileName, source, sink);
-        graph.readBinary(fileName + ".graph");
+        if (pmf::InstanceFile::isInstanceFile(fileName)) {
+            double alphaMin, alphaMax;
+            pmf::InstanceFile::read(fileName, graph, source, sink, alphaMin, alphaMax);
+        } else {
+            IO::deserialize(fileName, source, sink);
+            graph.readBinary(fileName + ".graph");
+        }
     }
 
     inline FlowType getCapacity(const Edge edge) const noexcept {
@@ -57,116 +64,9 @@ public:
     inline void fromDimacs(const std::string& fileName, const FlowType infinity) noexcept {
         const std::string fileNameWithExtension = FileSystem::ensureExtension(fileName, ".max");
         if constexpr (VERBOSE) std::cout << "Reading DIMACS max-flow graph from: " << fileNameWithExtension << std::endl << std::flush;
-        std::ifstream is(fileNameWithExtension);
-        Assert(is.is_open(), "Cannot open file: " << fileNameWithExtension);
-        ProgressBar bar(1);
-        std::cout << "\r                     \r" << std::flush;
-
-        ParametricFlowGraphEdgeList<FlowType> temp;
-        std::vector<bool> hasEdgeFromSource;
-        std::vector<bool> hasEdgeFromSink;
-        size_t vertexCount = -1;
-        size_t edgeCount = -1;
-        source = noVertex;
-        sink = noVertex;
-
-        while (!is.eof()) {
-            std::string line;
-            getline(is, line);
-            line = String::trim(line);
-            if (line.empty() || line[0] == 'c') continue;
-            const std::vector<std::string> tokens = String::split(line, ' ');
-            if (vertexCount == size_t(-1)) {
-                if (tokens.size() != 4 || tokens[0] != "p" || tokens[1] != "max") {
-                    std::cout << "ERROR, invalid DIMACS .max-file header: " << line << std::endl;
-                    break;
-                } else {
-                    vertexCount = String::lexicalCast<size_t>(tokens[2]);
-                    hasEdgeFromSource.resize(vertexCount, false);
-                    hasEdgeFromSink.resize(vertexCount, false);
-                    edgeCount = String::lexicalCast<size_t>(tokens[3]);
-                    temp.reserve(vertexCount, edgeCount);
-                    temp.addVertices(vertexCount);
-                    if constexpr (VERBOSE) bar.init(edgeCount);
-                }
-            } else if (source == noVertex || sink == noVertex) {
-                if (tokens.size() != 3 || tokens[0] != "n" || (tokens[2] != "s" && tokens[2] != "t")) {
-                    std::cout << "ERROR, invalid DIMACS .max-file header: " << line << std::endl;
-                    break;
-                } else if (tokens[2] == "s") {
-                    source = Vertex(String::lexicalCast<size_t>(tokens[1]) - 1);
-                    hasEdgeFromSource[source] = true;
-                    if (!temp.isVertex(source)) {
-                        std::cout << "ERROR, " << tokens[1] << " does not name a vertex!" << std::endl;
-                        break;
-                    }
-                } else {
-                    sink = Vertex(String::lexicalCast<size_t>(tokens[1]) - 1);
-                    hasEdgeFromSink[sink] = true;
-                    if (!temp.isVertex(sink)) {
-                        std::cout << "ERROR, " << tokens[1] << " does not name a vertex!" << std::endl;
-                        break;
-                    }
-                }
-            } else {
-                if (tokens.size() != 4 || tokens[0] != "a") {
-                    std::cout << "WARNING, ignoring line in .max-file: " << line << std::endl;
-                    continue;
-                } else {
-                    const Vertex from(String::lexicalCast<size_t>(tokens[1]) - 1);
-                    const Vertex to(String::lexicalCast<size_t>(tokens[2]) - 1);
-                    const FlowType capacity = String::lexicalCast<FlowType>(tokens[3]);
-                    if (from == source) hasEdgeFromSource[to] = true;
-                    else if (from == sink) hasEdgeFromSink[to] = true;
-                    if (!temp.isVertex(from)) {
-                        std::cout << "ERROR, " << tokens[1] << " does not name a vertex!" << std::endl;
-                        break;
-                    } else if (!temp.isVertex(to)) {
-                        std::cout << "ERROR, " << tokens[2] << " does not name a vertex!" << std::endl;
-                        break;
-                    }
-                    temp.addEdge(from, to).set(Capacity, capacity >= infinity ? INFTY : capacity);
-                    temp.addEdge(to, from).set(Capacity, 0);
-                    if constexpr (VERBOSE) bar++;
-                }
-            }
-        }
-        is.close();
-        if constexpr (VERBOSE) std::cout << std::endl;
-        if (temp.numEdges() / 2 != edgeCount) {
-            std::cout << "WARNING, found " << temp.numEdges() / 2 << " edges, but " << edgeCount << " edges were declared." << std::endl;
-        }
-
-        for (const Vertex vertex: temp.vertices()) {
-            if (!hasEdgeFromSource[vertex]) {
-                temp.addEdge(source, vertex).set(Capacity, 0);
-                temp.addEdge(vertex, source).set(Capacity, 0);
-            }
-            if (!hasEdgeFromSink[vertex]) {
-                temp.addEdge(sink, vertex).set(Capacity, 0);
-                temp.addEdge(vertex, sink).set(Capacity, 0);
-            }
-        }
-
-        temp.sortEdges();
-        ParametricFlowGraphEdgeList<FlowType> temp2;
-        temp2.reserve(vertexCount, edgeCount);
-        temp2.addVertices(vertexCount);
-        Vertex lastFrom = noVertex;
-        Vertex lastTo = noVertex;
-        Edge lastEdge = noEdge;
-        for (const Edge edge : temp.edges()) {
-            const Vertex from = temp.get(FromVertex, edge);
-            const Vertex to = temp.get(ToVertex, edge);
-            if (from == lastFrom && to == lastTo) {
-                temp2.get(Capacity, lastEdge) += temp.get(Capacity, edge);
-            } else {
-                lastFrom = from;
-                lastTo = to;
-                lastEdge = temp2.addEdge(from, to).set(Capacity, temp.get(Capacity, edge));
-            }
-        }
-        Graph::move(std::move(temp2), graph);
+        pmf::Dimacs::read<VERBOSE, FlowType, 1>(fileNameWithExtension, "max", graph, source, sink, [&](const std::array<FlowType, 1>& values) {
+            return values[0] >= infinity ? FlowType(INFTY) : values[0];
+        });
     }
 
 public:
@@ -175,7 +75,7 @@ public:
     Vertex sink;
 };
 
-template<Meta::Derived<pmf::flowFunction> FLOW_FUNCTION>
+template<pmf::flowFunction FLOW_FUNCTION>
 class ParametricMaxFlowInstance {
 public:
     using FlowFunction = FLOW_FUNCTION;
@@ -226,51 +126,63 @@ public:
         sink(staticInstance.sink),
         alphaMin(0),
         alphaMax(INFTY) {
-        Graph::copy(staticInstance.graph, graph);
         int maxCapacity = 0;
-        for (const Edge e : graph.edges()) {
+        for (const Edge e : staticInstance.graph.edges()) {
             const int capacity = staticInstance.graph.get(Capacity, e);
             if (capacity < INFTY) maxCapacity = std::max(maxCapacity, capacity);
-            graph.set(Capacity, e, FlowFunction(capacity));
         }
         std::cout << "Max capacity: " << maxCapacity << std::endl;
+        const bool replaceSinkEdges = sinkEdgeProbability > 0;
+        ParametricFlowGraphEdgeList<FlowFunction> temp;
+        temp.reserve(staticInstance.graph.numVertices(), staticInstance.graph.numEdges());
+        temp.addVertices(staticInstance.graph.numVertices());
+        for (const Vertex from : staticInstance.graph.vertices()) {
+            for (const Edge edge : staticInstance.graph.edgesFrom(from)) {
+                const Vertex to = staticInstance.graph.get(ToVertex, edge);
+                if (from == source || to == source) continue;
+                if (replaceSinkEdges && (from == sink || to == sink)) continue;
+                temp.addEdge(from, to).set(Capacity, FlowFunction(staticInstance.graph.get(Capacity, edge)));
+            }
+        }
         std::mt19937 randomGenerator;
         std::uniform_int_distribution<> distribution(1, maxCapacity);
         std::uniform_real_distribution<> probDist(0, 1);
-        for (const Edge edge : graph.edgesFrom(source)) {
-            if (probDist(randomGenerator) > sourceEdgeProbability) {
-                graph.set(Capacity, edge, FlowFunction(0));
-            } else {
-                const int slope = distribution(randomGenerator);
-                const int minValue = distribution(randomGenerator);
-                graph.set(Capacity, edge, FlowFunction(slope, minValue));
-            }
+        for (const Vertex vertex : temp.vertices()) {
+            if (vertex == source || vertex == sink) continue;
+            if (probDist(randomGenerator) > sourceEdgeProbability) continue;
+            const int slope = distribution(randomGenerator);
+            const int minValue = distribution(randomGenerator);
+            temp.addEdge(source, vertex).set(Capacity, FlowFunction(slope, minValue));
+            temp.addEdge(vertex, source).set(Capacity, FlowFunction(0));
         }
-        if (sinkEdgeProbability > 0) {
+        if (replaceSinkEdges) {
             alphaMax = 1;
-            for (const Edge edge : graph.edgesFrom(sink)) {
-                const Edge reverseEdge = graph.get(ReverseEdge, edge);
-                if (probDist(randomGenerator) > sinkEdgeProbability) {
-                    graph.set(Capacity, reverseEdge, FlowFunction(0));
-                } else {
-                    const int slope = distribution(randomGenerator);
-                    const int maxValue = distribution(randomGenerator);
-                    const double limit = 1 + static_cast<double>(maxValue)/slope;
-                    alphaMax = std::min(limit, alphaMax);
-                    graph.set(Capacity, reverseEdge, FlowFunction(-slope, maxValue + slope));
-                }
+            for (const Vertex vertex : temp.vertices()) {
+                if (vertex == source || vertex == sink) continue;
+                if (probDist(randomGenerator) > sinkEdgeProbability) continue;
+                const int slope = distribution(randomGenerator);
+                const int maxValue = distribution(randomGenerator);
+                const double limit = 1 + static_cast<double>(maxValue)/slope;
+                alphaMax = std::min(limit, alphaMax);
+                temp.addEdge(vertex, sink).set(Capacity, FlowFunction(-slope, maxValue + slope));
+                temp.addEdge(sink, vertex).set(Capacity, FlowFunction(0));
             }
         }
+        Graph::move(std::move(temp), graph);
     }
 
     inline void serialize(const std::string& fileName) const noexcept {
-        IO::serialize(fileName, source, sink, alphaMin, alphaMax);
-        graph.writeBinary(fileName + ".graph");
+        pmf::InstanceFile::write(fileName, graph, source, sink, alphaMin, alphaMax);
     }
 
+    // Also reads the legacy layout, which stores the graph in a separate ".graph" file per attribute.
     inline void deserialize(const std::string& fileName) noexcept {
-        IO::deserialize(fileName, source, sink, alphaMin, alphaMax);
-        graph.readBinary(fileName + ".graph");
+        if (pmf::InstanceFile::isInstanceFile(fileName)) {
+            pmf::InstanceFile::read(fileName, graph, source, sink, alphaMin, alphaMax);
+        } else {
+            IO::deserialize(fileName, source, sink, alphaMin, alphaMax);
+            graph.readBinary(fileName + ".graph");
+        }
     }
 
     inline const FlowFunction& getCapacity(const Edge edge) const noexcept {
@@ -289,120 +201,14 @@ public:
     inline void fromDimacs(const std::string& fileName, const FlowType infinity = INFTY) noexcept {
         const std::string fileNameWithExtension = FileSystem::ensureExtension(fileName, ".max");
         if constexpr (VERBOSE) std::cout << "Reading DIMACS max-flow graph from: " << fileNameWithExtension << std::endl << std::flush;
-        std::ifstream is(fileNameWithExtension);
-        Assert(is.is_open(), "Cannot open file: " << fileNameWithExtension);
-        ProgressBar bar(1);
-        std::cout << "\r                     \r" << std::flush;
-
-        ParametricFlowGraphEdgeList<FlowFunction> temp;
-        std::vector<bool> hasEdgeFromSource;
-        std::vector<bool> hasEdgeFromSink;
-        size_t vertexCount = -1;
-        size_t edgeCount = -1;
-        source = noVertex;
-        sink = noVertex;
-
-        while (!is.eof()) {
-            std::string line;
-            getline(is, line);
-            line = String::trim(line);
-            if (line.empty() || line[0] == 'c') continue;
-            const std::vector<std::string> tokens = String::split(line, ' ');
-            if (vertexCount == size_t(-1)) {
-                if (tokens.size() != 4 || tokens[0] != "p" || tokens[1] != "pmax") {
-                    std::cout << "ERROR, invalid DIMACS .max-file header: " << line << std::endl;
-                    break;
-                } else {
-                    vertexCount = String::lexicalCast<size_t>(tokens[2]);
-                    hasEdgeFromSource.resize(vertexCount, false);
-                    hasEdgeFromSink.resize(vertexCount, false);
-                    edgeCount = String::lexicalCast<size_t>(tokens[3]);
-                    temp.reserve(vertexCount, edgeCount);
-                    temp.addVertices(vertexCount);
-                    if constexpr (VERBOSE) bar.init(edgeCount);
-                }
-            } else if (source == noVertex || sink == noVertex) {
-                if (tokens.size() != 3 || tokens[0] != "n" || (tokens[2] != "s" && tokens[2] != "t")) {
-                    std::cout << "ERROR, invalid DIMACS .max-file header: " << line << std::endl;
-                    break;
-                } else if (tokens[2] == "s") {
-                    source = Vertex(String::lexicalCast<size_t>(tokens[1]) - 1);
-                    hasEdgeFromSource[source] = true;
-                    if (!temp.isVertex(source)) {
-                        std::cout << "ERROR, " << tokens[1] << " does not name a vertex!" << std::endl;
-                        break;
-                    }
-                } else {
-                    sink = Vertex(String::lexicalCast<size_t>(tokens[1]) - 1);
-                    hasEdgeFromSource[sink] = true;
-                    if (!temp.isVertex(sink)) {
-                        std::cout << "ERROR, " << tokens[1] << " does not name a vertex!" << std::endl;
-                        break;
-                    }
-                }
-            } else {
-                if (tokens.size() != 5 || tokens[0] != "a") {
-                    std::cout << "WARNING, ignoring line in .max-file: " << line << std::endl;
-                    continue;
-                } else {
-                    const Vertex from(String::lexicalCast<size_t>(tokens[1]) - 1);
-                    const Vertex to(String::lexicalCast<size_t>(tokens[2]) - 1);
-                    FlowType capacityA = String::lexicalCast<FlowType>(tokens[3]);
-                    if (capacityA >= infinity) capacityA = INFTY;
-                    capacityA = std::min(capacityA, infinity);
-                    FlowType capacityB = String::lexicalCast<FlowType>(tokens[4]);
-                    if (capacityB >= infinity) capacityB = INFTY;
-                    if (from == source) hasEdgeFromSource[to] = true;
-                    else if (from == sink) hasEdgeFromSink[to] = true;
-                    if (!temp.isVertex(from)) {
-                        std::cout << "ERROR, " << tokens[1] << " does not name a vertex!" << std::endl;
-                        break;
-                    } else if (!temp.isVertex(to)) {
-                        std::cout << "ERROR, " << tokens[2] << " does not name a vertex!" << std::endl;
-                        break;
-                    }
-                    temp.addEdge(from, to).set(Capacity, FlowFunction(capacityA, capacityB));
-                    temp.addEdge(to, from).set(Capacity, FlowFunction(0));
-                    if constexpr (VERBOSE) bar++;
-                }
-            }
-        }
-        is.close();
-        if constexpr (VERBOSE) std::cout << std::endl;
-        if (temp.numEdges() / 2 != edgeCount) {
-            std::cout << "WARNING, found " << temp.numEdges() / 2 << " edges, but " << edgeCount << " edges were declared." << std::endl;
-        }
-
-        for (const Vertex vertex: temp.vertices()) {
-            if (!hasEdgeFromSource[vertex]) {
-                temp.addEdge(source, vertex).set(Capacity, FlowFunction(0));
-                temp.addEdge(vertex, source).set(Capacity, FlowFunction(0));
-            }
-            if (!hasEdgeFromSink[vertex]) {
-                temp.addEdge(sink, vertex).set(Capacity, FlowFunction(0));
-                temp.addEdge(vertex, sink).set(Capacity, FlowFunction(0));
-            }
-        }
-
-        temp.sortEdges();
-        ParametricFlowGraphEdgeList<FlowFunction> temp2;
-        temp2.reserve(vertexCount, edgeCount);
-        temp2.addVertices(vertexCount);
-        Vertex lastFrom = noVertex;
-        Vertex lastTo = noVertex;
-        Edge lastEdge = noEdge;
-        for (const Edge edge : temp.edges()) {
-            const Vertex from = temp.get(FromVertex, edge);
-            const Vertex to = temp.get(ToVertex, edge);
-            if (from == lastFrom && to == lastTo) {
-                temp2.get(Capacity, lastEdge) += temp.get(Capacity, edge);
-            } else {
-                lastFrom = from;
-                lastTo = to;
-                lastEdge = temp2.addEdge(from, to).set(Capacity, temp.get(Capacity, edge));
-            }
-        }
-        Graph::move(std::move(temp2), graph);
+        pmf::Dimacs::read<VERBOSE, FlowType, 2>(fileNameWithExtension, "pmax", graph, source, sink, [&](const std::array<FlowType, 2>& values) {
+            FlowType capacityA = values[0];
+            if (capacityA >= infinity) capacityA = INFTY;
+            capacityA = std::min(capacityA, infinity);
+            FlowType capacityB = values[1];
+            if (capacityB >= infinity) capacityB = INFTY;
+            return FlowFunction(capacityA, capacityB);
+        });
     }
 
 public:
@@ -413,7 +219,7 @@ public:
     double alphaMax;
 };
 
-template<Meta::Derived<pmf::flowFunction> FLOW_FUNCTION>
+template<pmf::flowFunction FLOW_FUNCTION>
 class RestartableMaxFlowWrapper {
 public:
     using FlowFunction = FLOW_FUNCTION;
@@ -489,7 +295,7 @@ public:
     std::vector<FlowType> sinkDiff;
 };
 
-template<Meta::Derived<pmf::flowFunction> FLOW_FUNCTION>
+template<pmf::flowFunction FLOW_FUNCTION>
 class ChordSchemeMaxFlowWrapper {
 public:
     using FlowFunction = FLOW_FUNCTION;
@@ -514,13 +320,13 @@ public:
     ChordSchemeMaxFlowWrapper(const InstanceType& instance) :
         ChordSchemeMaxFlowWrapper(instance, instance.alphaMin) {}
 
-    ChordSchemeMaxFlowWrapper(const Type& parent, const GraphType& graph, const Vertex source, const Vertex sink, const std::vector<Vertex>& newToOldVertex) :
-        graph(graph),
+    ChordSchemeMaxFlowWrapper(const Type& parent, GraphType&& graph, const Vertex source, const Vertex sink, std::vector<Vertex>&& newToOldVertex) :
+        graph(std::move(graph)),
         source(source),
         sink(sink),
         alpha(parent.alpha),
-        currentCapacity(graph.numEdges()),
-        newToOldVertex(newToOldVertex) {
+        currentCapacity(this->graph.numEdges()),
+        newToOldVertex(std::move(newToOldVertex)) {
     }
 
     inline const FlowType& getCapacity(const Edge edge) const noexcept {
@@ -547,126 +353,218 @@ public:
     }
 
     inline Type contractSourceComponent(const std::vector<bool>& inSinkComponent) const noexcept {
-        GraphType contractedGraph;
-        std::vector<Vertex> newToOldMapping;
-        Vertex newSource = noVertex;
-        Vertex newSink = noVertex;
-        Graph::copy(graph, contractedGraph);
-        std::vector<Edge> fromSourceEdge(contractedGraph.numVertices(), noEdge);
-        std::vector<Edge> toSourceEdge(contractedGraph.numVertices(), noEdge);
-        for (const Edge edge : contractedGraph.edgesFrom(source)) {
-            const Vertex to = contractedGraph.get(ToVertex, edge);
-            if (!inSinkComponent[to]) continue;
-            fromSourceEdge[to] = edge;
-            toSourceEdge[to] = contractedGraph.get(ReverseEdge, edge);
-        }
-        for (const Vertex vertex : contractedGraph.vertices()) {
-            if (inSinkComponent[vertex] || vertex == source) {
-                if (vertex == source) newSource = Vertex(newToOldMapping.size());
-                else if (vertex == sink) newSink = Vertex(newToOldMapping.size());
-                newToOldMapping.emplace_back(newToOldVertex[vertex]);
-                continue;
-            }
-            for (const Edge edge : contractedGraph.edgesFrom(vertex)) {
-                const Vertex to = contractedGraph.get(ToVertex, edge);
-                if (!inSinkComponent[to]) continue;
-                contractedGraph.get(Capacity, fromSourceEdge[to]) += contractedGraph.get(Capacity, edge);
-                const Edge reverseEdge = contractedGraph.get(ReverseEdge, edge);
-                contractedGraph.get(Capacity, toSourceEdge[to]) += contractedGraph.get(Capacity, reverseEdge);
-            }
-        }
-        contractedGraph.deleteVertices([&](const Vertex vertex) {
-            return !inSinkComponent[vertex] && vertex != source;
+        return contract([&](const Vertex vertex) {
+            return !inSinkComponent[vertex];
+        }, [](const Vertex) {
+            return false;
         });
-        return {*this, contractedGraph, newSource, newSink, newToOldMapping};
     }
 
     inline Type contractSinkComponent(const std::vector<bool>& inSinkComponent) const noexcept {
-        GraphType contractedGraph;
-        std::vector<Vertex> newToOldMapping;
-        Vertex newSource = noVertex;
-        Vertex newSink = noVertex;
-        Graph::copy(graph, contractedGraph);
-        std::vector<Edge> fromSinkEdge(contractedGraph.numVertices(), noEdge);
-        std::vector<Edge> toSinkEdge(contractedGraph.numVertices(), noEdge);
-        for (const Edge edge : contractedGraph.edgesFrom(sink)) {
-            const Vertex to = contractedGraph.get(ToVertex, edge);
-            if (inSinkComponent[to]) continue;
-            fromSinkEdge[to] = edge;
-            toSinkEdge[to] = contractedGraph.get(ReverseEdge, edge);
-        }
-        for (const Vertex vertex : contractedGraph.vertices()) {
-            if (!inSinkComponent[vertex] || vertex == sink) {
-                if (vertex == source) newSource = Vertex(newToOldMapping.size());
-                else if (vertex == sink) newSink = Vertex(newToOldMapping.size());
-                newToOldMapping.emplace_back(newToOldVertex[vertex]);
-                continue;
-            }
-            for (const Edge edge : contractedGraph.edgesFrom(vertex)) {
-                const Vertex to = contractedGraph.get(ToVertex, edge);
-                if (inSinkComponent[to]) continue;
-                contractedGraph.get(Capacity, fromSinkEdge[to]) += contractedGraph.get(Capacity, edge);
-                const Edge reverseEdge = contractedGraph.get(ReverseEdge, edge);
-                contractedGraph.get(Capacity, toSinkEdge[to]) += contractedGraph.get(Capacity, reverseEdge);
-            }
-        }
-        contractedGraph.deleteVertices([&](const Vertex vertex) {
-            return inSinkComponent[vertex] && vertex != sink;
+        return contract([](const Vertex) {
+            return false;
+        }, [&](const Vertex vertex) {
+            return inSinkComponent[vertex];
         });
-        return {*this, contractedGraph, newSource, newSink, newToOldMapping};
     }
 
     inline Type contractSourceAndSinkComponents(const std::vector<bool>& inSinkComponent1, const std::vector<bool>& inSinkComponent2) const noexcept {
-        GraphType contractedGraph;
+        return contract([&](const Vertex vertex) {
+            return !inSinkComponent1[vertex];
+        }, [&](const Vertex vertex) {
+            return inSinkComponent2[vertex];
+        });
+    }
+
+private:
+    // Scratch memory of contract(). It is kept per thread, so repeated contractions during a recursion do not allocate.
+    struct ContractionArena {
+        std::vector<Vertex> oldToNewVertex;
+        std::vector<Vertex> newToLocalVertex;
+        std::vector<Edge> newEdgeOfOldEdge;
+        std::vector<size_t> outDegree;
+        std::vector<FlowFunction> fromSourceCapacity;
+        std::vector<FlowFunction> toSourceCapacity;
+        std::vector<FlowFunction> fromSinkCapacity;
+        std::vector<FlowFunction> toSinkCapacity;
+        std::vector<bool> hasSourceEdge;
+        std::vector<bool> hasSinkEdge;
+        std::vector<Edge> sourceEdge;
+        std::vector<Edge> sinkEdge;
+    };
+
+    // Merges all vertices selected by mergeIntoSource/mergeIntoSink into the respective terminal.
+    // Arcs between a remaining vertex and a terminal are accumulated per vertex, so that every
+    // vertex ends up with at most one arc pair per terminal, and only if it had a terminal arc before.
+    // The contracted graph is written directly in CSR form: a counting pass over the remaining vertices computes the
+    // out-degrees, a second pass fills in the edges. Edges of merged vertices are only scanned for one terminal side,
+    // in order to find arcs between the two terminals.
+    template<typename MERGE_INTO_SOURCE, typename MERGE_INTO_SINK>
+    inline Type contract(const MERGE_INTO_SOURCE& mergeIntoSource, const MERGE_INTO_SINK& mergeIntoSink) const noexcept {
+        ContractionArena& arena = contractionArena;
+        std::vector<Vertex>& oldToNewVertex = arena.oldToNewVertex;
+        std::vector<Vertex>& newToLocalVertex = arena.newToLocalVertex;
+        oldToNewVertex.resize(graph.numVertices());
+        newToLocalVertex.clear();
         std::vector<Vertex> newToOldMapping;
-        Vertex newSource = noVertex;
-        Vertex newSink = noVertex;
-        Graph::copy(graph, contractedGraph);
-        std::vector<Edge> fromSourceEdge(contractedGraph.numVertices(), noEdge);
-        std::vector<Edge> toSourceEdge(contractedGraph.numVertices(), noEdge);
-        for (const Edge edge : contractedGraph.edgesFrom(source)) {
-            const Vertex to = contractedGraph.get(ToVertex, edge);
-            if (!inSinkComponent1[to]) continue;
-            fromSourceEdge[to] = edge;
-            toSourceEdge[to] = contractedGraph.get(ReverseEdge, edge);
+        for (const Vertex vertex : graph.vertices()) {
+            if (vertex != source && vertex != sink && (mergeIntoSource(vertex) || mergeIntoSink(vertex))) {
+                oldToNewVertex[vertex] = noVertex;
+                continue;
+            }
+            oldToNewVertex[vertex] = Vertex(newToLocalVertex.size());
+            newToLocalVertex.emplace_back(vertex);
+            newToOldMapping.emplace_back(newToOldVertex[vertex]);
         }
-        std::vector<Edge> fromSinkEdge(contractedGraph.numVertices(), noEdge);
-        std::vector<Edge> toSinkEdge(contractedGraph.numVertices(), noEdge);
-        for (const Edge edge : contractedGraph.edgesFrom(sink)) {
-            const Vertex to = contractedGraph.get(ToVertex, edge);
-            if (inSinkComponent2[to]) continue;
-            fromSinkEdge[to] = edge;
-            toSinkEdge[to] = contractedGraph.get(ReverseEdge, edge);
+        const Vertex newSource = oldToNewVertex[source];
+        const Vertex newSink = oldToNewVertex[sink];
+        size_t sourceSideSize = 1;
+        size_t sinkSideSize = 1;
+        for (const Vertex vertex : graph.vertices()) {
+            if (oldToNewVertex[vertex] != noVertex) continue;
+            if (mergeIntoSource(vertex)) {
+                oldToNewVertex[vertex] = newSource;
+                sourceSideSize++;
+            } else {
+                oldToNewVertex[vertex] = newSink;
+                sinkSideSize++;
+            }
         }
-        for (const Vertex vertex : contractedGraph.vertices()) {
-            if (!inSinkComponent1[vertex] && vertex != source) {
-                for (const Edge edge : contractedGraph.edgesFrom(vertex)) {
-                    const Vertex to = contractedGraph.get(ToVertex, edge);
-                    if (!inSinkComponent1[to]) continue;
-                    contractedGraph.get(Capacity, fromSourceEdge[to]) += contractedGraph.get(Capacity, edge);
-                    const Edge reverseEdge = contractedGraph.get(ReverseEdge, edge);
-                    contractedGraph.get(Capacity, toSourceEdge[to]) += contractedGraph.get(Capacity, reverseEdge);
+
+        const size_t numContractedVertices = newToLocalVertex.size();
+        std::vector<size_t>& outDegree = arena.outDegree;
+        std::vector<FlowFunction>& fromSourceCapacity = arena.fromSourceCapacity;
+        std::vector<FlowFunction>& toSourceCapacity = arena.toSourceCapacity;
+        std::vector<FlowFunction>& fromSinkCapacity = arena.fromSinkCapacity;
+        std::vector<FlowFunction>& toSinkCapacity = arena.toSinkCapacity;
+        std::vector<bool>& hasSourceEdge = arena.hasSourceEdge;
+        std::vector<bool>& hasSinkEdge = arena.hasSinkEdge;
+        outDegree.assign(numContractedVertices, 0);
+        fromSourceCapacity.assign(numContractedVertices, FlowFunction(0));
+        toSourceCapacity.assign(numContractedVertices, FlowFunction(0));
+        fromSinkCapacity.assign(numContractedVertices, FlowFunction(0));
+        toSinkCapacity.assign(numContractedVertices, FlowFunction(0));
+        hasSourceEdge.assign(numContractedVertices, false);
+        hasSinkEdge.assign(numContractedVertices, false);
+
+        // Counting pass. Capacities of arcs from a terminal are read off the reverse arcs.
+        for (const Vertex from : Range<Vertex>(Vertex(0), Vertex(numContractedVertices))) {
+            if (from == newSource || from == newSink) continue;
+            for (const Edge edge : graph.edgesFrom(newToLocalVertex[from])) {
+                const Vertex to = oldToNewVertex[graph.get(ToVertex, edge)];
+                if (to == from) continue;
+                if (to == newSource) {
+                    toSourceCapacity[from] += graph.get(Capacity, edge);
+                    fromSourceCapacity[from] += graph.get(Capacity, graph.get(ReverseEdge, edge));
+                    hasSourceEdge[from] = true;
+                } else if (to == newSink) {
+                    toSinkCapacity[from] += graph.get(Capacity, edge);
+                    fromSinkCapacity[from] += graph.get(Capacity, graph.get(ReverseEdge, edge));
+                    hasSinkEdge[from] = true;
+                } else {
+                    outDegree[from]++;
                 }
-            } else if (inSinkComponent2[vertex] && vertex != sink) {
-                for (const Edge edge : contractedGraph.edgesFrom(vertex)) {
-                    const Vertex to = contractedGraph.get(ToVertex, edge);
-                    if (inSinkComponent2[to]) continue;
-                    contractedGraph.get(Capacity, fromSinkEdge[to]) += contractedGraph.get(Capacity, edge);
-                    const Edge reverseEdge = contractedGraph.get(ReverseEdge, edge);
-                    contractedGraph.get(Capacity, toSinkEdge[to]) += contractedGraph.get(Capacity, reverseEdge);
+            }
+        }
+        // Arcs between the two terminals are stored as a source arc pair of the sink.
+        const bool scanSourceSide = sourceSideSize <= sinkSideSize;
+        const Vertex scannedTerminal = scanSourceSide ? newSource : newSink;
+        const Vertex otherTerminal = scanSourceSide ? newSink : newSource;
+        std::vector<FlowFunction>& forwardCapacity = scanSourceSide ? fromSourceCapacity : toSourceCapacity;
+        std::vector<FlowFunction>& backwardCapacity = scanSourceSide ? toSourceCapacity : fromSourceCapacity;
+        for (const Vertex vertex : graph.vertices()) {
+            if (oldToNewVertex[vertex] != scannedTerminal) continue;
+            for (const Edge edge : graph.edgesFrom(vertex)) {
+                if (oldToNewVertex[graph.get(ToVertex, edge)] != otherTerminal) continue;
+                forwardCapacity[newSink] += graph.get(Capacity, edge);
+                backwardCapacity[newSink] += graph.get(Capacity, graph.get(ReverseEdge, edge));
+                hasSourceEdge[newSink] = true;
+            }
+        }
+        for (const Vertex vertex : Range<Vertex>(Vertex(0), Vertex(numContractedVertices))) {
+            if (hasSourceEdge[vertex]) {
+                outDegree[vertex]++;
+                outDegree[newSource]++;
+            }
+            if (hasSinkEdge[vertex]) {
+                outDegree[vertex]++;
+                outDegree[newSink]++;
+            }
+        }
+
+        GraphType contractedGraph;
+        contractedGraph.setOutDegrees(outDegree);
+        std::vector<Vertex>& toVertex = contractedGraph[ToVertex];
+        std::vector<Edge>& reverseEdge = contractedGraph[ReverseEdge];
+        std::vector<FlowFunction>& capacity = contractedGraph[Capacity];
+        const auto addEdgePair = [&](const Edge edge, const Edge reverse) {
+            reverseEdge[edge] = reverse;
+            reverseEdge[reverse] = edge;
+        };
+
+        // Filling pass. An arc between two remaining vertices is paired with its reverse once both have been written.
+        std::vector<Edge>& newEdgeOfOldEdge = arena.newEdgeOfOldEdge;
+        std::vector<Edge>& sourceEdge = arena.sourceEdge;
+        std::vector<Edge>& sinkEdge = arena.sinkEdge;
+        newEdgeOfOldEdge.resize(graph.numEdges());
+        sourceEdge.resize(numContractedVertices);
+        sinkEdge.resize(numContractedVertices);
+        for (const Vertex from : Range<Vertex>(Vertex(0), Vertex(numContractedVertices))) {
+            if (from == newSource || from == newSink) continue;
+            Edge newEdge = contractedGraph.beginEdgeFrom(from);
+            for (const Edge edge : graph.edgesFrom(newToLocalVertex[from])) {
+                const Vertex to = oldToNewVertex[graph.get(ToVertex, edge)];
+                if (to == from || to == newSource || to == newSink) continue;
+                toVertex[newEdge] = to;
+                capacity[newEdge] = graph.get(Capacity, edge);
+                if (to < from) {
+                    addEdgePair(newEdge, newEdgeOfOldEdge[graph.get(ReverseEdge, edge)]);
+                } else {
+                    newEdgeOfOldEdge[edge] = newEdge;
                 }
-            } else {
-                if (vertex == source) newSource = Vertex(newToOldMapping.size());
-                else if (vertex == sink) newSink = Vertex(newToOldMapping.size());
-                newToOldMapping.emplace_back(newToOldVertex[vertex]);
+                newEdge++;
+            }
+            if (hasSourceEdge[from]) {
+                sourceEdge[from] = newEdge;
+                toVertex[newEdge] = newSource;
+                capacity[newEdge] = toSourceCapacity[from];
+                newEdge++;
+            }
+            if (hasSinkEdge[from]) {
+                sinkEdge[from] = newEdge;
+                toVertex[newEdge] = newSink;
+                capacity[newEdge] = toSinkCapacity[from];
+                newEdge++;
             }
         }
-        contractedGraph.deleteVertices([&](const Vertex vertex) {
-            return (!inSinkComponent1[vertex] && vertex != source) || (inSinkComponent2[vertex] && vertex != sink);
-        });
-        return {*this, contractedGraph, newSource, newSink, newToOldMapping};
+        Edge newEdge = contractedGraph.beginEdgeFrom(newSink);
+        for (const Vertex vertex : Range<Vertex>(Vertex(0), Vertex(numContractedVertices))) {
+            if (vertex == newSink && hasSourceEdge[newSink]) {
+                sourceEdge[newSink] = newEdge;
+                toVertex[newEdge] = newSource;
+                capacity[newEdge] = toSourceCapacity[newSink];
+                newEdge++;
+            } else if (hasSinkEdge[vertex]) {
+                toVertex[newEdge] = vertex;
+                capacity[newEdge] = fromSinkCapacity[vertex];
+                addEdgePair(newEdge, sinkEdge[vertex]);
+                newEdge++;
+            }
+        }
+        newEdge = contractedGraph.beginEdgeFrom(newSource);
+        for (const Vertex vertex : Range<Vertex>(Vertex(0), Vertex(numContractedVertices))) {
+            if (!hasSourceEdge[vertex]) continue;
+            toVertex[newEdge] = vertex;
+            capacity[newEdge] = fromSourceCapacity[vertex];
+            addEdgePair(newEdge, sourceEdge[vertex]);
+            newEdge++;
+        }
+        Assert(contractedGraph.satisfiesInvariants(), "Contracted graph does not satisfy invariants!");
+        return Type(*this, std::move(contractedGraph), newSource, newSink, std::move(newToOldMapping));
     }
 
+    inline static thread_local ContractionArena contractionArena;
+
 public:
     GraphType graph;
     const Vertex source;
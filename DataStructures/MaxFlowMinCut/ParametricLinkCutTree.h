@@ -0,0 +1,331 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "../Container/ExternalKHeap.h"
+#include "../Graph/Graph.h"
+
+#include "FlowUtils.h"
+
+#include "../../Helpers/Assert.h"
+#include "../../Helpers/Types.h"
+
+/**
+ * Link-cut forest whose vertices carry the residual capacity of their parent edge as a linear function of alpha.
+ * Every tree vertex stores the function as a parametric part, which is changed by addToPath() and returned by cut(),
+ * plus a constant offset that is fixed while the edge exists.
+ * Draining an excess function from a vertex to the root is a single addToPath(), in O(log n) amortized time.
+ *
+ * Bottlenecks are found kinetically, with the clock at the current alpha. Every splay subtree keeps the edge with the
+ * smallest residual just after the clock, plus a certificate: the first alpha at which this may change. Adding the same
+ * function to all edges of a subtree leaves both intact, so path additions stay lazy. The roots of the splay trees are
+ * kept in a heap, keyed by the earlier of their certificate and the zero crossing of their minimum edge. Certificates
+ * that fail before the next zero crossing are repaired on the way. As certificates compare lines, this needs linear
+ * flow functions.
+ */
+template<pmf::flowFunction FLOW_FUNCTION>
+class ParametricLinkCutTree {
+public:
+    using FlowFunction = FLOW_FUNCTION;
+    using FlowType = FlowFunction::FlowType;
+
+private:
+    struct Node {
+        Vertex child[2] = {noVertex, noVertex};
+        // Parent in the splay tree, or the path parent if this is the root of a splay tree.
+        Vertex parent = noVertex;
+        bool hasValue = false;
+        bool hasLazy = false;
+        FlowFunction value = FlowFunction(0);
+        FlowType offset = 0;
+        FlowFunction lazy = FlowFunction(0);
+        // Edge of the splay subtree with the smallest residual, its residual and the certificate.
+        Vertex minVertex = noVertex;
+        FlowFunction minResidual = FlowFunction(0);
+        double certificate = INFTY;
+    };
+
+    struct EventLabel : public ExternalKHeapElement {
+        EventLabel() : ExternalKHeapElement(), value_(INFTY) {}
+
+        inline bool hasSmallerKey(const EventLabel* other) const noexcept {
+            return value_ < other->value_;
+        }
+        double value_;
+    };
+
+public:
+    ParametricLinkCutTree(const int n, const double alphaMax) :
+        nodes_(n),
+        events_(n),
+        eventQ_(n),
+        alphaMax_(alphaMax),
+        now_(-INFTY) {
+    }
+
+    // Sets the clock. Must not be later than the next event.
+    inline void advance(const double alpha) noexcept {
+        Assert(alpha >= now_, "The clock cannot be turned back!");
+        now_ = alpha;
+    }
+
+    // Makes parent the parent of the tree root child, with a parent edge whose residual is value + offset.
+    inline void link(const Vertex child, const Vertex parent, const FlowFunction& value, const FlowType offset) noexcept {
+        access(child);
+        Node& node = nodes_[child];
+        Assert(node.child[0] == noVertex && !node.hasValue, "Vertex " << child << " already has a parent!");
+        node.hasValue = true;
+        node.value = value;
+        node.offset = offset;
+        pull(child);
+        node.parent = parent;
+        updateEvent(child);
+    }
+
+    // Removes the parent edge of child and returns its parametric part.
+    inline FlowFunction cut(const Vertex child) noexcept {
+        access(child);
+        Node& node = nodes_[child];
+        Assert(node.hasValue, "Vertex " << child << " has no parent!");
+        const Vertex above = node.child[0];
+        if (above != noVertex) {
+            nodes_[above].parent = noVertex;
+            node.child[0] = noVertex;
+            updateEvent(above);
+        }
+        const FlowFunction value = node.value;
+        node.hasValue = false;
+        node.value = FlowFunction(0);
+        pull(child);
+        updateEvent(child);
+        return value;
+    }
+
+    // Adds f to the parametric part of every edge on the path from v to its root.
+    inline void addToPath(const Vertex v, const FlowFunction& f) noexcept {
+        access(v);
+        applyLazy(v, f);
+        updateEvent(v);
+    }
+
+    inline bool hasParent(const Vertex v) const noexcept {
+        return nodes_[v].hasValue;
+    }
+
+    inline FlowFunction getValue(const Vertex v) noexcept {
+        access(v);
+        return nodes_[v].value;
+    }
+
+    // The next alpha up to limit at which the residual of some edge reaches zero, or INFTY if there is none.
+    // Repairing the certificates before it moves the clock up to this alpha, but never beyond limit.
+    inline double nextEvent(const double limit = INFTY) noexcept {
+        repairUntil(limit);
+        if (eventQ_.empty() || eventQ_.front()->value_ > limit) return INFTY;
+        return eventQ_.front()->value_;
+    }
+
+    // An edge whose residual reaches zero at alpha, given as its child vertex, or noVertex if there is none left.
+    // Certificates are only repaired up to alpha, so the clock stays at alpha.
+    inline Vertex nextBottleneck(const double alpha) noexcept {
+        repairUntil(alpha);
+        if (eventQ_.empty() || eventQ_.front()->value_ != alpha) return noVertex;
+        const Vertex root(eventQ_.front() - &(events_[0]));
+        return nodes_[root].minVertex;
+    }
+
+private:
+    inline bool isRoot(const Vertex v) const noexcept {
+        const Vertex p = nodes_[v].parent;
+        return p == noVertex || (nodes_[p].child[0] != v && nodes_[p].child[1] != v);
+    }
+
+    inline void applyLazy(const Vertex v, const FlowFunction& f) noexcept {
+        Node& node = nodes_[v];
+        if (node.hasValue) node.value += f;
+        if (node.minVertex != noVertex) node.minResidual += f;
+        if (node.hasLazy) {
+            node.lazy += f;
+        } else {
+            node.lazy = f;
+            node.hasLazy = true;
+        }
+    }
+
+    inline void push(const Vertex v) noexcept {
+        Node& node = nodes_[v];
+        if (!node.hasLazy) return;
+        for (const Vertex c : node.child) {
+            if (c != noVertex) applyLazy(c, node.lazy);
+        }
+        node.hasLazy = false;
+    }
+
+    // Decides which of two lines is smaller just after the clock, and until when this holds.
+    inline bool isFirstSmaller(const FlowFunction& first, const FlowFunction& second, double& certificate) const noexcept {
+        const double firstValue = first.eval(now_);
+        const double secondValue = second.eval(now_);
+        if (firstValue == INFTY || secondValue == INFTY || first.getSlope() == second.getSlope()) return firstValue <= secondValue;
+        const double crossing = findIntersectionPoint(first, second);
+        if (now_ < crossing) {
+            certificate = std::min(certificate, crossing);
+            return first.getSlope() > second.getSlope();
+        }
+        return first.getSlope() < second.getSlope();
+    }
+
+    inline void pull(const Vertex v) noexcept {
+        Node& node = nodes_[v];
+        node.minVertex = noVertex;
+        node.certificate = INFTY;
+        const auto consider = [&](const Vertex candidate, const FlowFunction& residual) {
+            if (node.minVertex == noVertex || !isFirstSmaller(node.minResidual, residual, node.certificate)) {
+                node.minVertex = candidate;
+                node.minResidual = residual;
+            }
+        };
+        if (node.child[0] != noVertex) {
+            const Node& left = nodes_[node.child[0]];
+            node.certificate = std::min(node.certificate, left.certificate);
+            if (left.minVertex != noVertex) consider(left.minVertex, left.minResidual);
+        }
+        if (node.hasValue) consider(v, node.value + FlowFunction(node.offset));
+        if (node.child[1] != noVertex) {
+            const Node& right = nodes_[node.child[1]];
+            node.certificate = std::min(node.certificate, right.certificate);
+            if (right.minVertex != noVertex) consider(right.minVertex, right.minResidual);
+        }
+    }
+
+    inline void rotate(const Vertex v) noexcept {
+        const Vertex p = nodes_[v].parent;
+        const Vertex g = nodes_[p].parent;
+        const int side = (nodes_[p].child[1] == v) ? 1 : 0;
+        if (!isRoot(p)) {
+            nodes_[g].child[(nodes_[g].child[1] == p) ? 1 : 0] = v;
+        }
+        nodes_[v].parent = g;
+        const Vertex moved = nodes_[v].child[1 - side];
+        nodes_[p].child[side] = moved;
+        if (moved != noVertex) nodes_[moved].parent = p;
+        nodes_[v].child[1 - side] = p;
+        nodes_[p].parent = v;
+        pull(p);
+        pull(v);
+    }
+
+    // Makes v the root of its splay tree. The event of the previous root is dropped; the caller updates the new one.
+    inline void splay(const Vertex v) noexcept {
+        splayPath_.clear();
+        Vertex root = v;
+        splayPath_.emplace_back(root);
+        while (!isRoot(root)) {
+            root = nodes_[root].parent;
+            splayPath_.emplace_back(root);
+        }
+        for (size_t i = splayPath_.size(); i-- > 0;) {
+            push(splayPath_[i]);
+        }
+        if (root == v) return;
+        removeEvent(root);
+        while (!isRoot(v)) {
+            const Vertex p = nodes_[v].parent;
+            if (!isRoot(p)) {
+                const Vertex g = nodes_[p].parent;
+                const bool zigZig = (nodes_[g].child[1] == p) == (nodes_[p].child[1] == v);
+                rotate(zigZig ? p : v);
+            }
+            rotate(v);
+        }
+    }
+
+    // Makes the path from the root to v the splay tree of v, with v as its root and last vertex.
+    inline void access(const Vertex v) noexcept {
+        Vertex last = noVertex;
+        for (Vertex u = v; u != noVertex; u = nodes_[u].parent) {
+            splay(u);
+            const Vertex below = nodes_[u].child[1];
+            if (below != noVertex) updateEvent(below);
+            if (last != noVertex) removeEvent(last);
+            nodes_[u].child[1] = last;
+            pull(u);
+            last = u;
+        }
+        splay(v);
+        updateEvent(v);
+    }
+
+    // Repairs the certificates that fail no later than limit and before the next zero crossing.
+    inline void repairUntil(const double limit) noexcept {
+        while (!eventQ_.empty()) {
+            const EventLabel* label = eventQ_.front();
+            const Vertex root(label - &(events_[0]));
+            if (label->value_ > limit || nodes_[root].certificate > label->value_) break;
+            now_ = nodes_[root].certificate;
+            repair(root);
+            updateEvent(root);
+        }
+    }
+
+    // Recomputes the failed certificates in the splay subtree of v, children first.
+    inline void repair(const Vertex v) noexcept {
+        repairStack_.clear();
+        repairOrder_.clear();
+        repairStack_.emplace_back(v);
+        while (!repairStack_.empty()) {
+            const Vertex u = repairStack_.back();
+            repairStack_.pop_back();
+            push(u);
+            repairOrder_.emplace_back(u);
+            for (const Vertex c : nodes_[u].child) {
+                if (c != noVertex && nodes_[c].certificate <= now_) repairStack_.emplace_back(c);
+            }
+        }
+        for (size_t i = repairOrder_.size(); i-- > 0;) {
+            pull(repairOrder_[i]);
+        }
+    }
+
+    // Same convention as ParametricIBFS: a residual that is zero at the clock becomes a bottleneck right after it.
+    // So does a residual that is already negative, e.g. by rounding, since it would hide the edges above it otherwise.
+    inline double getZeroCrossing(const FlowFunction& residual) const noexcept {
+        const double value = residual.eval(now_);
+        const double slope = residual.getSlope();
+        if (value <= 0 || (slope == 0 && value <= pmf::epsilon)) return std::nextafter(now_, alphaMax_);
+        if (slope >= 0) return INFTY;
+        const double crossing = residual.getNextZeroCrossing(now_);
+        return (crossing > now_) ? crossing : std::nextafter(now_, alphaMax_);
+    }
+
+    inline void updateEvent(const Vertex root) noexcept {
+        const Node& node = nodes_[root];
+        double event = node.certificate;
+        if (node.minVertex != noVertex) event = std::min(event, getZeroCrossing(node.minResidual));
+        EventLabel& label = events_[root];
+        label.value_ = event;
+        if (event == INFTY) {
+            if (eventQ_.contains(&label)) eventQ_.remove(&label);
+        } else {
+            eventQ_.update(&label);
+        }
+    }
+
+    inline void removeEvent(const Vertex root) noexcept {
+        EventLabel& label = events_[root];
+        if (eventQ_.contains(&label)) eventQ_.remove(&label);
+        label.value_ = INFTY;
+    }
+
+private:
+    std::vector<Node> nodes_;
+    std::vector<EventLabel> events_;
+    ExternalKHeap<2, EventLabel> eventQ_;
+    const double alphaMax_;
+    double now_;
+
+    std::vector<Vertex> splayPath_;
+    std::vector<Vertex> repairStack_;
+    std::vector<Vertex> repairOrder_;
+};
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "../Assert.h"
+
+namespace IO {
+
+    //################################################# Mapped File ###################################################################//
+    // Read-only, private memory mapping of a whole file. The mapping is released when the object is destroyed, so
+    // data that must outlive it has to be copied out.
+    class MappedFile {
+
+    public:
+        explicit MappedFile(const std::string& fileName) :
+            fileName(fileName) {
+            const int fileDescriptor = ::open(fileName.c_str(), O_RDONLY);
+            Ensure(fileDescriptor >= 0, "cannot open file: " << fileName);
+            struct stat fileStatus;
+            Ensure(::fstat(fileDescriptor, &fileStatus) == 0, "cannot stat file: " << fileName);
+            fileSize = fileStatus.st_size;
+            if (fileSize > 0) {
+                void* mapping = ::mmap(nullptr, fileSize, PROT_READ, MAP_PRIVATE, fileDescriptor, 0);
+                Ensure(mapping != MAP_FAILED, "cannot map file: " << fileName);
+                fileData = static_cast<const char*>(mapping);
+            }
+            ::close(fileDescriptor);
+        }
+
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        MappedFile(MappedFile&& other) noexcept :
+            fileName(std::move(other.fileName)),
+            fileData(std::exchange(other.fileData, nullptr)),
+            fileSize(std::exchange(other.fileSize, 0)) {
+        }
+
+        ~MappedFile() {
+            if (fileData) ::munmap(const_cast<char*>(fileData), fileSize);
+        }
+
+    public:
+        inline const char* data() const noexcept {
+            return fileData;
+        }
+
+        inline size_t size() const noexcept {
+            return fileSize;
+        }
+
+        inline std::string_view view() const noexcept {
+            return std::string_view(fileData, fileSize);
+        }
+
+        inline const std::string& getFileName() const noexcept {
+            return fileName;
+        }
+
+        // Hints that the file will be read front to back, which enables aggressive read-ahead.
+        inline void adviseSequential() const noexcept {
+            if (fileData) ::madvise(const_cast<char*>(fileData), fileSize, MADV_SEQUENTIAL);
+        }
+
+    private:
+        std::string fileName;
+        const char* fileData{nullptr};
+        size_t fileSize{0};
+
+    };
+
+}
@@ -302,6 +302,18 @@ namespace Vector {
         return static_cast<double>(sum / vec.size());
     }
 
+    // Sample standard deviation, i.e., normalized by vec.size() - 1.
+    template<typename T>
+    inline double standardDeviation(const std::vector<T>& vec) {
+        if (vec.size() < 2) return 0;
+        const double average = mean(vec);
+        long double sum = 0;
+        for (const T& element : vec) {
+            sum += (element - average) * (element - average);
+        }
+        return std::sqrt(static_cast<double>(sum / (vec.size() - 1)));
+    }
+
     template<typename T, typename EVALUATE>
     inline double percentile(const std::vector<T>& sortedData, const double p, const EVALUATE& evaluate) noexcept {
         Assert(!sortedData.empty(), "Percentile is not defined for empty data sets!");
@@ -0,0 +1,147 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "Assert.h"
+#include "MultiThreading.h"
+
+/**
+ * Fork-join task pool for recursive divide-and-conquer algorithms.
+ * Every worker owns a deque: it pushes and pops its own tasks at the back (depth-first, cache friendly) and, once
+ * it runs dry, steals from the front of the other deques, where the oldest and therefore largest tasks are.
+ * Tasks may spawn further tasks; wait() returns once all of them have finished.
+ * If a ThreadScheduler is given, worker i is pinned according to thread ID i of the scheduler.
+ * With a single thread no workers are started and spawn() executes the task immediately.
+ */
+class WorkStealingPool {
+public:
+    using Task = std::function<void()>;
+
+    WorkStealingPool(const size_t numThreads, ThreadScheduler* scheduler = nullptr) :
+        queues(numThreads > 1 ? numThreads : 0) {
+        Assert(!scheduler || scheduler->numThreadsUsed() >= numThreads, "Thread scheduler only knows " << scheduler->numThreadsUsed() << " threads, but " << numThreads << " were requested!");
+        for (size_t i = 0; i < queues.size(); i++) {
+            workers.emplace_back([this, i, scheduler]() {
+                if (scheduler) scheduler->pinThread(i);
+                work(i);
+            });
+        }
+    }
+
+    ~WorkStealingPool() {
+        {
+            std::lock_guard<std::mutex> lock(idleMutex);
+            stop = true;
+        }
+        idleCondition.notify_all();
+        for (std::thread& worker : workers) {
+            worker.join();
+        }
+    }
+
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    inline size_t numThreads() const noexcept {
+        return std::max<size_t>(queues.size(), 1);
+    }
+
+    // Index of the calling worker, or 0 if the caller is not a worker of this pool.
+    inline size_t threadId() const noexcept {
+        return (currentPool == this) ? currentWorker : 0;
+    }
+
+    inline void spawn(Task task) noexcept {
+        if (queues.empty()) {
+            task();
+            return;
+        }
+        pendingTasks++;
+        const size_t queue = (currentPool == this) ? currentWorker : (nextExternalQueue++ % queues.size());
+        {
+            std::lock_guard<std::mutex> lock(queues[queue].mutex);
+            queues[queue].tasks.emplace_back(std::move(task));
+        }
+        {
+            std::lock_guard<std::mutex> lock(idleMutex);
+            queuedTasks++;
+        }
+        idleCondition.notify_one();
+    }
+
+    inline void wait() noexcept {
+        Assert(currentPool != this, "wait() must not be called from within a task!");
+        std::unique_lock<std::mutex> lock(idleMutex);
+        doneCondition.wait(lock, [&]() { return pendingTasks == 0; });
+    }
+
+private:
+    struct alignas(64) TaskQueue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    inline void work(const size_t id) noexcept {
+        currentPool = this;
+        currentWorker = id;
+        Task task;
+        while (true) {
+            if (popOwn(id, task) || steal(id, task)) {
+                task();
+                task = nullptr;
+                if (--pendingTasks == 0) {
+                    std::lock_guard<std::mutex> lock(idleMutex);
+                    doneCondition.notify_all();
+                }
+                continue;
+            }
+            std::unique_lock<std::mutex> lock(idleMutex);
+            idleCondition.wait(lock, [&]() { return stop || queuedTasks > 0; });
+            if (stop && queuedTasks == 0) return;
+        }
+    }
+
+    inline bool popOwn(const size_t id, Task& task) noexcept {
+        std::lock_guard<std::mutex> lock(queues[id].mutex);
+        if (queues[id].tasks.empty()) return false;
+        task = std::move(queues[id].tasks.back());
+        queues[id].tasks.pop_back();
+        queuedTasks--;
+        return true;
+    }
+
+    inline bool steal(const size_t id, Task& task) noexcept {
+        for (size_t i = 1; i < queues.size(); i++) {
+            TaskQueue& victim = queues[(id + i) % queues.size()];
+            std::lock_guard<std::mutex> lock(victim.mutex);
+            if (victim.tasks.empty()) continue;
+            task = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+            queuedTasks--;
+            return true;
+        }
+        return false;
+    }
+
+private:
+    std::vector<TaskQueue> queues;
+    std::vector<std::thread> workers;
+
+    std::atomic<size_t> pendingTasks{0};
+    std::atomic<size_t> queuedTasks{0};
+    std::atomic<size_t> nextExternalQueue{0};
+
+    std::mutex idleMutex;
+    std::condition_variable idleCondition;
+    std::condition_variable doneCondition;
+    bool stop = false;
+
+    inline static thread_local const WorkStealingPool* currentPool = nullptr;
+    inline static thread_local size_t currentWorker = 0;
+};
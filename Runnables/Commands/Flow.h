@@ -3,6 +3,7 @@
 #include <iostream>
 #include <vector>
 #include <string>
+#include <span>
 
 #include "../../Shell/Shell.h"
 
@@ -265,7 +266,7 @@ private:
 };
 
 
-inline void compareSinkComponents(const double breakpoint, const std::vector<Vertex>& a, const std::vector<Vertex>& b, const size_t n) noexcept {
+inline void compareSinkComponents(const double breakpoint, const std::span<const Vertex> a, const std::span<const Vertex> b, const size_t n) noexcept {
     bool header = false;
     std::vector<bool> inA(n, false);
     std::vector<bool> inB(n, false);
@@ -359,6 +360,7 @@ public:
         addParameter("Instance file");
         addParameter("Precision");
         addParameter("Flow algorithm", {"Push-Relabel", "IBFS"});
+        addParameter("Number of threads", "1");
     }
 
     using ChordSchemeWrapper = ChordSchemeMaxFlowWrapper<pmf::linearFlowFunction>;
@@ -377,7 +379,7 @@ private:
         ParametricInstance instance(getParameter("Instance file"));
         const int exponent = getParameter<int>("Precision");
         const double precision = (exponent < 0) ? 0 : std::pow(10, -exponent);
-        ChordScheme<pmf::linearFlowFunction, SEARCH_ALGORITHM, true> chordScheme(instance, precision);
+        ChordScheme<pmf::linearFlowFunction, SEARCH_ALGORITHM, true> chordScheme(instance, precision, getParameter<size_t>("Number of threads"));
         Timer timer;
         chordScheme.run();
         std::cout << "Time: " << String::musToString(timer.elapsedMicroseconds()) << std::endl;
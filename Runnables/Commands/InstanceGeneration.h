@@ -0,0 +1,126 @@
+#pragma once
+
+#include <string>
+
+#include <omp.h>
+
+#include "../../Shell/Shell.h"
+
+#include "../../Helpers/String/String.h"
+#include "../../Helpers/Timer.h"
+
+#include "../../DataStructures/Graph/Graph.h"
+#include "../../DataStructures/MaxFlowMinCut/InstanceGenerator.h"
+
+using namespace Shell;
+
+// Common parameters of the generator commands, which come after the family-specific ones.
+class GenerateParametricInstance : public ParameterizedCommand {
+
+public:
+    GenerateParametricInstance(BasicShell& shell, const std::string& name, const std::string& description) :
+        ParameterizedCommand(shell, name, description) {
+    }
+
+protected:
+    inline void addGeneratorParameters() noexcept {
+        addParameter("Seed", "42");
+        addParameter("Capacity distribution", "uniform", {"uniform", "exponential"});
+        addParameter("Min capacity", "1");
+        addParameter("Max capacity", "100");
+        addParameter("Parametric fraction", "1");
+        addParameter("Number of threads", "0");
+    }
+
+    inline pmf::InstanceGenerator::Parameters getGeneratorParameters() const noexcept {
+        const int numThreads = getParameter<int>("Number of threads");
+        if (numThreads > 0) omp_set_num_threads(numThreads);
+        pmf::InstanceGenerator::Parameters parameters;
+        parameters.seed = getParameter<uint64_t>("Seed");
+        parameters.distribution = (getParameter("Capacity distribution") == "exponential") ? pmf::InstanceGenerator::CapacityDistribution::Exponential : pmf::InstanceGenerator::CapacityDistribution::Uniform;
+        parameters.minCapacity = getParameter<double>("Min capacity");
+        parameters.maxCapacity = getParameter<double>("Max capacity");
+        parameters.parametricFraction = getParameter<double>("Parametric fraction");
+        return parameters;
+    }
+
+    inline void write(const pmf::InstanceGenerator::InstanceType& instance, const Timer& timer) const noexcept {
+        std::cout << "Generated instance in " << String::msToString(timer.elapsedMilliseconds()) << std::endl;
+        Graph::printInfo(instance.graph);
+        instance.serialize(getParameter("Output file"));
+    }
+};
+
+class GenerateGridInstance : public GenerateParametricInstance {
+
+public:
+    GenerateGridInstance(BasicShell& shell) :
+        GenerateParametricInstance(shell, "generateGridInstance", "Generates a parametric image segmentation instance on a 2D (depth 1) or 3D grid.") {
+        addParameter("Output file");
+        addParameter("Width");
+        addParameter("Height");
+        addParameter("Depth", "1");
+        addGeneratorParameters();
+    }
+
+    virtual void execute() noexcept {
+        const pmf::InstanceGenerator::Parameters parameters = getGeneratorParameters();
+        Timer timer;
+        write(pmf::InstanceGenerator::grid(parameters, getParameter<size_t>("Width"), getParameter<size_t>("Height"), getParameter<size_t>("Depth")), timer);
+    }
+};
+
+class GenerateGeometricInstance : public GenerateParametricInstance {
+
+public:
+    GenerateGeometricInstance(BasicShell& shell) :
+        GenerateParametricInstance(shell, "generateGeometricInstance", "Generates a parametric instance on a random geometric graph in the unit square.") {
+        addParameter("Output file");
+        addParameter("Number of points");
+        addParameter("Average degree", "8");
+        addGeneratorParameters();
+    }
+
+    virtual void execute() noexcept {
+        const pmf::InstanceGenerator::Parameters parameters = getGeneratorParameters();
+        Timer timer;
+        write(pmf::InstanceGenerator::geometric(parameters, getParameter<size_t>("Number of points"), getParameter<double>("Average degree")), timer);
+    }
+};
+
+class GenerateProjectSelectionInstance : public GenerateParametricInstance {
+
+public:
+    GenerateProjectSelectionInstance(BasicShell& shell) :
+        GenerateParametricInstance(shell, "generateProjectSelectionInstance", "Generates a parametric bipartite project selection instance.") {
+        addParameter("Output file");
+        addParameter("Number of projects");
+        addParameter("Number of tools");
+        addParameter("Tools per project", "4");
+        addGeneratorParameters();
+    }
+
+    virtual void execute() noexcept {
+        const pmf::InstanceGenerator::Parameters parameters = getGeneratorParameters();
+        Timer timer;
+        write(pmf::InstanceGenerator::projectSelection(parameters, getParameter<size_t>("Number of projects"), getParameter<size_t>("Number of tools"), getParameter<size_t>("Tools per project")), timer);
+    }
+};
+
+class GenerateDensestSubgraphInstance : public GenerateParametricInstance {
+
+public:
+    GenerateDensestSubgraphInstance(BasicShell& shell) :
+        GenerateParametricInstance(shell, "generateDensestSubgraphInstance", "Generates a parametric densest subgraph instance on a random graph.") {
+        addParameter("Output file");
+        addParameter("Number of vertices");
+        addParameter("Number of edges");
+        addGeneratorParameters();
+    }
+
+    virtual void execute() noexcept {
+        const pmf::InstanceGenerator::Parameters parameters = getGeneratorParameters();
+        Timer timer;
+        write(pmf::InstanceGenerator::densestSubgraph(parameters, getParameter<size_t>("Number of vertices"), getParameter<size_t>("Number of edges")), timer);
+    }
+};
@@ -3,6 +3,7 @@
 #include "../Helpers/Console/CommandLineParser.h"
 #include "../Shell/Shell.h"
 #include "Commands/Flow.h"
+#include "Commands/InstanceGeneration.h"
 
 using namespace Shell;
 
@@ -23,6 +24,10 @@ int main(int argc, char** argv) {
     new RunChordScheme(shell);
     new TestChordScheme(shell);
     new PrecisionExperiment(shell);
+    new GenerateGridInstance(shell);
+    new GenerateGeometricInstance(shell);
+    new GenerateProjectSelectionInstance(shell);
+    new GenerateDensestSubgraphInstance(shell);
     shell.run();
     return 0;
 }
@@ -1,35 +1,66 @@
 #include <iostream>
 #include <fstream>
 #include <sstream>
+#include <map>
+#include <vector>
+#include <algorithm>
+
+#include <omp.h>
 
 #include "../Helpers/Console/CommandLineParser.h"
+#include "../Helpers/FileSystem/FileSystem.h"
+#include "../Helpers/String/String.h"
+#include "../Helpers/Vector/Vector.h"
 
 #include "../Algorithms/MaxFlowMinCut/ExcessesIBFS.h"
 #include "../Algorithms/MaxFlowMinCut/IBFS.h"
+#include "../Algorithms/MaxFlowMinCut/ParallelPushRelabel.h"
 #include "../Algorithms/MaxFlowMinCut/ParametricIBFS.h"
+#include "../Algorithms/MaxFlowMinCut/ParametricPseudoflow.h"
+#include "../Algorithms/MaxFlowMinCut/DivideAndConquerPushRelabel.h"
+#include "../Algorithms/MaxFlowMinCut/Pseudoflow.h"
 #include "../Algorithms/MaxFlowMinCut/PushRelabel.h"
 #include "../Algorithms/MaxFlowMinCut/RestartableIBFS.h"
 #include "../Algorithms/MaxFlowMinCut/ChordScheme.h"
 #include "../Algorithms/MaxFlowMinCut/ChordSchemeNoContraction.h"
+#include "../Algorithms/MaxFlowMinCut/DecomposedParametricIBFS.h"
 
 using FlowEdgeList = ParametricFlowGraphEdgeList<pmf::linearFlowFunction>;
 using FlowGraph = ParametricFlowGraph<pmf::linearFlowFunction>;
 using ParametricInstance = ParametricMaxFlowInstance<pmf::linearFlowFunction>;
 using ParametricWrapper = RestartableMaxFlowWrapper<pmf::linearFlowFunction>;
 
-/**
- * Runs one benchmark and returns the results as a csv line
- * @param instance The instance file
- * @param algorithm the name of the algorithm
- * @param mode the mode in which the algorithm is to be executed
- * @return
- */
-std::string runExperiment(std::string instance, std::string algorithm, std::string mode, double epsilon) {
-    ParametricInstance graph;
+// Sets the number of OpenMP threads for the lifetime of the object and restores the previous number afterwards, so
+// that later runs in the same process are not affected.
+class OpenMPThreadsGuard {
+public:
+    explicit OpenMPThreadsGuard(const size_t numThreads) :
+        previousNumThreads(omp_get_max_threads()) {
+        omp_set_num_threads(numThreads);
+    }
+
+    ~OpenMPThreadsGuard() {
+        omp_set_num_threads(previousNumThreads);
+    }
 
+private:
+    const int previousNumThreads;
+};
+
+std::string epsilonToString(double epsilon) {
     std::stringstream epsilonHelper;
     epsilonHelper << epsilon;
-    std::string epsilonPrecise = epsilonHelper.str();
+    return epsilonHelper.str();
+}
+
+/**
+ * Loads an instance, either from a binary file or, if none exists, from the corresponding DIMACS file
+ * @param instance The instance file
+ * @param graph the instance that is loaded
+ * @return the load time in microseconds
+ */
+double loadInstance(const std::string& instance, ParametricInstance& graph) {
+    Timer timer;
 
     // Check if file exists as a binary or if we need to read in the .max file
     std::ifstream file(instance);
@@ -42,262 +73,543 @@ std::string runExperiment(std::string instance, std::string algorithm, std::stri
 
     file.close();
 
+    return timer.elapsedMicroseconds();
+}
+
+/**
+ * Runs an algorithm on an already loaded instance and measures the time over the whole run
+ * @param graph the instance
+ * @param algorithm the name of the algorithm
+ * @param epsilon the precision used by the chord scheme, or the merge tolerance of parametricIBFS[MergeTolerance]
+ * @param numThreads the number of threads used by the chord scheme, parametricIBFS[ParallelDrain], parametricIBFS[Decomposed] and the parallel push-relabel variants
+ * @param numBreakpoints is set to the number of breakpoints found
+ * @return the runtime in microseconds
+ */
+double runWhole(const ParametricInstance& graph, const std::string& algorithm, double epsilon, size_t numThreads, uint& numBreakpoints) {
     double runtime;
-    uint numBreakpoints;
 
     if (algorithm == "parametricIBFS") {
-        if (mode == "whole") {
-            Timer timer;
-            ParametricIBFS<pmf::linearFlowFunction, false> algo(graph);
-            algo.run();
-            runtime = timer.elapsedMicroseconds();
-            numBreakpoints = algo.getBreakpoints().size();
-        } else if (mode == "specific") {
-            Timer timer;
-            ParametricIBFS<pmf::linearFlowFunction, true> algo(graph);
-            algo.run();
-            runtime = timer.elapsedMicroseconds();
-            numBreakpoints = algo.getBreakpoints().size();
-            return algorithm + "," + instance + "," + std::to_string(graph.graph.numVertices()) + "," +
-                   std::to_string(graph.graph.numEdges()) + "," +
-                   std::to_string(numBreakpoints) + "," + std::to_string(runtime) + "," +
-                   std::to_string(algo.getNumIterations()) + "," +
-                   std::to_string(algo.getNumBottlenecks()) + "," +
-                   std::to_string(algo.getNumAdoptions()) + "," +
-                   std::to_string(algo.getAvgDistance()) + "," +
-                   std::to_string(algo.getNumDrains()) + "," +
-                   std::to_string(algo.getInitTime()) + "," + std::to_string(algo.getUpdateTime()) + "," +
-                   std::to_string(algo.getReconnectTime()) + "," + std::to_string(algo.getDrainTime()) + "\n";
-        }
-        // TODO add precision benchmark for parametricIBFS
-        else {
-            throw std::runtime_error("No valid mode was selected");
-        }
+        Timer timer;
+        ParametricIBFS<pmf::linearFlowFunction, false> algo(graph);
+        algo.run();
+        runtime = timer.elapsedMicroseconds();
+        numBreakpoints = algo.getBreakpoints().size();
+    } else if (algorithm == "parametricIBFS[RadixHeap]") {
+        Timer timer;
+        ParametricIBFS<pmf::linearFlowFunction, false, RadixHeapAlphaQueue> algo(graph);
+        algo.run();
+        runtime = timer.elapsedMicroseconds();
+        numBreakpoints = algo.getBreakpoints().size();
+    } else if (algorithm == "parametricIBFS[GlobalRelabel]") {
+        Timer timer;
+        ParametricIBFS<pmf::linearFlowFunction, false, KHeapAlphaQueue, true> algo(graph);
+        algo.run();
+        runtime = timer.elapsedMicroseconds();
+        numBreakpoints = algo.getBreakpoints().size();
+    } else if (algorithm == "parametricIBFS[DynamicTrees]") {
+        Timer timer;
+        ParametricIBFS<pmf::linearFlowFunction, false, KHeapAlphaQueue, false, true> algo(graph);
+        algo.run();
+        runtime = timer.elapsedMicroseconds();
+        numBreakpoints = algo.getBreakpoints().size();
+    } else if (algorithm == "parametricIBFS[MergeTolerance]") {
+        Timer timer;
+        ParametricIBFS<pmf::linearFlowFunction, false> algo(graph, epsilon);
+        algo.run();
+        runtime = timer.elapsedMicroseconds();
+        numBreakpoints = algo.getBreakpoints().size();
+    } else if (algorithm == "parametricIBFS[ParallelDrain]") {
+        Timer timer;
+        ParametricIBFS<pmf::linearFlowFunction, false> algo(graph, 0, numThreads);
+        algo.run();
+        runtime = timer.elapsedMicroseconds();
+        numBreakpoints = algo.getBreakpoints().size();
+    } else if (algorithm == "parametricIBFS[ParallelInitialFlow]") {
+        const OpenMPThreadsGuard threads(numThreads);
+        Timer timer;
+        ParametricIBFS<pmf::linearFlowFunction, false, KHeapAlphaQueue, false, false, ParallelPushRelabel<ParametricWrapper>> algo(graph);
+        algo.run();
+        runtime = timer.elapsedMicroseconds();
+        numBreakpoints = algo.getBreakpoints().size();
+    } else if (algorithm == "parametricIBFS[Decomposed]") {
+        Timer timer;
+        DecomposedParametricIBFS<pmf::linearFlowFunction> algo(graph, numThreads);
+        algo.run();
+        runtime = timer.elapsedMicroseconds();
+        numBreakpoints = algo.getBreakpoints().size();
+    } else if (algorithm == "parametricPseudoflow") {
+        Timer timer;
+        ParametricPseudoflow<pmf::linearFlowFunction> algo(graph);
+        algo.run();
+        runtime = timer.elapsedMicroseconds();
+        numBreakpoints = algo.getBreakpoints().size();
+    } else if (algorithm == "divideAndConquerPushRelabel") {
+        Timer timer;
+        DivideAndConquerPushRelabel<pmf::linearFlowFunction> algo(graph);
+        algo.run();
+        runtime = timer.elapsedMicroseconds();
+        numBreakpoints = algo.getBreakpoints().size();
     } else if (algorithm == "chordScheme[IBFS]") {
-        if (mode == "whole") {
-            Timer timer;
-            ChordScheme<pmf::linearFlowFunction, IBFS<ChordSchemeMaxFlowWrapper<pmf::linearFlowFunction>>, false> algo(
-                    graph, epsilon);
-            algo.run();
-            runtime = timer.elapsedMicroseconds();
-            numBreakpoints = algo.getBreakpoints().size();
-        } else if (mode == "specific") {
-            Timer timer;
-            ChordScheme<pmf::linearFlowFunction, IBFS<ChordSchemeMaxFlowWrapper<pmf::linearFlowFunction>>, true> algo(
-                    graph, epsilon);
-            algo.run();
-            runtime = timer.elapsedMicroseconds();
-            numBreakpoints = algo.getBreakpoints().size();
-            return algorithm + "," + instance + "," + epsilonPrecise + "," +
-                   std::to_string(graph.graph.numVertices()) + "," +
-                   std::to_string(graph.graph.numEdges()) + "," +
-                   std::to_string(numBreakpoints) + "," + std::to_string(runtime) + "," +
-                   std::to_string(algo.getContractionTime()) + "," + std::to_string(algo.getFlowTime()) + "," +
-                   std::to_string(algo.getTotalVertices()) +
-                   "\n";
-        } else {
-            throw std::runtime_error("No valid mode was selected");
-        }
+        Timer timer;
+        ChordScheme<pmf::linearFlowFunction, IBFS<ChordSchemeMaxFlowWrapper<pmf::linearFlowFunction>>, false> algo(
+                graph, epsilon, numThreads);
+        algo.run();
+        runtime = timer.elapsedMicroseconds();
+        numBreakpoints = algo.getBreakpoints().size();
     } else if (algorithm == "chordScheme[PushRelabel]") {
-        if (mode == "whole") {
-            Timer timer;
-            ChordScheme<pmf::linearFlowFunction, PushRelabel<ChordSchemeMaxFlowWrapper<pmf::linearFlowFunction>>, false> algo(
-                    graph, epsilon);
-            algo.run();
-            runtime = timer.elapsedMicroseconds();
-            numBreakpoints = algo.getBreakpoints().size();
-        } else if (mode == "specific") {
-            Timer timer;
-            ChordScheme<pmf::linearFlowFunction, PushRelabel<ChordSchemeMaxFlowWrapper<pmf::linearFlowFunction>>, true> algo(
-                    graph, epsilon);
-            algo.run();
-            runtime = timer.elapsedMicroseconds();
-            numBreakpoints = algo.getBreakpoints().size();
-            return algorithm + "," + instance + "," + epsilonPrecise + "," +
-                   std::to_string(graph.graph.numVertices()) + "," +
-                   std::to_string(graph.graph.numEdges()) + "," +
-                   std::to_string(numBreakpoints) + "," + std::to_string(runtime) + "," +
-                   std::to_string(algo.getContractionTime()) + "," + std::to_string(algo.getFlowTime()) + "," +
-                   std::to_string(algo.getTotalVertices()) +
-                   "\n";
-        } else {
-            throw std::runtime_error("No valid mode was selected");
-        }
+        Timer timer;
+        ChordScheme<pmf::linearFlowFunction, PushRelabel<ChordSchemeMaxFlowWrapper<pmf::linearFlowFunction>>, false> algo(
+                graph, epsilon, numThreads);
+        algo.run();
+        runtime = timer.elapsedMicroseconds();
+        numBreakpoints = algo.getBreakpoints().size();
+    } else if (algorithm == "chordScheme[Pseudoflow]") {
+        Timer timer;
+        ChordScheme<pmf::linearFlowFunction, Pseudoflow<ChordSchemeMaxFlowWrapper<pmf::linearFlowFunction>>, false> algo(
+                graph, epsilon, numThreads);
+        algo.run();
+        runtime = timer.elapsedMicroseconds();
+        numBreakpoints = algo.getBreakpoints().size();
+    } else if (algorithm == "chordScheme[PushRelabelParallelBFS]") {
+        Timer timer;
+        ChordScheme<pmf::linearFlowFunction, PushRelabel<ChordSchemeMaxFlowWrapper<pmf::linearFlowFunction>, false, true>, false> algo(
+                graph, epsilon, 1, nullptr, numThreads);
+        algo.run();
+        runtime = timer.elapsedMicroseconds();
+        numBreakpoints = algo.getBreakpoints().size();
+    } else if (algorithm == "chordScheme[ParallelPushRelabel]") {
+        // The threads are used by the search algorithm, so the chord scheme itself runs sequentially.
+        Timer timer;
+        ChordScheme<pmf::linearFlowFunction, ParallelPushRelabel<ChordSchemeMaxFlowWrapper<pmf::linearFlowFunction>>, false> algo(
+                graph, epsilon, 1, nullptr, numThreads);
+        algo.run();
+        runtime = timer.elapsedMicroseconds();
+        numBreakpoints = algo.getBreakpoints().size();
     } else if (algorithm == "chordScheme[EIBFS]") {
-        if (mode == "whole") {
-            Timer timer;
-            ChordScheme<pmf::linearFlowFunction, ExcessesIBFS<ChordSchemeMaxFlowWrapper<pmf::linearFlowFunction>>, false> algo(
-                    graph, epsilon);
-            algo.run();
-            runtime = timer.elapsedMicroseconds();
-            numBreakpoints = algo.getBreakpoints().size();
-        } else if (mode == "specific") {
-            Timer timer;
-            ChordScheme<pmf::linearFlowFunction, ExcessesIBFS<ChordSchemeMaxFlowWrapper<pmf::linearFlowFunction>>, true> algo(
-                    graph, epsilon);
-            algo.run();
-            runtime = timer.elapsedMicroseconds();
-            numBreakpoints = algo.getBreakpoints().size();
-            return algorithm + "," + instance + "," + epsilonPrecise + "," +
-                   std::to_string(graph.graph.numVertices()) + "," +
-                   std::to_string(graph.graph.numEdges()) + "," +
-                   std::to_string(numBreakpoints) + "," + std::to_string(runtime) + "," +
-                   std::to_string(algo.getContractionTime()) + "," + std::to_string(algo.getFlowTime()) + "," +
-                   std::to_string(algo.getTotalVertices()) +
-                   "\n";
-        } else {
-            throw std::runtime_error("No valid mode was selected");
-        }
-    } else if (algorithm == "chordScheme[PushRelabel]") {
-        if (mode == "whole") {
-            Timer timer;
-            ChordScheme<pmf::linearFlowFunction, PushRelabel<ChordSchemeMaxFlowWrapper<pmf::linearFlowFunction>>, false> algo(
-                    graph, epsilon);
-            algo.run();
-            runtime = timer.elapsedMicroseconds();
-            numBreakpoints = algo.getBreakpoints().size();
-        } else if (mode == "specific") {
-            Timer timer;
-            ChordScheme<pmf::linearFlowFunction, PushRelabel<ChordSchemeMaxFlowWrapper<pmf::linearFlowFunction>>, true> algo(
-                    graph, epsilon);
-            algo.run();
-            runtime = timer.elapsedMicroseconds();
-            numBreakpoints = algo.getBreakpoints().size();
-            return algorithm + "," + instance + "," + epsilonPrecise + "," +
-                   std::to_string(graph.graph.numVertices()) + "," +
-                   std::to_string(graph.graph.numEdges()) + "," +
-                   std::to_string(numBreakpoints) + "," + std::to_string(runtime) + "," +
-                   std::to_string(algo.getContractionTime()) + "," + std::to_string(algo.getFlowTime()) + "," +
-                   std::to_string(algo.getTotalVertices()) +
-                   "\n";
-        } else {
-            throw std::runtime_error("No valid mode was selected");
-        }
+        Timer timer;
+        ChordScheme<pmf::linearFlowFunction, ExcessesIBFS<ChordSchemeMaxFlowWrapper<pmf::linearFlowFunction>>, false> algo(
+                graph, epsilon, numThreads);
+        algo.run();
+        runtime = timer.elapsedMicroseconds();
+        numBreakpoints = algo.getBreakpoints().size();
     } else if (algorithm == "chordSchemeNoContraction[EIBFS]") {
-        if (mode == "whole") {
-            Timer timer;
-            ChordSchemeNoContraction<pmf::linearFlowFunction, ExcessesIBFS<ChordSchemeMaxFlowWrapper<pmf::linearFlowFunction>>> algo(
-                    graph, epsilon);
-            algo.run();
-            runtime = timer.elapsedMicroseconds();
-            numBreakpoints = algo.getBreakpoints().size();
-        } else {
-            throw std::runtime_error("No valid mode was selected");
-        }
+        Timer timer;
+        ChordSchemeNoContraction<pmf::linearFlowFunction, ExcessesIBFS<ChordSchemeMaxFlowWrapper<pmf::linearFlowFunction>>> algo(
+                graph, epsilon);
+        algo.run();
+        runtime = timer.elapsedMicroseconds();
+        numBreakpoints = algo.getBreakpoints().size();
     } else if (algorithm == "chordSchemeNoContraction[IBFS]") {
-        if (mode == "whole") {
-            Timer timer;
-            ChordSchemeNoContraction<pmf::linearFlowFunction, IBFS<ChordSchemeMaxFlowWrapper<pmf::linearFlowFunction>>> algo(
-                    graph, epsilon);
-            algo.run();
-            runtime = timer.elapsedMicroseconds();
-            numBreakpoints = algo.getBreakpoints().size();
-        } else {
-            throw std::runtime_error("No valid mode was selected");
-        }
+        Timer timer;
+        ChordSchemeNoContraction<pmf::linearFlowFunction, IBFS<ChordSchemeMaxFlowWrapper<pmf::linearFlowFunction>>> algo(
+                graph, epsilon);
+        algo.run();
+        runtime = timer.elapsedMicroseconds();
+        numBreakpoints = algo.getBreakpoints().size();
     } else if (algorithm == "chordSchemeNoContraction[PushRelabel]") {
-        if (mode == "whole") {
-            Timer timer;
-            ChordSchemeNoContraction<pmf::linearFlowFunction, PushRelabel<ChordSchemeMaxFlowWrapper<pmf::linearFlowFunction>>> algo(
-                    graph, epsilon);
-            algo.run();
-            runtime = timer.elapsedMicroseconds();
-            numBreakpoints = algo.getBreakpoints().size();
-        } else {
-            throw std::runtime_error("No valid mode was selected");
-        }
+        Timer timer;
+        ChordSchemeNoContraction<pmf::linearFlowFunction, PushRelabel<ChordSchemeMaxFlowWrapper<pmf::linearFlowFunction>>> algo(
+                graph, epsilon);
+        algo.run();
+        runtime = timer.elapsedMicroseconds();
+        numBreakpoints = algo.getBreakpoints().size();
     } else if (algorithm == "restartableIBFS") {
-        if (mode == "whole") {
-            ParametricIBFS<pmf::linearFlowFunction, false> breakpointGetter(graph);
-            breakpointGetter.run();
-            numBreakpoints = breakpointGetter.getBreakpoints().size();
-
-            Timer timer;
-            ParametricWrapper wrapper(graph);
-            RestartableIBFS<ParametricWrapper, false> algo(wrapper);
-            algo.run();
-
-            for (uint i = 1; i < breakpointGetter.getBreakpoints().size(); i++) {
-                wrapper.setAlpha(breakpointGetter.getBreakpoints()[i]);
-                algo.continueAfterUpdate();
-            }
+        ParametricIBFS<pmf::linearFlowFunction, false> breakpointGetter(graph);
+        breakpointGetter.run();
+        numBreakpoints = breakpointGetter.getBreakpoints().size();
 
-            runtime = timer.elapsedMicroseconds();
-        } else if (mode == "specific") {
-            ParametricIBFS<pmf::linearFlowFunction, false> breakpointGetter(graph);
-            breakpointGetter.run();
-            numBreakpoints = breakpointGetter.getBreakpoints().size();
+        Timer timer;
+        ParametricWrapper wrapper(graph);
+        RestartableIBFS<ParametricWrapper, false> algo(wrapper);
+        algo.run();
 
-            Timer timer;
-            ParametricWrapper wrapper(graph);
-            RestartableIBFS<ParametricWrapper, true> algo(wrapper);
-            algo.run();
+        for (uint i = 1; i < breakpointGetter.getBreakpoints().size(); i++) {
+            wrapper.setAlpha(breakpointGetter.getBreakpoints()[i]);
+            algo.continueAfterUpdate();
+        }
 
-            for (uint i = 1; i < breakpointGetter.getBreakpoints().size(); i++) {
-                wrapper.setAlpha(breakpointGetter.getBreakpoints()[i]);
-                algo.continueAfterUpdate();
-            }
+        runtime = timer.elapsedMicroseconds();
+    } else if (algorithm == "restartablePushRelabel") {
+        ParametricIBFS<pmf::linearFlowFunction, false> breakpointGetter(graph);
+        breakpointGetter.run();
+        numBreakpoints = breakpointGetter.getBreakpoints().size();
 
-            runtime = timer.elapsedMicroseconds();
+        Timer timer;
+        ParametricWrapper wrapper(graph);
+        PushRelabel<ParametricWrapper, false> algo(wrapper);
+        algo.run();
 
-            return algorithm + "," + instance + "," + epsilonPrecise + "," +
-                   std::to_string(graph.graph.numVertices()) + "," +
-                   std::to_string(graph.graph.numEdges()) + "," +
-                   std::to_string(numBreakpoints) + "," + std::to_string(runtime) + "," +
-                   std::to_string(algo.getUpdateTime()) + "," + std::to_string(algo.getFlowTime()) + "\n";
-        } else {
-            throw std::runtime_error("No valid mode was selected");
+        for (uint i = 1; i < breakpointGetter.getBreakpoints().size(); i++) {
+            wrapper.setAlpha(breakpointGetter.getBreakpoints()[i]);
+            algo.continueAfterUpdate();
         }
-    } else if (algorithm == "restartablePushRelabel") {
-        if (mode == "whole") {
-            ParametricIBFS<pmf::linearFlowFunction, false> breakpointGetter(graph);
-            breakpointGetter.run();
-            numBreakpoints = breakpointGetter.getBreakpoints().size();
-
-            Timer timer;
-            ParametricWrapper wrapper(graph);
-            PushRelabel<ParametricWrapper, false> algo(wrapper);
-            algo.run();
-
-            for (uint i = 1; i < breakpointGetter.getBreakpoints().size(); i++) {
-                wrapper.setAlpha(breakpointGetter.getBreakpoints()[i]);
-                algo.continueAfterUpdate();
-            }
 
-            runtime = timer.elapsedMicroseconds();
-        } else if (mode == "specific") {
-            ParametricIBFS<pmf::linearFlowFunction, false> breakpointGetter(graph);
-            breakpointGetter.run();
-            numBreakpoints = breakpointGetter.getBreakpoints().size();
+        runtime = timer.elapsedMicroseconds();
+    } else {
+        throw std::runtime_error("No valid algorithm was selected");
+    }
 
-            Timer timer;
-            ParametricWrapper wrapper(graph);
-            PushRelabel<ParametricWrapper, true> algo(wrapper);
-            algo.run();
+    return runtime;
+}
 
-            for (uint i = 1; i < breakpointGetter.getBreakpoints().size(); i++) {
-                wrapper.setAlpha(breakpointGetter.getBreakpoints()[i]);
-                algo.continueAfterUpdate();
-            }
+/**
+ * Runs one benchmark and returns the results as a csv line
+ * @param instance The instance file
+ * @param algorithm the name of the algorithm
+ * @param mode the mode in which the algorithm is to be executed
+ * @param numThreads the number of threads used by the chord scheme, parametricIBFS[ParallelDrain], parametricIBFS[Decomposed] and the parallel push-relabel variants
+ * @return
+ */
+std::string runExperiment(std::string instance, std::string algorithm, std::string mode, double epsilon, size_t numThreads) {
+    ParametricInstance graph;
+    loadInstance(instance, graph);
+
+    std::string epsilonPrecise = epsilonToString(epsilon);
+
+    double runtime;
+    uint numBreakpoints;
+
+    if (mode == "whole") {
+        runtime = runWhole(graph, algorithm, epsilon, numThreads, numBreakpoints);
+        return algorithm + "," + instance + "," + epsilonPrecise + "," + std::to_string(graph.graph.numVertices()) + "," +
+               std::to_string(graph.graph.numEdges()) + "," + epsilonPrecise + "," +
+               std::to_string(numBreakpoints) + "," + std::to_string(runtime) + "\n";
+    } else if (mode != "specific") {
+        throw std::runtime_error("No valid mode was selected");
+    }
+
+    if (algorithm == "parametricIBFS") {
+        Timer timer;
+        ParametricIBFS<pmf::linearFlowFunction, true> algo(graph);
+        algo.run();
+        runtime = timer.elapsedMicroseconds();
+        numBreakpoints = algo.getBreakpoints().size();
+        return algorithm + "," + instance + "," + std::to_string(graph.graph.numVertices()) + "," +
+               std::to_string(graph.graph.numEdges()) + "," +
+               std::to_string(numBreakpoints) + "," + std::to_string(runtime) + "," +
+               std::to_string(algo.getNumIterations()) + "," +
+               std::to_string(algo.getNumBottlenecks()) + "," +
+               std::to_string(algo.getNumAdoptions()) + "," +
+               std::to_string(algo.getAvgDistance()) + "," +
+               std::to_string(algo.getNumDrains()) + "," +
+               std::to_string(algo.getInitTime()) + "," + std::to_string(algo.getUpdateTime()) + "," +
+               std::to_string(algo.getReconnectTime()) + "," + std::to_string(algo.getDrainTime()) + "\n";
+    } else if (algorithm == "parametricIBFS[GlobalRelabel]") {
+        Timer timer;
+        ParametricIBFS<pmf::linearFlowFunction, true, KHeapAlphaQueue, true> algo(graph);
+        algo.run();
+        runtime = timer.elapsedMicroseconds();
+        numBreakpoints = algo.getBreakpoints().size();
+        return algorithm + "," + instance + "," + std::to_string(graph.graph.numVertices()) + "," +
+               std::to_string(graph.graph.numEdges()) + "," +
+               std::to_string(numBreakpoints) + "," + std::to_string(runtime) + "," +
+               std::to_string(algo.getNumIterations()) + "," +
+               std::to_string(algo.getNumBottlenecks()) + "," +
+               std::to_string(algo.getNumAdoptions()) + "," +
+               std::to_string(algo.getAvgDistance()) + "," +
+               std::to_string(algo.getNumDrains()) + "," +
+               std::to_string(algo.getInitTime()) + "," + std::to_string(algo.getUpdateTime()) + "," +
+               std::to_string(algo.getReconnectTime()) + "," + std::to_string(algo.getDrainTime()) + "," +
+               std::to_string(algo.getNumGlobalRelabels()) + "," + std::to_string(algo.getRelabelTime()) + "\n";
+    } else if (algorithm == "parametricIBFS[DynamicTrees]") {
+        Timer timer;
+        ParametricIBFS<pmf::linearFlowFunction, true, KHeapAlphaQueue, false, true> algo(graph);
+        algo.run();
+        runtime = timer.elapsedMicroseconds();
+        numBreakpoints = algo.getBreakpoints().size();
+        return algorithm + "," + instance + "," + std::to_string(graph.graph.numVertices()) + "," +
+               std::to_string(graph.graph.numEdges()) + "," +
+               std::to_string(numBreakpoints) + "," + std::to_string(runtime) + "," +
+               std::to_string(algo.getNumIterations()) + "," +
+               std::to_string(algo.getNumBottlenecks()) + "," +
+               std::to_string(algo.getNumAdoptions()) + "," +
+               std::to_string(algo.getAvgDistance()) + "," +
+               std::to_string(algo.getNumDrains()) + "," +
+               std::to_string(algo.getInitTime()) + "," + std::to_string(algo.getUpdateTime()) + "," +
+               std::to_string(algo.getReconnectTime()) + "," + std::to_string(algo.getDrainTime()) + "\n";
+    } else if (algorithm == "parametricIBFS[MergeTolerance]") {
+        Timer timer;
+        ParametricIBFS<pmf::linearFlowFunction, true> algo(graph, epsilon);
+        algo.run();
+        runtime = timer.elapsedMicroseconds();
+        numBreakpoints = algo.getBreakpoints().size();
+        return algorithm + "," + instance + "," + epsilonPrecise + "," +
+               std::to_string(graph.graph.numVertices()) + "," +
+               std::to_string(graph.graph.numEdges()) + "," +
+               std::to_string(numBreakpoints) + "," + std::to_string(runtime) + "," +
+               std::to_string(algo.getNumIterations()) + "," +
+               std::to_string(algo.getNumBottlenecks()) + "," +
+               std::to_string(algo.getNumAdoptions()) + "," +
+               std::to_string(algo.getAvgDistance()) + "," +
+               std::to_string(algo.getNumDrains()) + "," +
+               std::to_string(algo.getInitTime()) + "," + std::to_string(algo.getUpdateTime()) + "," +
+               std::to_string(algo.getReconnectTime()) + "," + std::to_string(algo.getDrainTime()) + "\n";
+    } else if (algorithm == "parametricIBFS[ParallelDrain]") {
+        Timer timer;
+        ParametricIBFS<pmf::linearFlowFunction, true> algo(graph, 0, numThreads);
+        algo.run();
+        runtime = timer.elapsedMicroseconds();
+        numBreakpoints = algo.getBreakpoints().size();
+        return algorithm + "," + instance + "," + std::to_string(graph.graph.numVertices()) + "," +
+               std::to_string(graph.graph.numEdges()) + "," +
+               std::to_string(numBreakpoints) + "," + std::to_string(runtime) + "," +
+               std::to_string(algo.getNumIterations()) + "," +
+               std::to_string(algo.getNumBottlenecks()) + "," +
+               std::to_string(algo.getNumAdoptions()) + "," +
+               std::to_string(algo.getAvgDistance()) + "," +
+               std::to_string(algo.getNumDrains()) + "," +
+               std::to_string(algo.getInitTime()) + "," + std::to_string(algo.getUpdateTime()) + "," +
+               std::to_string(algo.getReconnectTime()) + "," + std::to_string(algo.getDrainTime()) + "\n";
+    } else if (algorithm == "parametricIBFS[ParallelInitialFlow]") {
+        const OpenMPThreadsGuard threads(numThreads);
+        Timer timer;
+        ParametricIBFS<pmf::linearFlowFunction, true, KHeapAlphaQueue, false, false, ParallelPushRelabel<ParametricWrapper>> algo(graph);
+        algo.run();
+        runtime = timer.elapsedMicroseconds();
+        numBreakpoints = algo.getBreakpoints().size();
+        return algorithm + "," + instance + "," + std::to_string(graph.graph.numVertices()) + "," +
+               std::to_string(graph.graph.numEdges()) + "," +
+               std::to_string(numBreakpoints) + "," + std::to_string(runtime) + "," +
+               std::to_string(algo.getNumIterations()) + "," +
+               std::to_string(algo.getNumBottlenecks()) + "," +
+               std::to_string(algo.getNumAdoptions()) + "," +
+               std::to_string(algo.getAvgDistance()) + "," +
+               std::to_string(algo.getNumDrains()) + "," +
+               std::to_string(algo.getInitTime()) + "," + std::to_string(algo.getUpdateTime()) + "," +
+               std::to_string(algo.getReconnectTime()) + "," + std::to_string(algo.getDrainTime()) + "\n";
+    } else if (algorithm == "parametricIBFS[Decomposed]") {
+        Timer timer;
+        DecomposedParametricIBFS<pmf::linearFlowFunction, ParametricIBFS<pmf::linearFlowFunction>, true> algo(graph, numThreads);
+        algo.run();
+        runtime = timer.elapsedMicroseconds();
+        numBreakpoints = algo.getBreakpoints().size();
+        return algorithm + "," + instance + "," + std::to_string(graph.graph.numVertices()) + "," +
+               std::to_string(graph.graph.numEdges()) + "," +
+               std::to_string(numBreakpoints) + "," + std::to_string(runtime) + "," +
+               std::to_string(algo.getDecompositionTime()) + "," + std::to_string(algo.getSolveTime()) + "," +
+               std::to_string(algo.getNumComponents()) + "," + std::to_string(algo.getLargestComponentSize()) + "\n";
+    } else if (algorithm == "parametricPseudoflow") {
+        Timer timer;
+        ParametricPseudoflow<pmf::linearFlowFunction, true> algo(graph);
+        algo.run();
+        runtime = timer.elapsedMicroseconds();
+        numBreakpoints = algo.getBreakpoints().size();
+        return algorithm + "," + instance + "," + std::to_string(graph.graph.numVertices()) + "," +
+               std::to_string(graph.graph.numEdges()) + "," +
+               std::to_string(numBreakpoints) + "," + std::to_string(runtime) + "," +
+               std::to_string(algo.getFlowTime()) + "," + std::to_string(algo.getNumSubproblems()) + "," +
+               std::to_string(algo.getTotalVertices()) + "\n";
+    } else if (algorithm == "divideAndConquerPushRelabel") {
+        Timer timer;
+        DivideAndConquerPushRelabel<pmf::linearFlowFunction, true> algo(graph);
+        algo.run();
+        runtime = timer.elapsedMicroseconds();
+        numBreakpoints = algo.getBreakpoints().size();
+        return algorithm + "," + instance + "," + std::to_string(graph.graph.numVertices()) + "," +
+               std::to_string(graph.graph.numEdges()) + "," +
+               std::to_string(numBreakpoints) + "," + std::to_string(runtime) + "," +
+               std::to_string(algo.getFlowTime()) + "," + std::to_string(algo.getNumSubproblems()) + "," +
+               std::to_string(algo.getNumForwardWins()) + "," + std::to_string(algo.getTotalVertices()) + "\n";
+    } else if (algorithm == "chordScheme[IBFS]") {
+        Timer timer;
+        ChordScheme<pmf::linearFlowFunction, IBFS<ChordSchemeMaxFlowWrapper<pmf::linearFlowFunction>>, true> algo(
+                graph, epsilon, numThreads);
+        algo.run();
+        runtime = timer.elapsedMicroseconds();
+        numBreakpoints = algo.getBreakpoints().size();
+        return algorithm + "," + instance + "," + epsilonPrecise + "," +
+               std::to_string(graph.graph.numVertices()) + "," +
+               std::to_string(graph.graph.numEdges()) + "," +
+               std::to_string(numBreakpoints) + "," + std::to_string(runtime) + "," +
+               std::to_string(algo.getContractionTime()) + "," + std::to_string(algo.getFlowTime()) + "," +
+               std::to_string(algo.getTotalVertices()) +
+               "\n";
+    } else if (algorithm == "chordScheme[PushRelabel]") {
+        Timer timer;
+        ChordScheme<pmf::linearFlowFunction, PushRelabel<ChordSchemeMaxFlowWrapper<pmf::linearFlowFunction>>, true> algo(
+                graph, epsilon, numThreads);
+        algo.run();
+        runtime = timer.elapsedMicroseconds();
+        numBreakpoints = algo.getBreakpoints().size();
+        return algorithm + "," + instance + "," + epsilonPrecise + "," +
+               std::to_string(graph.graph.numVertices()) + "," +
+               std::to_string(graph.graph.numEdges()) + "," +
+               std::to_string(numBreakpoints) + "," + std::to_string(runtime) + "," +
+               std::to_string(algo.getContractionTime()) + "," + std::to_string(algo.getFlowTime()) + "," +
+               std::to_string(algo.getTotalVertices()) +
+               "\n";
+    } else if (algorithm == "chordScheme[Pseudoflow]") {
+        Timer timer;
+        ChordScheme<pmf::linearFlowFunction, Pseudoflow<ChordSchemeMaxFlowWrapper<pmf::linearFlowFunction>>, true> algo(
+                graph, epsilon, numThreads);
+        algo.run();
+        runtime = timer.elapsedMicroseconds();
+        numBreakpoints = algo.getBreakpoints().size();
+        return algorithm + "," + instance + "," + epsilonPrecise + "," +
+               std::to_string(graph.graph.numVertices()) + "," +
+               std::to_string(graph.graph.numEdges()) + "," +
+               std::to_string(numBreakpoints) + "," + std::to_string(runtime) + "," +
+               std::to_string(algo.getContractionTime()) + "," + std::to_string(algo.getFlowTime()) + "," +
+               std::to_string(algo.getTotalVertices()) +
+               "\n";
+    } else if (algorithm == "chordScheme[PushRelabelParallelBFS]") {
+        Timer timer;
+        ChordScheme<pmf::linearFlowFunction, PushRelabel<ChordSchemeMaxFlowWrapper<pmf::linearFlowFunction>, false, true>, true> algo(
+                graph, epsilon, 1, nullptr, numThreads);
+        algo.run();
+        runtime = timer.elapsedMicroseconds();
+        numBreakpoints = algo.getBreakpoints().size();
+        return algorithm + "," + instance + "," + epsilonPrecise + "," +
+               std::to_string(graph.graph.numVertices()) + "," +
+               std::to_string(graph.graph.numEdges()) + "," +
+               std::to_string(numBreakpoints) + "," + std::to_string(runtime) + "," +
+               std::to_string(algo.getContractionTime()) + "," + std::to_string(algo.getFlowTime()) + "," +
+               std::to_string(algo.getTotalVertices()) +
+               "\n";
+    } else if (algorithm == "chordScheme[ParallelPushRelabel]") {
+        Timer timer;
+        ChordScheme<pmf::linearFlowFunction, ParallelPushRelabel<ChordSchemeMaxFlowWrapper<pmf::linearFlowFunction>>, true> algo(
+                graph, epsilon, 1, nullptr, numThreads);
+        algo.run();
+        runtime = timer.elapsedMicroseconds();
+        numBreakpoints = algo.getBreakpoints().size();
+        return algorithm + "," + instance + "," + epsilonPrecise + "," +
+               std::to_string(graph.graph.numVertices()) + "," +
+               std::to_string(graph.graph.numEdges()) + "," +
+               std::to_string(numBreakpoints) + "," + std::to_string(runtime) + "," +
+               std::to_string(algo.getContractionTime()) + "," + std::to_string(algo.getFlowTime()) + "," +
+               std::to_string(algo.getTotalVertices()) +
+               "\n";
+    } else if (algorithm == "chordScheme[EIBFS]") {
+        Timer timer;
+        ChordScheme<pmf::linearFlowFunction, ExcessesIBFS<ChordSchemeMaxFlowWrapper<pmf::linearFlowFunction>>, true> algo(
+                graph, epsilon, numThreads);
+        algo.run();
+        runtime = timer.elapsedMicroseconds();
+        numBreakpoints = algo.getBreakpoints().size();
+        return algorithm + "," + instance + "," + epsilonPrecise + "," +
+               std::to_string(graph.graph.numVertices()) + "," +
+               std::to_string(graph.graph.numEdges()) + "," +
+               std::to_string(numBreakpoints) + "," + std::to_string(runtime) + "," +
+               std::to_string(algo.getContractionTime()) + "," + std::to_string(algo.getFlowTime()) + "," +
+               std::to_string(algo.getTotalVertices()) +
+               "\n";
+    } else if (algorithm == "restartableIBFS") {
+        ParametricIBFS<pmf::linearFlowFunction, false> breakpointGetter(graph);
+        breakpointGetter.run();
+        numBreakpoints = breakpointGetter.getBreakpoints().size();
+
+        Timer timer;
+        ParametricWrapper wrapper(graph);
+        RestartableIBFS<ParametricWrapper, true> algo(wrapper);
+        algo.run();
+
+        for (uint i = 1; i < breakpointGetter.getBreakpoints().size(); i++) {
+            wrapper.setAlpha(breakpointGetter.getBreakpoints()[i]);
+            algo.continueAfterUpdate();
+        }
+
+        runtime = timer.elapsedMicroseconds();
+
+        return algorithm + "," + instance + "," + epsilonPrecise + "," +
+               std::to_string(graph.graph.numVertices()) + "," +
+               std::to_string(graph.graph.numEdges()) + "," +
+               std::to_string(numBreakpoints) + "," + std::to_string(runtime) + "," +
+               std::to_string(algo.getUpdateTime()) + "," + std::to_string(algo.getFlowTime()) + "\n";
+    } else if (algorithm == "restartablePushRelabel") {
+        ParametricIBFS<pmf::linearFlowFunction, false> breakpointGetter(graph);
+        breakpointGetter.run();
+        numBreakpoints = breakpointGetter.getBreakpoints().size();
 
-            runtime = timer.elapsedMicroseconds();
+        Timer timer;
+        ParametricWrapper wrapper(graph);
+        PushRelabel<ParametricWrapper, true> algo(wrapper);
+        algo.run();
 
-            return algorithm + "," + instance + "," + epsilonPrecise + "," +
-                   std::to_string(graph.graph.numVertices()) + "," +
-                   std::to_string(graph.graph.numEdges()) + "," +
-                   std::to_string(numBreakpoints) + "," + std::to_string(runtime) + "," +
-                   std::to_string(algo.getUpdateTime()) + "," + std::to_string(algo.getFlowTime()) + "\n";
-        } else {
-            throw std::runtime_error("No valid mode was selected");
+        for (uint i = 1; i < breakpointGetter.getBreakpoints().size(); i++) {
+            wrapper.setAlpha(breakpointGetter.getBreakpoints()[i]);
+            algo.continueAfterUpdate();
         }
+
+        runtime = timer.elapsedMicroseconds();
+
+        return algorithm + "," + instance + "," + epsilonPrecise + "," +
+               std::to_string(graph.graph.numVertices()) + "," +
+               std::to_string(graph.graph.numEdges()) + "," +
+               std::to_string(numBreakpoints) + "," + std::to_string(runtime) + "," +
+               std::to_string(algo.getUpdateTime()) + "," + std::to_string(algo.getFlowTime()) + "\n";
     }
     else {
         throw std::runtime_error("No valid algorithm was selected");
     }
+}
+
+/**
+ * Runs all experiments of a run list and appends one CSV line per run, with a header if the output file is new.
+ * Every line of the run list has the form "<instance> <algorithm> <epsilon> [<numThreads>]"; empty lines and lines
+ * starting with '#' are ignored. Every instance is loaded only once, all runs on it are then executed numWarmUps times
+ * without measurement and numRepetitions times with measurement. Times are given in microseconds.
+ * @param runListFileName the run list
+ * @param outputFileName the CSV file to which the results are appended
+ * @param numRepetitions the number of measured runs per experiment, at least 1
+ * @param numWarmUps the number of unmeasured runs per experiment
+ */
+void runBatch(const std::string& runListFileName, const std::string& outputFileName, size_t numRepetitions, size_t numWarmUps) {
+    struct Run {
+        std::string algorithm;
+        double epsilon;
+        size_t numThreads;
+    };
+    std::vector<std::string> instances;
+    std::map<std::string, std::vector<Run>> runsOfInstance;
+
+    std::ifstream runList(runListFileName);
+    if (!runList.good()) throw std::runtime_error("Cannot open run list " + runListFileName);
+    std::string line;
+    while (std::getline(runList, line)) {
+        line = String::trim(line);
+        if (line.empty() || line[0] == '#') continue;
+        std::stringstream tokens(line);
+        std::string instance;
+        Run run{"", 0, 1};
+        if (!(tokens >> instance >> run.algorithm >> run.epsilon)) {
+            throw std::runtime_error("Invalid line in run list: " + line);
+        }
+        tokens >> run.numThreads;
+        if (!runsOfInstance.contains(instance)) instances.emplace_back(instance);
+        runsOfInstance[instance].emplace_back(run);
+    }
+    runList.close();
+
+    const bool writeHeader = !FileSystem::isFile(outputFileName) || std::ifstream(outputFileName).peek() == EOF;
+    std::ofstream outputFile(outputFileName, std::ios::app);
+    if (writeHeader) {
+        outputFile << "algorithm,instance,epsilon,numThreads,numVertices,numEdges,numBreakpoints,loadTime,repetitions,minTime,medianTime,meanTime,stddevTime\n";
+    }
 
-    return algorithm + "," + instance + "," + epsilonPrecise + "," + std::to_string(graph.graph.numVertices()) + "," +
-           std::to_string(graph.graph.numEdges()) + "," + epsilonPrecise + "," +
-           std::to_string(numBreakpoints) + "," + std::to_string(runtime) + "\n";
+    for (const std::string& instance : instances) {
+        ParametricInstance graph;
+        const double loadTime = loadInstance(instance, graph);
+        for (const Run& run : runsOfInstance[instance]) {
+            uint numBreakpoints = 0;
+            for (size_t i = 0; i < numWarmUps; i++) {
+                runWhole(graph, run.algorithm, run.epsilon, run.numThreads, numBreakpoints);
+            }
+            std::vector<double> runtimes;
+            for (size_t i = 0; i < numRepetitions; i++) {
+                runtimes.emplace_back(runWhole(graph, run.algorithm, run.epsilon, run.numThreads, numBreakpoints));
+            }
+            std::sort(runtimes.begin(), runtimes.end());
+            outputFile << run.algorithm + "," + instance + "," + epsilonToString(run.epsilon) + "," +
+                          std::to_string(run.numThreads) + "," + std::to_string(graph.graph.numVertices()) + "," +
+                          std::to_string(graph.graph.numEdges()) + "," + std::to_string(numBreakpoints) + "," +
+                          std::to_string(loadTime) + "," + std::to_string(numRepetitions) + "," +
+                          std::to_string(runtimes.front()) + "," + std::to_string(Vector::median(runtimes)) + "," +
+                          std::to_string(Vector::mean(runtimes)) + "," +
+                          std::to_string(Vector::standardDeviation(runtimes)) + "\n" << std::flush;
+            std::cout << "finished run " << run.algorithm << " on " << instance << std::endl;
+        }
+    }
 }
 
 /**
@@ -306,19 +618,30 @@ std::string runExperiment(std::string instance, std::string algorithm, std::stri
  * Takes an output file to which the result is appended as an appropriate CSV line with -o
  * Takes an algorithm to be run with -a. Options are [INSERT ALGORITHMS]
  * Takes a mode to be run with -m. Options are 'whole' for measuring time over the whole run and 'specific' for measuring algorithm specific detail
+ * Takes the number of threads used by the chord scheme with -t (default 1)
  * Output of specific results should be appended to a CSV file specific for this, as they have unique formatting
+ * Alternatively, takes a run list with -b (see runBatch), which is executed in batch mode with mode 'whole'.
+ * In batch mode, -r sets the number of measured repetitions (default 5, at least 1) and -w the number of warm-up runs (default 1)
  */
 int main(int argc, char **argv) {
     CommandLineParser parser(argc, argv);
 
+    if (parser.isSet("b")) {
+        const size_t numRepetitions = parser.value<size_t>("r", 5);
+        if (numRepetitions == 0) throw std::runtime_error("The number of repetitions (-r) must be at least 1");
+        runBatch(parser.value<std::string>("b"), parser.value<std::string>("o"), numRepetitions, parser.value<size_t>("w", 1));
+        return 0;
+    }
+
     std::string inputFileName = parser.value<std::string>("i");
     std::string outputFileName = parser.value<std::string>("o");
     std::string algorithm = parser.value<std::string>("a");
     std::string mode = parser.value<std::string>("m");
 
     double epsilon = parser.value<double>("e");
+    size_t numThreads = parser.value<size_t>("t", 1);
 
-    std::string results = runExperiment(inputFileName, algorithm, mode, epsilon);
+    std::string results = runExperiment(inputFileName, algorithm, mode, epsilon, numThreads);
 
     std::ofstream outputFile(outputFileName, std::ios::app);
     outputFile << results;
@@ -3,6 +3,10 @@ from enum import Enum
 
 configStuff = {"instanceSet": {}, "algorithmSet": {}, "modeSet": {}, "epsilonSet": {}}
 
+# Number of measured runs and warm-up runs per experiment in batch mode
+repetitions = 5
+warmUps = 1
+
 runs = []
 
 if __name__ == '__main__':
@@ -78,9 +82,12 @@ if __name__ == '__main__':
 
     runsSoFar = set()
 
-    with open("PMFrunBenchmark.sh", 'w') as shellScript:
+    with open("PMFrunBenchmark.sh", 'w') as shellScript, open("PMFrunBenchmark.runs", 'w') as runList:
         shellScript.write("#!/bin/bash\n\n")
         shellScript.write("mkdir -p ../Data/Output\n\n")
+        shellScript.write(
+            "../build/ParametricMaxFlowBenchmark -b PMFrunBenchmark.runs -o ../Data/Output/parametricRuntimes.csv -r " + str(repetitions) + " -w " + str(warmUps) + "\n")
+        shellScript.write("echo \"finished batch runs of PMFrunBenchmark.runs\"\n")
         for run in runs:
             for instance in run[0]:
                 for algorithm in run[1]:
@@ -89,11 +96,12 @@ if __name__ == '__main__':
                             if (instance, algorithm, mode, epsilon) in runsSoFar:
                                 continue
                             if (mode == "whole"):
-                                shellScript.write(
-                                    "../build/ParametricMaxFlowBenchmark -i ../Data/" + instance + " -o ../Data/Output/parametricRuntimes.csv -a " + algorithm + " -m " + mode + " -e " + epsilon + "\n")
-                            else:
-                                shellScript.write(
-                                    "../build/ParametricMaxFlowBenchmark -i ../Data/" + instance + " -o ../Data/Output/" + algorithm + "_" + mode + ".csv -a " + algorithm + " -m " + mode + " -e " + epsilon + "\n")
+                                # Runs measuring the whole time are executed in batch mode, which loads every instance once
+                                runList.write("../Data/" + instance + " " + algorithm + " " + epsilon + "\n")
+                                runsSoFar.add((instance, algorithm, mode, epsilon))
+                                continue
+                            shellScript.write(
+                                "../build/ParametricMaxFlowBenchmark -i ../Data/" + instance + " -o ../Data/Output/" + algorithm + "_" + mode + ".csv -a " + algorithm + " -m " + mode + " -e " + epsilon + "\n")
                             shellScript.write(
                                 "echo \"finished run -i ../Data/" + instance + " -a " + algorithm + " -m " + mode + " -e " + epsilon + "\"\n")
                             runsSoFar.add((instance, algorithm, mode, epsilon))
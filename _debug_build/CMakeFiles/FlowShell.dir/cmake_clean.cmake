@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/FlowShell.dir/Runnables/FlowShell.cpp.o"
+  "CMakeFiles/FlowShell.dir/Runnables/FlowShell.cpp.o.d"
+  "FlowShell"
+  "FlowShell.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/FlowShell.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/ParametricMaxFlowBenchmark.dir/Runnables/ParametricMaxFlowBenchmark.cpp.o"
+  "CMakeFiles/ParametricMaxFlowBenchmark.dir/Runnables/ParametricMaxFlowBenchmark.cpp.o.d"
+  "ParametricMaxFlowBenchmark"
+  "ParametricMaxFlowBenchmark.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/ParametricMaxFlowBenchmark.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
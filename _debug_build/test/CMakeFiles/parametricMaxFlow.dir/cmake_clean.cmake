@@ -0,0 +1,12 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/parametricMaxFlow.dir/ParametricMaxFlowTest.cpp.o"
+  "CMakeFiles/parametricMaxFlow.dir/ParametricMaxFlowTest.cpp.o.d"
+  "parametricMaxFlow"
+  "parametricMaxFlow.pdb"
+  "parametricMaxFlow[1]_tests.cmake"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/parametricMaxFlow.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
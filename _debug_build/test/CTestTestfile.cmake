@@ -0,0 +1,14 @@
+# CMake generated Testfile for 
+# Source directory: /root/repo/test
+# Build directory: /root/repo/_debug_build/test
+# 
+# This file includes the relevant testing commands required for 
+# testing this directory and lists subdirectories to be tested as well.
+include("/root/repo/_debug_build/test/basic[1]_include.cmake")
+include("/root/repo/_debug_build/test/parametricMaxFlow[1]_include.cmake")
+add_test([=[benchmarkSmoke_parametricIBFS[ParallelInitialFlow]]=] "/root/repo/_debug_build/ParametricMaxFlowBenchmark" "-i" "test/instances/smallTest" "-o" "/root/repo/_debug_build/test/benchmarkSmoke.csv" "-a" "parametricIBFS[ParallelInitialFlow]" "-m" "whole" "-e" "0" "-t" "2")
+set_tests_properties([=[benchmarkSmoke_parametricIBFS[ParallelInitialFlow]]=] PROPERTIES  WORKING_DIRECTORY "/root/repo" _BACKTRACE_TRIPLES "/root/repo/test/CMakeLists.txt;24;add_test;/root/repo/test/CMakeLists.txt;0;")
+add_test([=[benchmarkSmoke_chordScheme[PushRelabelParallelBFS]]=] "/root/repo/_debug_build/ParametricMaxFlowBenchmark" "-i" "test/instances/smallTest" "-o" "/root/repo/_debug_build/test/benchmarkSmoke.csv" "-a" "chordScheme[PushRelabelParallelBFS]" "-m" "whole" "-e" "0" "-t" "2")
+set_tests_properties([=[benchmarkSmoke_chordScheme[PushRelabelParallelBFS]]=] PROPERTIES  WORKING_DIRECTORY "/root/repo" _BACKTRACE_TRIPLES "/root/repo/test/CMakeLists.txt;24;add_test;/root/repo/test/CMakeLists.txt;0;")
+add_test([=[benchmarkSmoke_chordScheme[ParallelPushRelabel]]=] "/root/repo/_debug_build/ParametricMaxFlowBenchmark" "-i" "test/instances/smallTest" "-o" "/root/repo/_debug_build/test/benchmarkSmoke.csv" "-a" "chordScheme[ParallelPushRelabel]" "-m" "whole" "-e" "0" "-t" "2")
+set_tests_properties([=[benchmarkSmoke_chordScheme[ParallelPushRelabel]]=] PROPERTIES  WORKING_DIRECTORY "/root/repo" _BACKTRACE_TRIPLES "/root/repo/test/CMakeLists.txt;24;add_test;/root/repo/test/CMakeLists.txt;0;")
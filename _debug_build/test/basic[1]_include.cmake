@@ -0,0 +1,5 @@
+if(EXISTS "/root/repo/_debug_build/test/basic[1]_tests.cmake")
+  include("/root/repo/_debug_build/test/basic[1]_tests.cmake")
+else()
+  add_test(basic_NOT_BUILT basic_NOT_BUILT)
+endif()
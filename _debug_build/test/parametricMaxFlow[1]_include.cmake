@@ -0,0 +1,5 @@
+if(EXISTS "/root/repo/_debug_build/test/parametricMaxFlow[1]_tests.cmake")
+  include("/root/repo/_debug_build/test/parametricMaxFlow[1]_tests.cmake")
+else()
+  add_test(parametricMaxFlow_NOT_BUILT parametricMaxFlow_NOT_BUILT)
+endif()
@@ -0,0 +1,245 @@
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include "../Algorithms/MaxFlowMinCut/ParametricIBFS.h"
+
+#include "../DataStructures/MaxFlowMinCut/InstanceGenerator.h"
+
+using FlowGraph = ParametricFlowGraph<pmf::linearFlowFunction>;
+using ParametricInstance = ParametricMaxFlowInstance<pmf::linearFlowFunction>;
+
+/**
+ * Microbenchmarks for the hot kernels of the parametric max-flow solvers.
+ * The instances are generated, so the suite runs without any instance files. Sizes are given as benchmark arguments.
+ */
+
+// The alpha queue of ParametricIBFS, with a full queue and monotone keys as in ParametricIBFS::run(): every iteration
+// moves the front to a later alpha and reschedules a random other element behind the front.
+template<typename ALPHA_QUEUE>
+static void BM_AlphaQueue(benchmark::State& state) {
+    using Label = typename ALPHA_QUEUE::Label;
+    const size_t n = state.range(0);
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<double> disAlpha(0.0, 1.0);
+    std::uniform_int_distribution<size_t> disLabel(0, n - 1);
+
+    std::vector<Label> labels(n);
+    typename ALPHA_QUEUE::Queue queue(n);
+    for (Label& label : labels) {
+        label.value_ = disAlpha(rng);
+        queue.push(label);
+    }
+    for (auto _ : state) {
+        Label* front = queue.front();
+        const double alpha = front->value_;
+        front->value_ = alpha + disAlpha(rng);
+        queue.push(front);
+        Label& label = labels[disLabel(rng)];
+        queue.remove(&label);
+        label.value_ = alpha + disAlpha(rng);
+        queue.push(label);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK_TEMPLATE(BM_AlphaQueue, KHeapAlphaQueue)->RangeMultiplier(8)->Range(1 << 10, 1 << 20);
+BENCHMARK_TEMPLATE(BM_AlphaQueue, RadixHeapAlphaQueue)->RangeMultiplier(8)->Range(1 << 10, 1 << 20);
+
+// Drains a full queue in key order.
+template<typename ALPHA_QUEUE>
+static void BM_AlphaQueueExtract(benchmark::State& state) {
+    using Label = typename ALPHA_QUEUE::Label;
+    const size_t n = state.range(0);
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<double> disAlpha(0.0, 1.0);
+
+    std::vector<Label> labels(n);
+    for (auto _ : state) {
+        state.PauseTiming();
+        typename ALPHA_QUEUE::Queue queue(n);
+        for (Label& label : labels) {
+            label.value_ = disAlpha(rng);
+            queue.push(label);
+        }
+        state.ResumeTiming();
+        while (!queue.empty()) {
+            benchmark::DoNotOptimize(queue.extractFront());
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK_TEMPLATE(BM_AlphaQueueExtract, KHeapAlphaQueue)->RangeMultiplier(8)->Range(1 << 10, 1 << 20);
+BENCHMARK_TEMPLATE(BM_AlphaQueueExtract, RadixHeapAlphaQueue)->RangeMultiplier(8)->Range(1 << 10, 1 << 20);
+
+// Fills the excess buckets, raises the distance of every other vertex and drains them level by level.
+static void BM_ExcessBuckets(benchmark::State& state) {
+    const size_t n = state.range(0);
+    const int numLevels = state.range(1);
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<int> disDist(0, numLevels - 2);
+    std::vector<int> dist(n);
+    for (int& d : dist) d = disDist(rng);
+
+    std::vector<Vertex> level;
+    for (auto _ : state) {
+        ExcessBuckets buckets(n);
+        for (size_t v = 0; v < n; v++) {
+            buckets.addVertex(Vertex(v), dist[v]);
+        }
+        for (size_t v = 0; v < n; v += 2) {
+            buckets.increaseBucket(Vertex(v), dist[v], dist[v] + 1);
+        }
+        while (!buckets.empty()) {
+            buckets.popLevel(level);
+            benchmark::DoNotOptimize(level.data());
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK(BM_ExcessBuckets)->ArgsProduct({benchmark::CreateRange(1 << 10, 1 << 20, 8), {16, 1024}});
+
+// Fills the orphan buckets, lowers the distance of every other vertex and pops them in increasing distance order.
+static void BM_OrphanBuckets(benchmark::State& state) {
+    const size_t n = state.range(0);
+    const int numLevels = state.range(1);
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<int> disDist(1, numLevels - 1);
+    std::vector<int> dist(n);
+    for (int& d : dist) d = disDist(rng);
+
+    for (auto _ : state) {
+        OrphanBuckets buckets(n);
+        for (size_t v = 0; v < n; v++) {
+            buckets.addVertex(Vertex(v), dist[v]);
+        }
+        for (size_t v = 0; v < n; v += 2) {
+            buckets.decreaseBucket(Vertex(v), dist[v], dist[v] - 1);
+        }
+        while (!buckets.empty()) {
+            benchmark::DoNotOptimize(buckets.pop());
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK(BM_OrphanBuckets)->ArgsProduct({benchmark::CreateRange(1 << 10, 1 << 20, 8), {16, 1024}});
+
+// The edge scan of ParametricIBFS::adoptWithNewDist: for every vertex, find the residual out-edge whose head has the
+// minimum distance.
+static void BM_AdoptScan(benchmark::State& state) {
+    const pmf::InstanceGenerator::Parameters parameters;
+    const ParametricInstance instance = pmf::InstanceGenerator::geometric(parameters, state.range(0), 6);
+    const FlowGraph& graph = instance.graph;
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<uint> disDist(0, 64);
+    std::vector<uint> dist(graph.numVertices());
+    for (uint& d : dist) d = disDist(rng);
+    std::vector<double> residualCapacity(graph.numEdges());
+    for (const Edge e : graph.edges()) {
+        residualCapacity[e] = graph.get(Capacity, e).eval(0.5);
+    }
+
+    for (auto _ : state) {
+        for (const Vertex v : graph.vertices()) {
+            uint d_min = INFTY;
+            Edge e_min = noEdge;
+            for (const Edge e : graph.edgesFrom(v)) {
+                if (!pmf::doubleIsPositive(residualCapacity[e])) continue;
+                const Vertex to = graph.get(ToVertex, e);
+                if (dist[to] < d_min) {
+                    e_min = e;
+                    d_min = dist[to];
+                }
+            }
+            benchmark::DoNotOptimize(e_min);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * graph.numEdges());
+}
+BENCHMARK(BM_AdoptScan)->RangeMultiplier(8)->Range(1 << 10, 1 << 20);
+
+// Sums and differences of flow functions, as done when computing residual capacities.
+static void BM_LinearFlowFunctionArithmetic(benchmark::State& state) {
+    const size_t n = state.range(0);
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<double> disR(-20.0, 20.0);
+    std::vector<pmf::linearFlowFunction> functions;
+    for (size_t i = 0; i < n; i++) {
+        functions.emplace_back(disR(rng), disR(rng));
+    }
+
+    for (auto _ : state) {
+        pmf::linearFlowFunction sum(0);
+        for (size_t i = 1; i < n; i++) {
+            sum += functions[i] - functions[i - 1];
+        }
+        benchmark::DoNotOptimize(sum);
+        benchmark::DoNotOptimize(sum.eval(0.5));
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK(BM_LinearFlowFunctionArithmetic)->Arg(1 << 16);
+
+// Evaluation and zero crossings of flow functions, as done when computing the next breakpoint of an edge.
+static void BM_LinearFlowFunctionZeroCrossing(benchmark::State& state) {
+    const size_t n = state.range(0);
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<double> disR(-20.0, 20.0);
+    std::vector<pmf::linearFlowFunction> functions;
+    for (size_t i = 0; i < n; i++) {
+        functions.emplace_back(disR(rng), disR(rng));
+    }
+
+    for (auto _ : state) {
+        double next = INFTY;
+        for (const pmf::linearFlowFunction& function : functions) {
+            if (function.eval(0.25) > 0) next = std::min(next, function.getNextZeroCrossing(0.25));
+        }
+        benchmark::DoNotOptimize(next);
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK(BM_LinearFlowFunctionZeroCrossing)->Arg(1 << 16);
+
+// Full run of ParametricIBFS on square grids with n pixels.
+template<typename ALPHA_QUEUE>
+static void BM_ParametricIBFS(benchmark::State& state) {
+    const pmf::InstanceGenerator::Parameters parameters;
+    const size_t width = std::sqrt(state.range(0));
+    const ParametricInstance instance = pmf::InstanceGenerator::grid(parameters, width, width);
+    size_t numBreakpoints = 0;
+    for (auto _ : state) {
+        ParametricIBFS<pmf::linearFlowFunction, false, ALPHA_QUEUE> algorithm(instance);
+        algorithm.run();
+        numBreakpoints = algorithm.getBreakpoints().size();
+    }
+    state.counters["vertices"] = instance.graph.numVertices();
+    state.counters["edges"] = instance.graph.numEdges();
+    state.counters["breakpoints"] = numBreakpoints;
+}
+BENCHMARK_TEMPLATE(BM_ParametricIBFS, KHeapAlphaQueue)->RangeMultiplier(4)->Range(1 << 10, 1 << 16)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_ParametricIBFS, RadixHeapAlphaQueue)->RangeMultiplier(4)->Range(1 << 10, 1 << 16)->Unit(benchmark::kMillisecond);
+
+// Full run of ParametricIBFS on generated instances with many bottlenecks per breakpoint.
+template<typename ALPHA_QUEUE>
+static void BM_ParametricIBFSGenerated(benchmark::State& state) {
+    const pmf::InstanceGenerator::Parameters parameters;
+    const size_t n = state.range(1);
+    const ParametricInstance instance = (state.range(0) == 0) ? pmf::InstanceGenerator::geometric(parameters, n, 8) : pmf::InstanceGenerator::densestSubgraph(parameters, n, 5 * n);
+    size_t numBreakpoints = 0;
+    for (auto _ : state) {
+        ParametricIBFS<pmf::linearFlowFunction, false, ALPHA_QUEUE> algorithm(instance);
+        algorithm.run();
+        numBreakpoints = algorithm.getBreakpoints().size();
+    }
+    state.SetLabel((state.range(0) == 0) ? "geometric" : "densestSubgraph");
+    state.counters["vertices"] = instance.graph.numVertices();
+    state.counters["edges"] = instance.graph.numEdges();
+    state.counters["breakpoints"] = numBreakpoints;
+}
+BENCHMARK_TEMPLATE(BM_ParametricIBFSGenerated, KHeapAlphaQueue)->ArgsProduct({{0, 1}, {1 << 12, 1 << 14}})->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_ParametricIBFSGenerated, RadixHeapAlphaQueue)->ArgsProduct({{0, 1}, {1 << 12, 1 << 14}})->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
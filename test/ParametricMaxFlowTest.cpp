@@ -1,16 +1,26 @@
 #include <gtest/gtest.h>
 
-#include <random>
+#include <algorithm>
+#include <filesystem>
 #include <fstream>
+#include <random>
+#include <span>
 
 #include "../Helpers/Console/Progress.h"
 
 #include "../Algorithms/MaxFlowMinCut/ExcessesIBFS.h"
 #include "../Algorithms/MaxFlowMinCut/IBFS.h"
+#include "../Algorithms/MaxFlowMinCut/ParallelPushRelabel.h"
 #include "../Algorithms/MaxFlowMinCut/ParametricIBFS.h"
+#include "../Algorithms/MaxFlowMinCut/ParametricPseudoflow.h"
+#include "../Algorithms/MaxFlowMinCut/DivideAndConquerPushRelabel.h"
+#include "../Algorithms/MaxFlowMinCut/Pseudoflow.h"
 #include "../Algorithms/MaxFlowMinCut/PushRelabel.h"
 #include "../Algorithms/MaxFlowMinCut/RestartableIBFS.h"
 #include "../Algorithms/MaxFlowMinCut/ChordScheme.h"
+#include "../Algorithms/MaxFlowMinCut/DecomposedParametricIBFS.h"
+
+#include "../DataStructures/MaxFlowMinCut/InstanceGenerator.h"
 
 using FlowEdgeList = ParametricFlowGraphEdgeList<pmf::linearFlowFunction>;
 using FlowGraph = ParametricFlowGraph<pmf::linearFlowFunction>;
@@ -104,8 +114,11 @@ inline void validateStaticAlgorithms(const ParametricInstance& instance, const s
         eibfs.run();
         PushRelabel<ParametricWrapper> prf(wrapper);
         prf.run();
+        Pseudoflow<ParametricWrapper> pseudoflow(wrapper);
+        pseudoflow.run();
         compareAlgorithmResults(ibfs, eibfs);
         compareAlgorithmResults(ibfs,prf);
+        compareAlgorithmResults(ibfs, pseudoflow);
     }
 }
 
@@ -130,15 +143,22 @@ inline void validateRestartableAlgorithms(const ParametricInstance& instance, co
     }
 }
 
+// Parametric algorithms return their sink components ordered by breakpoint, static ones ordered by id.
+inline std::vector<Vertex> sortedSinkComponent(const std::span<const Vertex> sinkComponent) noexcept {
+    std::vector<Vertex> result(sinkComponent.begin(), sinkComponent.end());
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
 template<typename PARAMETRIC_ALGO, typename STATIC_ALGO>
 inline void compareParametricAlgorithmResults(const PARAMETRIC_ALGO& parametricAlgo, const STATIC_ALGO& staticAlgo, const double alpha, const double tolerance) noexcept {
     EXPECT_NEAR(parametricAlgo.getFlowValue(alpha), staticAlgo.getFlowValue(), tolerance);
-    EXPECT_EQ(parametricAlgo.getSinkComponent(alpha), staticAlgo.getSinkComponent());
+    EXPECT_EQ(sortedSinkComponent(parametricAlgo.getSinkComponent(alpha)), staticAlgo.getSinkComponent());
 }
 
-template<typename STATIC_ALGO, typename RESTARTABLE_ALGO>
+template<typename STATIC_ALGO, typename RESTARTABLE_ALGO, typename PARAMETRIC_ALGO = ParametricIBFS<pmf::linearFlowFunction>>
 inline void validateParametricIBFS(const ParametricInstance& instance, const double tolerance) {
-    ParametricIBFS<pmf::linearFlowFunction> algo(instance);
+    PARAMETRIC_ALGO algo(instance);
     algo.run();
     ParametricWrapper wrapper(instance);
     RESTARTABLE_ALGO restartableAlgo(wrapper);
@@ -162,6 +182,23 @@ inline void validateParametricIBFS(const ParametricInstance& instance, const dou
     progress.finished();
 }
 
+template<typename PARAMETRIC_ALGO, typename... ARGS>
+inline void compareVertexBreakpoints(const ParametricInstance& instance, const double tolerance, const ARGS... args) {
+    ParametricIBFS<pmf::linearFlowFunction> reference(instance);
+    reference.run();
+    PARAMETRIC_ALGO algo(instance, args...);
+    algo.run();
+    const auto& referenceBreakpoints = reference.getVertexBreakpoints();
+    const auto& algoBreakpoints = algo.getVertexBreakpoints();
+    ASSERT_EQ(referenceBreakpoints.size(), algoBreakpoints.size());
+    for (size_t v = 0; v < referenceBreakpoints.size(); v++) {
+        EXPECT_NEAR(referenceBreakpoints[v], algoBreakpoints[v], tolerance);
+    }
+    for (const double breakpoint : reference.getBreakpoints()) {
+        EXPECT_NEAR(reference.getFlowValue(breakpoint), algo.getFlowValue(breakpoint), tolerance);
+    }
+}
+
 template<typename RESTARTABLE_ALGO>
 inline void validateParametricIBFSFast(const ParametricInstance& instance, const double tolerance) {
     ParametricIBFS<pmf::linearFlowFunction> algo(instance);
@@ -184,11 +221,11 @@ inline void validateParametricIBFSFast(const ParametricInstance& instance, const
     progress.finished();
 }
 
-template<typename STATIC_ALGO>
-inline void validateChordScheme(const ParametricInstance& instance, const double precision, const double tolerance) {
-    using SearchAlgorithm = IBFS<ChordSchemeMaxFlowWrapper<pmf::linearFlowFunction>>;
+template<typename STATIC_ALGO, typename SEARCH_ALGO = IBFS<ChordSchemeMaxFlowWrapper<pmf::linearFlowFunction>>>
+inline void validateChordScheme(const ParametricInstance& instance, const double precision, const double tolerance, const size_t numThreads = 1) {
+    using SearchAlgorithm = SEARCH_ALGO;
     using Chord = ChordScheme<pmf::linearFlowFunction, SearchAlgorithm>;
-    Chord algo(instance, precision);
+    Chord algo(instance, precision, numThreads);
     algo.run();
     ParametricWrapper wrapper(instance);
 
@@ -199,7 +236,7 @@ inline void validateChordScheme(const ParametricInstance& instance, const double
         STATIC_ALGO staticAlgo(wrapper);
         staticAlgo.run();
         EXPECT_NEAR(algo.getFlowValue(breakpoint), staticAlgo.getFlowValue(), tolerance);
-        EXPECT_EQ(algo.getSinkComponent(breakpoint), staticAlgo.getSinkComponent());
+        EXPECT_EQ(sortedSinkComponent(algo.getSinkComponent(breakpoint)), staticAlgo.getSinkComponent());
         progress++;
     }
     progress.finished();
@@ -243,6 +280,46 @@ inline void compareParametricAlgorithms(const ParametricInstance& instance, cons
     }
 }
 
+TEST(parametricMaxFlow, instanceFileRoundTrip) {
+    const ParametricInstance instance = createRandomParametricInstance(1000);
+    const std::string fileName = testing::TempDir() + "parametricMaxFlowInstance";
+    instance.serialize(fileName);
+    const ParametricInstance loaded(fileName);
+    std::remove(fileName.c_str());
+    EXPECT_EQ(loaded.source, instance.source);
+    EXPECT_EQ(loaded.sink, instance.sink);
+    EXPECT_EQ(loaded.alphaMin, instance.alphaMin);
+    EXPECT_EQ(loaded.alphaMax, instance.alphaMax);
+    ASSERT_EQ(loaded.graph.numVertices(), instance.graph.numVertices());
+    ASSERT_EQ(loaded.graph.numEdges(), instance.graph.numEdges());
+    for (const Vertex vertex : instance.graph.vertices()) {
+        EXPECT_EQ(loaded.graph.beginEdgeFrom(vertex), instance.graph.beginEdgeFrom(vertex));
+    }
+    EXPECT_EQ(loaded.graph[ToVertex], instance.graph[ToVertex]);
+    EXPECT_EQ(loaded.graph[ReverseEdge], instance.graph[ReverseEdge]);
+    EXPECT_EQ(loaded.graph[Capacity], instance.graph[Capacity]);
+}
+
+TEST(parametricMaxFlow, instanceFileCorrupt) {
+    const ParametricInstance instance = createRandomParametricInstance(1000);
+    const std::string fileName = testing::TempDir() + "parametricMaxFlowCorruptInstance";
+    instance.serialize(fileName);
+    const uintmax_t fileSize = std::filesystem::file_size(fileName);
+    std::filesystem::resize_file(fileName, fileSize / 2);
+    EXPECT_EXIT(ParametricInstance loaded(fileName), testing::ExitedWithCode(1), "");
+
+    instance.serialize(fileName);
+    pmf::InstanceFile::Header header;
+    std::fstream file(fileName, std::ios::binary | std::ios::in | std::ios::out);
+    file.read(reinterpret_cast<char*>(&header), sizeof(header));
+    const Edge invalidBegin = Edge(instance.graph.numEdges() + 1);
+    file.seekp(header.beginOutOffset + sizeof(Edge));
+    file.write(reinterpret_cast<const char*>(&invalidBegin), sizeof(Edge));
+    file.close();
+    EXPECT_EXIT(ParametricInstance loaded(fileName), testing::ExitedWithCode(1), "");
+    std::remove(fileName.c_str());
+}
+
 TEST(parametricMaxFlow, randomStatic) {
     const ParametricInstance instance = createRandomParametricInstance(1000);
     validateStaticAlgorithms(instance, 100);
@@ -253,6 +330,39 @@ TEST(parametricMaxFlow, randomRestartable) {
     validateRestartableAlgorithms(instance, 100);
 }
 
+TEST(parametricMaxFlow, randomStaticParallelPushRelabel) {
+    const ParametricInstance instance = createRandomParametricInstance(1000);
+    ParametricWrapper wrapper(instance);
+    for (size_t i = 0; i <= 100; i++) {
+        wrapper.setAlpha(instance.alphaMin + static_cast<double>(i) * (instance.alphaMax - instance.alphaMin)/100);
+        IBFS<ParametricWrapper> ibfs(wrapper);
+        ibfs.run();
+        ParallelPushRelabel<ParametricWrapper> parallel(wrapper, 2);
+        parallel.run();
+        compareAlgorithmResults(ibfs, parallel);
+    }
+}
+
+TEST(parametricMaxFlow, randomPushRelabelParallelBFS) {
+    const ParametricInstance instance = createRandomParametricInstance(1000);
+    ParametricWrapper wrapper(instance);
+    PushRelabel<ParametricWrapper, false, true> restartable(wrapper, 2);
+    for (size_t i = 0; i <= 100; i++) {
+        wrapper.setAlpha(instance.alphaMin + static_cast<double>(i) * (instance.alphaMax - instance.alphaMin)/100);
+        PushRelabel<ParametricWrapper> sequential(wrapper);
+        sequential.run();
+        PushRelabel<ParametricWrapper, false, true> parallel(wrapper, 2);
+        parallel.run();
+        if (i == 0) {
+            restartable.run();
+        } else {
+            restartable.continueAfterUpdate();
+        }
+        compareAlgorithmResults(sequential, parallel);
+        compareAlgorithmResults(sequential, restartable);
+    }
+}
+
 TEST(parametricMaxFlow, randomParametricIBFSPushRelabel) {
     const ParametricInstance instance = createRandomParametricInstance(1000);
     validateParametricIBFS<PushRelabel<ParametricWrapper>, PushRelabel<ParametricWrapper>>(instance, pmf::epsilon);
@@ -263,6 +373,115 @@ TEST(parametricMaxFlow, randomParametricIBFSRestartableIBFS) {
     validateParametricIBFS<IBFS<ParametricWrapper>, RestartableIBFS<ParametricWrapper>>(instance, pmf::epsilon);
 }
 
+TEST(parametricMaxFlow, randomParametricIBFSRadixHeap) {
+    const ParametricInstance instance = createRandomParametricInstance(1000);
+    validateParametricIBFS<PushRelabel<ParametricWrapper>, PushRelabel<ParametricWrapper>, ParametricIBFS<pmf::linearFlowFunction, false, RadixHeapAlphaQueue>>(instance, pmf::epsilon);
+}
+
+TEST(parametricMaxFlow, randomChord) {
+    const ParametricInstance instance = createRandomParametricInstance(1000);
+    validateChordScheme<PushRelabel<ParametricWrapper>>(instance, 1e-16, pmf::epsilon);
+}
+
+TEST(parametricMaxFlow, randomChordParallel) {
+    const ParametricInstance instance = createRandomParametricInstance(10000);
+    validateChordScheme<PushRelabel<ParametricWrapper>>(instance, 1e-16, pmf::epsilon, 4);
+}
+
+TEST(parametricMaxFlow, generatedInstances) {
+    const pmf::InstanceGenerator::Parameters parameters;
+    const std::vector<ParametricInstance> instances = {
+        pmf::InstanceGenerator::grid(parameters, 20, 15, 3),
+        pmf::InstanceGenerator::geometric(parameters, 1000, 8),
+        pmf::InstanceGenerator::projectSelection(parameters, 400, 100, 4),
+        pmf::InstanceGenerator::densestSubgraph(parameters, 200, 1000),
+    };
+    for (const ParametricInstance& instance : instances) {
+        validateParametricIBFS<PushRelabel<ParametricWrapper>, PushRelabel<ParametricWrapper>>(instance, pmf::epsilon);
+    }
+
+    const ParametricInstance again = pmf::InstanceGenerator::geometric(parameters, 1000, 8);
+    EXPECT_EQ(again.graph[ToVertex], instances[1].graph[ToVertex]);
+    EXPECT_EQ(again.graph[ReverseEdge], instances[1].graph[ReverseEdge]);
+    EXPECT_EQ(again.graph[Capacity], instances[1].graph[Capacity]);
+}
+
+TEST(parametricMaxFlow, generatedParametricIBFSGlobalRelabel) {
+    using GlobalRelabelIBFS = ParametricIBFS<pmf::linearFlowFunction, false, KHeapAlphaQueue, true>;
+    const pmf::InstanceGenerator::Parameters parameters;
+    validateParametricIBFS<PushRelabel<ParametricWrapper>, PushRelabel<ParametricWrapper>, GlobalRelabelIBFS>(pmf::InstanceGenerator::grid(parameters, 40, 40, 1), pmf::epsilon);
+    validateParametricIBFS<PushRelabel<ParametricWrapper>, PushRelabel<ParametricWrapper>, GlobalRelabelIBFS>(createRandomParametricInstance(1000), pmf::epsilon);
+}
+
+TEST(parametricMaxFlow, generatedParametricIBFSDynamicTrees) {
+    using DynamicTreesIBFS = ParametricIBFS<pmf::linearFlowFunction, false, KHeapAlphaQueue, false, true>;
+    const pmf::InstanceGenerator::Parameters parameters;
+    validateParametricIBFS<PushRelabel<ParametricWrapper>, PushRelabel<ParametricWrapper>, DynamicTreesIBFS>(pmf::InstanceGenerator::grid(parameters, 40, 40, 1), pmf::epsilon);
+    validateParametricIBFS<PushRelabel<ParametricWrapper>, PushRelabel<ParametricWrapper>, DynamicTreesIBFS>(createRandomParametricInstance(1000), pmf::epsilon);
+}
+
+TEST(parametricMaxFlow, generatedParallelPushRelabel) {
+    using ParallelInitialFlowIBFS = ParametricIBFS<pmf::linearFlowFunction, false, KHeapAlphaQueue, false, false, ParallelPushRelabel<ParametricWrapper>>;
+    using ParallelSearch = ParallelPushRelabel<ChordSchemeMaxFlowWrapper<pmf::linearFlowFunction>>;
+    const pmf::InstanceGenerator::Parameters parameters;
+    const ParametricInstance grid = pmf::InstanceGenerator::grid(parameters, 40, 40, 1);
+    const ParametricInstance random = createRandomParametricInstance(1000);
+    validateParametricIBFS<PushRelabel<ParametricWrapper>, PushRelabel<ParametricWrapper>, ParallelInitialFlowIBFS>(grid, pmf::epsilon);
+    validateParametricIBFS<PushRelabel<ParametricWrapper>, PushRelabel<ParametricWrapper>, ParallelInitialFlowIBFS>(random, pmf::epsilon);
+    validateChordScheme<PushRelabel<ParametricWrapper>, ParallelSearch>(grid, 1e-16, pmf::epsilon);
+    validateChordScheme<PushRelabel<ParametricWrapper>, ParallelSearch>(random, 1e-16, pmf::epsilon);
+}
+
+TEST(parametricMaxFlow, generatedParametricIBFSMergeTolerance) {
+    const pmf::InstanceGenerator::Parameters parameters;
+    const ParametricInstance instances[] = {pmf::InstanceGenerator::grid(parameters, 40, 40, 1), createRandomParametricInstance(1000)};
+    for (const ParametricInstance& instance : instances) {
+        compareVertexBreakpoints<ParametricIBFS<pmf::linearFlowFunction>>(instance, 1e-6, 1e-9);
+    }
+}
+
+TEST(parametricMaxFlow, generatedParametricIBFSParallelDrain) {
+    const pmf::InstanceGenerator::Parameters parameters;
+    const ParametricInstance instances[] = {pmf::InstanceGenerator::grid(parameters, 400, 20, 1), pmf::InstanceGenerator::geometric(parameters, 5000, 2.0), createRandomParametricInstance(1000)};
+    for (const ParametricInstance& instance : instances) {
+        compareVertexBreakpoints<ParametricIBFS<pmf::linearFlowFunction>>(instance, 1e-6, 0.0, size_t(4));
+    }
+}
+
+TEST(parametricMaxFlow, generatedDecomposedParametricIBFS) {
+    const pmf::InstanceGenerator::Parameters parameters;
+    const ParametricInstance instances[] = {pmf::InstanceGenerator::grid(parameters, 40, 40, 1), pmf::InstanceGenerator::geometric(parameters, 5000, 2.0), createRandomParametricInstance(1000)};
+    for (const ParametricInstance& instance : instances) {
+        compareVertexBreakpoints<DecomposedParametricIBFS<pmf::linearFlowFunction>>(instance, 1e-6, 2);
+    }
+}
+
+TEST(parametricMaxFlow, generatedPseudoflow) {
+    using PseudoflowSearch = Pseudoflow<ChordSchemeMaxFlowWrapper<pmf::linearFlowFunction>>;
+    const pmf::InstanceGenerator::Parameters parameters;
+    const ParametricInstance instances[] = {pmf::InstanceGenerator::grid(parameters, 40, 40, 1), createRandomParametricInstance(1000)};
+    for (const ParametricInstance& instance : instances) {
+        validateParametricIBFS<PushRelabel<ParametricWrapper>, PushRelabel<ParametricWrapper>, ParametricPseudoflow<pmf::linearFlowFunction>>(instance, pmf::epsilon);
+        validateChordScheme<PushRelabel<ParametricWrapper>, PseudoflowSearch>(instance, 1e-16, pmf::epsilon);
+        compareVertexBreakpoints<ParametricPseudoflow<pmf::linearFlowFunction>>(instance, 1e-6);
+    }
+}
+
+TEST(parametricMaxFlow, smallTestDivideAndConquerPushRelabel) {
+    ParametricInstance instance;
+    instance.fromDimacs("../../test/instances/smallTest");
+    compareVertexBreakpoints<DivideAndConquerPushRelabel<pmf::linearFlowFunction>>(instance, pmf::epsilon);
+}
+
+TEST(parametricMaxFlow, generatedDivideAndConquerPushRelabel) {
+    const pmf::InstanceGenerator::Parameters parameters;
+    const ParametricInstance instances[] = {pmf::InstanceGenerator::grid(parameters, 40, 40, 1), pmf::InstanceGenerator::geometric(parameters, 1000, 8), createRandomParametricInstance(1000)};
+    for (const ParametricInstance& instance : instances) {
+        validateParametricIBFS<PushRelabel<ParametricWrapper>, PushRelabel<ParametricWrapper>, DivideAndConquerPushRelabel<pmf::linearFlowFunction>>(instance, pmf::epsilon);
+        compareVertexBreakpoints<DivideAndConquerPushRelabel<pmf::linearFlowFunction>>(instance, 1e-6);
+    }
+}
+
 TEST(parametricMaxFlow, ahremParametricIBFS) {
     const ParametricInstance instance("../../test/instances/ahrem");
     validateParametricIBFS<PushRelabel<ParametricWrapper>, PushRelabel<ParametricWrapper>>(instance, 1e-4);